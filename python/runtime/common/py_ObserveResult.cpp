@@ -83,6 +83,7 @@ void bindObserveResult(py::module &mod) {
         return f;
       }))
       .def("get", &async_observe_result::get,
+           py::call_guard<py::gil_scoped_release>(),
            "Return the :class:`ObserveResult` from the asynchronous observe "
            "execution.\n")
       .def("__str__", [](async_observe_result &self) {
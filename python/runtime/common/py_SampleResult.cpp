@@ -6,12 +6,14 @@
  * the terms of the Apache License 2.0 which accompanies this distribution.    *
  *******************************************************************************/
 
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include "py_SampleResult.h"
 
 #include "common/MeasureCounts.h"
 
+#include <cstring>
 #include <sstream>
 
 namespace cudaq {
@@ -176,6 +178,38 @@ void bindMeasureCounts(py::module &mod) {
           py::keep_alive<0, 1>(),
           "Return all values (the counts) in this :class:`SampleResult` "
           "dictionary.\n")
+      .def(
+          "to_numpy",
+          [](sample_result &self, const std::string &registerName) {
+            // Copy the packed table as is, no bit string is formatted.
+            auto &counts = self.packed_counts(registerName);
+            auto n = static_cast<py::ssize_t>(counts.size());
+            auto nWords = static_cast<py::ssize_t>(counts.wordsPerEntry());
+            auto outcomes =
+                nWords == 1 ? py::array_t<std::uint64_t>(n)
+                            : py::array_t<std::uint64_t>(
+                                  std::vector<py::ssize_t>{n, nWords});
+            py::array_t<std::uint64_t> observed(n);
+            if (n > 0)
+              std::memcpy(outcomes.mutable_data(), counts.bits(0),
+                          n * nWords * sizeof(std::uint64_t));
+            auto observedView = observed.mutable_unchecked<1>();
+            for (py::ssize_t i = 0; i < n; i++)
+              observedView(i) = counts.countAt(i);
+            return py::make_tuple(outcomes, observed);
+          },
+          py::arg("register_name") = GlobalRegisterName,
+          "Return the measurement counts as two NumPy arrays, the outcomes "
+          "and the number of times each was observed.\n"
+          "\nArgs:\n"
+          "  register_name (Optional[str]): The optional measurement register "
+          "name to extract the counts from. Defaults to the '__global__' "
+          "register.\n"
+          "\nReturns:\n"
+          "  Tuple[numpy.ndarray, numpy.ndarray] : The outcomes as unsigned "
+          "64-bit integers, where bit j is character j of the bitstring (the "
+          "array has shape (N, W) if the bitstrings are wider than 64 bits, "
+          "with W words per outcome), and the counts of each outcome.\n")
       .def("clear", &sample_result::clear,
            "Clear out all metadata from `self`.\n");
 }
@@ -15,6 +15,8 @@
 
 #include "common/Logger.h"
 
+#include <memory>
+
 namespace cudaq {
 
 /// @brief Default shots value set to -1
@@ -23,13 +25,6 @@ constexpr int defaultShotsValue = -1;
 /// @brief Default qpu id value set to 0
 constexpr int defaultQpuIdValue = 0;
 
-/// @brief For asynchronous execution, we need to construct OpaqueArguments
-/// outside of the async lambda invocation. If we don't, then we will be
-/// using Python types outside of the current GIL context. Bad things happen
-/// then.
-std::unordered_map<std::size_t, std::unique_ptr<OpaqueArguments>>
-    asyncArgsHolder;
-
 /// @brief Run `cudaq::observe` on the provided kernel and spin operator.
 observe_result pyObserve(kernel_builder<> &kernel, spin_op &spin_operator,
                          py::args args = {}, int shots = defaultShotsValue) {
@@ -41,22 +36,32 @@ observe_result pyObserve(kernel_builder<> &kernel, spin_op &spin_operator,
   // `kernel.num_qubits() >= spin_operator.num_qubits()`
   kernel.jitCode();
   auto name = kernel.name();
+
+  // Map py::args to OpaqueArguments handle, this needs the GIL. The tasks
+  // below share the packed arguments, they only read them.
+  auto argData = std::make_shared<OpaqueArguments>();
+  packArgs(*argData, validatedArgs);
+
+  // The kernel was JIT compiled above, the simulation does not touch any
+  // Python object so let other Python threads run meanwhile.
+  py::gil_scoped_release release;
+
   // Does this platform expose more than 1 QPU
   // If so, let's distribute the work amongst the QPUs
   if (auto nQpus = platform.num_qpus(); nQpus > 1)
     return details::distributeComputations(
         [&](std::size_t i, spin_op &op) {
-          return pyObserveAsync(kernel, op, args, i, shots);
+          return details::runObservationAsync(
+              [&kernel, argData]() mutable {
+                kernel.jitAndInvoke(argData->data());
+              },
+              op, platform, shots, name, i);
         },
         spin_operator, nQpus);
 
   // Launch the observation task
   return details::runObservation(
-             [&]() mutable {
-               OpaqueArguments argData;
-               packArgs(argData, validatedArgs);
-               kernel.jitAndInvoke(argData.data());
-             },
+             [&]() mutable { kernel.jitAndInvoke(argData->data()); },
              spin_operator, platform, shots, name)
       .value();
 }
@@ -70,15 +75,11 @@ async_observe_result pyObserveAsync(kernel_builder<> &kernel,
 
   // Ensure the user input is correct.
   auto validatedArgs = validateInputArguments(kernel, args);
-  std::hash<std::string> hasher;
-
-  // Create a unique integer key that combines the kernel name
-  // and the validated args.
-  std::size_t uniqueHash = hasher(kernel.name()) + hasher(py::str(args));
 
-  // Add the opaque args to the holder and pack the args into it
-  asyncArgsHolder.emplace(uniqueHash, std::make_unique<OpaqueArguments>());
-  packArgs(*asyncArgsHolder.at(uniqueHash).get(), validatedArgs);
+  // The task runs on another thread, without the GIL, so the arguments are
+  // converted to OpaqueArguments here and owned by the task.
+  auto argData = std::make_shared<OpaqueArguments>();
+  packArgs(*argData, validatedArgs);
 
   // TODO: would like to handle errors in the case that
   // `kernel.num_qubits() >= spin_operator.num_qubits()`
@@ -88,11 +89,9 @@ async_observe_result pyObserveAsync(kernel_builder<> &kernel,
   auto &platform = cudaq::get_platform();
 
   // Launch the asynchronous execution.
+  py::gil_scoped_release release;
   return details::runObservationAsync(
-      [&kernel, uniqueHash]() mutable {
-        auto &argData = asyncArgsHolder.at(uniqueHash);
-        kernel.jitAndInvoke(argData->data());
-      },
+      [&kernel, argData]() mutable { kernel.jitAndInvoke(argData->data()); },
       spin_operator, platform, shots, name, qpu_id);
 }
 
@@ -142,6 +141,8 @@ void bindObserve(py::module &mod) {
       py::arg("kernel"), py::arg("spin_operator"), py::kw_only(),
       py::arg("qpu_id") = defaultQpuIdValue,
       py::arg("shots_count") = defaultShotsValue,
+      // The task refers to the kernel and the spin operator until it runs.
+      py::keep_alive<0, 1>(), py::keep_alive<0, 2>(),
       "Compute the expected value of the `spin_operator` with respect to "
       "the `kernel` asynchronously. If the kernel accepts arguments, it will "
       "be evaluated with respect to `kernel(*arguments)`.\n"
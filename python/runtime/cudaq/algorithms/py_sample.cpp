@@ -19,6 +19,8 @@
 #include "common/ExecutionContext.h"
 #include "common/MeasureCounts.h"
 
+#include <memory>
+
 namespace cudaq {
 
 /// @brief Sample the state produced by the provided builder.
@@ -35,6 +37,10 @@ sample_result pySample(kernel_builder<> &builder, py::args args = {},
   // Map py::args to OpaqueArguments handle
   OpaqueArguments argData;
   packArgs(argData, validatedArgs);
+
+  // The kernel was JIT compiled above, the simulation does not touch any
+  // Python object so let other Python threads run meanwhile.
+  py::gil_scoped_release release;
   return details::runSampling(
              [&]() mutable { builder.jitAndInvoke(argData.data()); }, platform,
              kernelName, shots)
@@ -54,12 +60,14 @@ async_sample_result pySampleAsync(kernel_builder<> &builder,
   builder.jitCode();
   auto kernelName = builder.name();
 
+  // The task runs on another thread, without the GIL, so the arguments are
+  // converted to OpaqueArguments here and owned by the task.
+  auto argData = std::make_shared<OpaqueArguments>();
+  packArgs(*argData, validatedArgs);
+
+  py::gil_scoped_release release;
   return details::runSamplingAsync(
-      [&, a = std::move(validatedArgs)]() mutable {
-        OpaqueArguments argData;
-        packArgs(argData, a);
-        builder.jitAndInvoke(argData.data());
-      },
+      [&builder, argData]() mutable { builder.jitAndInvoke(argData->data()); },
       platform, kernelName, shots, qpu_id);
 }
 
@@ -82,6 +90,7 @@ void bindSample(py::module &mod) {
         return f;
       }))
       .def("get", &async_sample_result::get,
+           py::call_guard<py::gil_scoped_release>(),
            "Return the :class:`SampleResult` from the asynchronous sample "
            "execution.\n")
       .def("__str__", [](async_sample_result &res) {
@@ -133,6 +142,8 @@ void bindSample(py::module &mod) {
       },
       py::arg("kernel"), py::kw_only(), py::arg("shots_count") = 1000,
       py::arg("qpu_id") = 0,
+      // The task refers to the kernel until it runs.
+      py::keep_alive<0, 1>(),
       "Asynchronously sample the state of the provided `kernel` at the "
       "specified number of circuit executions (`shots_count`).\n"
       "When targeting a quantum platform "
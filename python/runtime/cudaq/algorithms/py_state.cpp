@@ -16,19 +16,45 @@
 
 namespace cudaq {
 
-/// @brief Extract the state data
-void extractStateData(py::buffer_info &info, complex *data) {
-  if (info.format != py::format_descriptor<complex>::format())
+/// @brief Wrap the buffer data in a cudaq::state without copying it. The
+/// state holds the buffer view, which keeps the exporting object alive.
+state borrowStateData(const py::buffer &b) {
+  // The state may be released by C++ code, take the GIL to drop the view.
+  std::shared_ptr<py::buffer_info> view(
+      new py::buffer_info(b.request()), [](py::buffer_info *v) {
+        py::gil_scoped_acquire gil;
+        delete v;
+      });
+  if (view->format != py::format_descriptor<complex>::format())
     throw std::runtime_error(
         "Incompatible buffer format, must be np.complex128.");
 
-  if (info.ndim > 2)
+  if (view->ndim < 1 || view->ndim > 2)
     throw std::runtime_error("Incompatible buffer shape.");
 
-  std::size_t size = info.shape[0];
-  if (info.shape.size() == 2)
-    size *= info.shape[1];
-  memcpy(data, info.ptr, sizeof(complex) * (size));
+  // The state indexes the data as data[i * n + j].
+  py::ssize_t stride = sizeof(complex);
+  for (auto i = view->ndim; i-- > 0;) {
+    if (view->strides[i] != stride)
+      throw std::runtime_error(
+          "Incompatible buffer layout, must be C-contiguous.");
+    stride *= view->shape[i];
+  }
+
+  std::vector<std::size_t> shape(view->shape.begin(), view->shape.end());
+  auto *data = static_cast<complex *>(view->ptr);
+  return state(State(std::move(shape), data, std::move(view)));
+}
+
+/// @brief Copy the buffer data into a new cudaq::state.
+state copyStateData(const py::buffer &b) {
+  auto borrowed = borrowStateData(b);
+  auto &shape = borrowed.get_shape();
+  std::size_t size = 1;
+  for (auto extent : shape)
+    size *= extent;
+  auto *data = borrowed.get_data();
+  return state(State(shape, std::vector<complex>(data, data + size)));
 }
 
 /// @brief Run `cudaq::get_state` on the provided kernel and spin operator.
@@ -45,23 +71,28 @@ state pyGetState(kernel_builder<> &kernel, py::args args) {
 /// @brief Bind the get_state cudaq function
 void bindPyState(py::module &mod) {
 
-  py::class_<state>(mod, "State",
+  py::class_<state>(mod, "State", py::buffer_protocol(),
                     "A representation of the internal simulation quantum state "
-                    "vector or density matrix.")
-      .def(py::init([](const py::buffer &b) {
-             py::buffer_info info = b.request();
-             std::vector<std::size_t> shape;
-             for (auto s : info.shape)
-               shape.push_back(s);
-             std::size_t size = shape[0];
-             if (shape.size() == 2)
-               size *= shape[1];
-             std::vector<complex> v(size);
-             extractStateData(info, v.data());
-             auto t = std::make_tuple(shape, v);
-             return state(t);
+                    "vector or density matrix. Supports the buffer protocol, "
+                    "`numpy.array(state, copy=False)` views the data without "
+                    "copying it.")
+      .def(py::init([](const py::buffer &b, bool copy) {
+             return copy ? copyStateData(b) : borrowStateData(b);
            }),
-           "Construct the cudaq::state from an existing array of data.")
+           py::arg("data"), py::arg("copy") = true,
+           "Construct the cudaq::state from an existing array of data. The "
+           "state copies the data, unless `copy=False`, in which case it "
+           "refers to the array data and sees its later changes.")
+      .def_buffer([](state &self) {
+        auto &shape = self.get_shape();
+        std::vector<py::ssize_t> extents(shape.begin(), shape.end());
+        std::vector<py::ssize_t> strides(extents.size(), sizeof(complex));
+        if (extents.size() == 2)
+          strides[0] = extents[1] * sizeof(complex);
+        return py::buffer_info(self.get_data(), sizeof(complex),
+                               py::format_descriptor<complex>::format(),
+                               extents.size(), extents, strides);
+      })
       .def(
           "__getitem__", [](state &s, std::size_t idx) { return s[idx]; },
           "Return an element of the state vector.")
@@ -91,20 +122,11 @@ void bindPyState(py::module &mod) {
       .def(
           "overlap",
           [](state &s, py::buffer &other) {
-            py::buffer_info info = other.request();
-            std::vector<std::size_t> shape;
-            for (auto s : info.shape)
-              shape.push_back(s);
-            std::size_t size = shape[0];
-            if (shape.size() == 2)
-              size *= shape[1];
-            std::vector<complex> v(size);
-            extractStateData(info, v.data());
-            auto t = std::make_tuple(shape, v);
-            state ss(t);
+            state ss = borrowStateData(other);
             return s.overlap(ss);
           },
-          "Compute the overlap of this state with the other one.");
+          "Compute the overlap of this state with the array of data, which "
+          "is read in place without copying it.");
 
   mod.def(
       "get_state",
@@ -311,6 +311,10 @@ void bindKernel(py::module &mod) {
             auto validatedArgs = validateInputArguments(self, arguments);
             OpaqueArguments argData;
             packArgs(argData, validatedArgs);
+            // Compile while holding the GIL, which serializes it, then run
+            // the kernel without it.
+            self.jitCode();
+            py::gil_scoped_release release;
             self.jitAndInvoke(argData.data());
           },
           "Just-In-Time (JIT) compile `self` (:class:`Kernel`), and call "
@@ -108,6 +108,13 @@ void bindSpinOperator(py::module &mod) {
            "represented as a double.")
       .def("to_matrix", &spin_op::to_matrix,
            "Return `self` as a :class:`ComplexMatrix`.")
+      .def("to_sparse_matrix", &spin_op::to_sparse_matrix,
+           "Return `self` as a sparse matrix in compressed sparse row format, "
+           "given as a tuple of the nonzero values, their column indices, "
+           "and the row offsets.")
+      .def("apply", &spin_op::apply, py::arg("vector"),
+           "Return the product of `self` with the given vector, without "
+           "forming the matrix of `self`.")
       /// @brief Bind overloaded operators that are in-place on
       /// `cudaq.SpinOperator`.
       // `this_spin_op` += `cudaq.SpinOperator`
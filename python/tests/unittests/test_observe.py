@@ -584,6 +584,40 @@ def test_observe_numpy_array(angles, want_state, want_expectation):
         cudaq.observe(kernel, hamiltonian, bad_params, qpu_id=0, shots_count=10)
 
 
+def test_observe_async_from_threads():
+    """
+    Test `cudaq.observe_async()` and `cudaq.sample_async()` launched from
+    a pool of Python threads, with identical arguments for every call.
+    The bindings release the GIL while the kernel runs and each task owns
+    its arguments.
+    """
+    from concurrent.futures import ThreadPoolExecutor
+
+    kernel, theta = cudaq.make_kernel(float)
+    qreg = kernel.qalloc(2)
+    kernel.x(qreg[0])
+    kernel.ry(theta, qreg[1])
+    kernel.cx(qreg[1], qreg[0])
+    hamiltonian = 5.907 - 2.1433 * spin.x(0) * spin.x(1) - 2.1433 * spin.y(
+        0) * spin.y(1) + .21829 * spin.z(0) - 6.125 * spin.z(1)
+    want_expectation_value = -1.7487948611472093
+
+    def run(i):
+        if i % 2:
+            return cudaq.sample_async(kernel, 0.59).get()
+        return cudaq.observe_async(kernel, hamiltonian,
+                                   0.59).get().expectation_z()
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        results = list(pool.map(run, range(16)))
+
+    for i, result in enumerate(results):
+        if i % 2:
+            assert sum(result.count(k) for k in result) == 1000
+        else:
+            assert assert_close(want_expectation_value, result)
+
+
 # leave for gdb debugging
 if __name__ == "__main__":
     loc = os.path.abspath(__file__)
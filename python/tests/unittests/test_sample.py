@@ -521,6 +521,30 @@ def test_for_loop():
 
     counts.dump()
 
+def test_sample_to_numpy():
+    """
+    Test `cudaq.SampleResult.to_numpy()`, which returns the outcomes as
+    packed integers (bit j is character j of the bitstring) and their
+    counts.
+    """
+    kernel = cudaq.make_kernel()
+    qreg = kernel.qalloc(3)
+    kernel.h(qreg[0])
+    kernel.cx(qreg[0], qreg[1])
+    kernel.x(qreg[2])
+    kernel.mz(qreg)
+    counts = cudaq.sample(kernel, shots_count=100)
+
+    outcomes, observed = counts.to_numpy()
+    assert outcomes.dtype == np.uint64
+    assert observed.dtype == np.uint64
+    assert sorted(outcomes.tolist()) == [0b100, 0b111]
+    assert observed.sum() == 100
+    for outcome, count in zip(outcomes, observed):
+        bitstring = ''.join(str((int(outcome) >> j) & 1) for j in range(3))
+        assert counts.count(bitstring) == count
+
+
 # leave for gdb debugging
 if __name__ == "__main__":
     loc = os.path.abspath(__file__)
@@ -112,6 +112,43 @@ def test_simple_density_matrix():
     cudaq.set_qpu('qpp')
 
 
+def test_state_buffer():
+    """
+    Test that `cudaq.State` exposes its data through the buffer protocol
+    and refers to NumPy arrays without copying them.
+    """
+    circuit = cudaq.make_kernel()
+    q = circuit.qalloc(2)
+    circuit.h(q[0])
+    circuit.cx(q[0], q[1])
+    state = cudaq.get_state(circuit)
+
+    view = np.array(state, copy=False)
+    assert view.dtype == np.complex128
+    assert view.shape == (4,)
+    assert assert_close(1. / np.sqrt(2.), view[0].real)
+    assert assert_close(1. / np.sqrt(2.), view[3].real)
+    # Both views share the state buffer.
+    assert np.shares_memory(view, np.array(state, copy=False))
+
+    # The state copies the array data by default.
+    data = np.array([1., 0., 0., 0.], dtype=np.complex128)
+    zero = cudaq.State(data)
+    assert not np.shares_memory(data, np.array(zero, copy=False))
+    data[0] = 1j
+    assert assert_close(1., zero[0].real)
+
+    # With copy=False it refers to the array data.
+    data = np.array([1., 0., 0., 0.], dtype=np.complex128)
+    zero = cudaq.State(data, copy=False)
+    assert np.shares_memory(data, np.array(zero, copy=False))
+    data[0] = 1j
+    assert assert_close(1., zero[0].imag)
+
+    with pytest.raises(RuntimeError) as error:
+        cudaq.State(np.zeros(8, dtype=np.complex128)[::2])
+
+
 # leave for gdb debugging
 if __name__ == "__main__":
     loc = os.path.abspath(__file__)
@@ -11,22 +11,67 @@
 #include "Future.h"
 #include "MeasureCounts.h"
 #include "NoiseModel.h"
+#include <complex>
+#include <memory>
 #include <optional>
 #include <string_view>
 
 namespace cudaq {
 class spin_op;
 
-// A State is the vector of data for the density matrix or state vector,
-// as well as the array shape (n,n) or (n)
-using State =
-    std::tuple<std::vector<std::size_t>, std::vector<std::complex<double>>>;
+/// @brief A State is the data for the density matrix or state vector, as
+/// well as the array shape (n,n) or (n). The data is kept alive by a
+/// type-erased owner, so that simulators can hand over their own buffer and
+/// clients can view it, without copying it.
+class State {
+private:
+  /// @brief The array shape, (n) or (n,n).
+  std::vector<std::size_t> shape;
+
+  /// @brief The row-major data, owned by (or borrowed through) owner.
+  std::complex<double> *ptr = nullptr;
+
+  /// @brief Keeps the data alive, null if it is borrowed.
+  std::shared_ptr<void> owner;
+
+public:
+  State() = default;
+
+  /// @brief Take ownership of the data vector, moved rather than copied.
+  State(std::vector<std::size_t> shape, std::vector<std::complex<double>> data)
+      : shape(std::move(shape)) {
+    auto owned =
+        std::make_shared<std::vector<std::complex<double>>>(std::move(data));
+    ptr = owned->data();
+    owner = std::move(owned);
+  }
+
+  /// @brief Refer to data kept alive by owner. A null owner borrows the data,
+  /// the caller then keeps it alive for the lifetime of this State.
+  State(std::vector<std::size_t> shape, std::complex<double> *data,
+        std::shared_ptr<void> owner)
+      : shape(std::move(shape)), ptr(data), owner(std::move(owner)) {}
+
+  const std::vector<std::size_t> &getShape() const { return shape; }
+  std::complex<double> *data() const { return ptr; }
+
+  /// @brief Return the number of elements.
+  std::size_t size() const {
+    if (shape.empty())
+      return 0;
+    std::size_t size = 1;
+    for (auto extent : shape)
+      size *= extent;
+    return size;
+  }
+};
 
 /// @brief The ExecutionContext is an abstraction to indicate
 /// how a CUDA Quantum kernel should be executed.
 class ExecutionContext {
 public:
-  /// @brief The name of the context ({basic, sampling, observe})
+  /// @brief The name of the context ({basic, sampling, observe,
+  /// adjoint-gradient, gate-parameters, ...})
   const std::string name;
 
   /// @brief The number of execution shots
@@ -68,6 +113,20 @@ public:
   /// @brief The name of the kernel being executed.
   std::string kernelName = "";
 
+  /// @brief If set, the simulator seeds its random number generator with it
+  /// when the context is set (see cudaq::set_random_seed).
+  std::optional<std::size_t> randomSeed;
+
+  /// @brief The rotation angles of the parameterized gates applied by the
+  /// kernel, in program order. Set under the "adjoint-gradient" and
+  /// "gate-parameters" contexts, the latter only records the gates and does
+  /// not allocate the state.
+  std::vector<double> gateParameters;
+
+  /// @brief The derivative of the expectation value with respect to each of
+  /// the gateParameters. Set under the "adjoint-gradient" context.
+  std::vector<double> gateParameterGradients;
+
   /// @brief The Constructor, takes the name of the context
   /// @param n The name of the context
   ExecutionContext(const std::string n) : name(n) {}
@@ -11,9 +11,87 @@
 #include "ObserveResult.h"
 #include "RestClient.h"
 #include "ServerHelper.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
 
 namespace cudaq::details {
 
+#ifdef CUDAQ_CURL_AVAILABLE
+namespace {
+/// @brief Wait for a remote job with exponential backoff and jitter, starting
+/// at 50 ms and capped at 5 s between polls. Throws if the job is not done
+/// within CUDAQ_REST_JOB_TIMEOUT seconds (if set). Failed polls are retried
+/// with the same backoff.
+class JobPoller {
+  static constexpr std::chrono::milliseconds initialInterval{50};
+  static constexpr std::chrono::milliseconds maxInterval{5000};
+  /// Consecutive failed polls tolerated when there is no deadline.
+  static constexpr std::size_t maxRetries = 8;
+  std::chrono::milliseconds interval = initialInterval;
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  std::size_t failures = 0;
+
+  /// @brief Sleep between half and all of the interval, so that the polls of
+  /// jobs posted together spread out, and grow the interval. Return false
+  /// without sleeping if the deadline would pass.
+  bool sleep() {
+    thread_local std::mt19937 generator(std::random_device{}());
+    std::uniform_int_distribution<long> jitter(0, interval.count() / 2);
+    auto sleepTime = interval - std::chrono::milliseconds(jitter(generator));
+    if (deadline && std::chrono::steady_clock::now() + sleepTime > *deadline)
+      return false;
+    std::this_thread::sleep_for(sleepTime);
+    interval = std::min(2 * interval, maxInterval);
+    return true;
+  }
+
+public:
+  JobPoller() {
+    if (auto *envVal = std::getenv("CUDAQ_REST_JOB_TIMEOUT")) {
+      double seconds = 0.0;
+      try {
+        seconds = std::stod(envVal);
+      } catch (...) {
+        throw std::runtime_error("Invalid CUDAQ_REST_JOB_TIMEOUT environment "
+                                 "variable, must be a number of seconds.");
+      }
+      if (seconds > 0.0)
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::duration<double>(seconds));
+    }
+  }
+
+  /// @brief Sleep before the next poll of the given job.
+  void wait(const std::string &jobId) {
+    failures = 0;
+    if (!sleep())
+      throw std::runtime_error("Timed out waiting for the remote job " +
+                               jobId + ".");
+  }
+
+  /// @brief Sleep before retrying a poll of the given job that failed with
+  /// `error`, e.g. an HTTP or transport error. Throws once the deadline would
+  /// pass or, without a deadline, after maxRetries consecutive failures.
+  void retry(const std::string &jobId, const std::exception &error) {
+    if (!deadline && ++failures > maxRetries)
+      throw std::runtime_error("Polling the remote job " + jobId +
+                               " failed: " + error.what());
+    cudaq::info("Retrying the poll of job {} after error: {}", jobId,
+                error.what());
+    if (!sleep())
+      throw std::runtime_error("Timed out waiting for the remote job " +
+                               jobId + ", last error: " + error.what());
+  }
+};
+} // namespace
+#endif
+
 sample_result future::get() {
   if (wrapsFutureSampling)
     return inFuture.get();
@@ -24,22 +102,51 @@ sample_result future::get() {
   serverHelper->initialize(serverConfig);
   auto headers = serverHelper->getHeaders();
 
-  std::vector<ExecutionResult> results;
-  for (auto &id : jobs) {
-    cudaq::info("Future retrieving results for {}.", id.first);
+  // Poll the jobs concurrently and process each one as soon as it is done,
+  // the ServerHelper is not required to be thread safe.
+  std::vector<ExecutionResult> results(jobs.size());
+  std::mutex helperMutex;
+  runConcurrentRequests(
+      jobs.size(), getMaxRestRequestsInFlight(), [&](std::size_t i) {
+        auto &id = jobs[i];
+        cudaq::info("Future retrieving results for {}.", id.first);
 
-    auto jobGetPath = serverHelper->constructGetJobPath(id.first);
+        std::string jobGetPath;
+        {
+          std::lock_guard<std::mutex> lock(helperMutex);
+          jobGetPath = serverHelper->constructGetJobPath(id.first);
+        }
 
-    cudaq::info("Future got job retrieval path as {}.", jobGetPath);
-    auto resultResponse = client.get(jobGetPath, "", headers);
-    while (!serverHelper->jobIsDone(resultResponse)) {
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-      resultResponse = client.get(jobGetPath, "", headers);
-    }
-    auto c = serverHelper->processResults(resultResponse);
-    results.emplace_back(c.to_map(),
-                         jobs.size() == 1 ? GlobalRegisterName : id.second);
-  }
+        cudaq::info("Future got job retrieval path as {}.", jobGetPath);
+        JobPoller poller;
+        // A failed poll does not fail the job, retry it with backoff.
+        auto getJob = [&]() {
+          while (true) {
+            try {
+              return client.get(jobGetPath, "", headers);
+            } catch (std::exception &e) {
+              poller.retry(id.first, e);
+            }
+          }
+        };
+        auto resultResponse = getJob();
+        while (true) {
+          {
+            std::lock_guard<std::mutex> lock(helperMutex);
+            if (serverHelper->jobIsDone(resultResponse))
+              break;
+          }
+          poller.wait(id.first);
+          resultResponse = getJob();
+        }
+
+        std::lock_guard<std::mutex> lock(helperMutex);
+        auto c = serverHelper->processResults(resultResponse);
+        ExecutionResult result(c.to_map(), jobs.size() == 1
+                                               ? GlobalRegisterName
+                                               : id.second);
+        results[i] = result;
+      });
 
   return sample_result(results);
 #else
@@ -8,6 +8,7 @@
 
 #pragma once
 #include "MeasureCounts.h"
+#include "ObserveGrouping.h"
 #include "ObserveResult.h"
 
 #include <functional>
@@ -119,7 +120,9 @@ public:
         throw std::runtime_error(
             "Returning an observe_result requires a spin_op.");
 
-      // this assumes we ran in shots mode.
+      // this assumes we ran in shots mode, with one register per measured
+      // set of qubit-wise commuting terms.
+      data = expandMeasurementGroups(data, *spinOp);
       double sum = 0.0;
       for (std::size_t i = 0; i < spinOp->n_terms(); i++) {
         auto term = (*spinOp)[i];
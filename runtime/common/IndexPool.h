@@ -0,0 +1,83 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace cudaq {
+
+/// @brief The IndexPool hands out the lowest available index and takes
+/// indices back, e.g. for qudit ids. The indices from a high-water mark on
+/// are implicit, the returned ones below it are kept in a min-heap, so
+/// both operations are O(log n) in the number of returned indices and O(1)
+/// when indices are released in LIFO order.
+///
+/// The capacity is a hint, e.g. the number of qubits of the QPU, it is
+/// doubled when exhausted rather than failing the allocation.
+class IndexPool {
+private:
+  /// @brief Returned indices below nextUnused, as a min-heap.
+  std::vector<std::size_t> returned;
+
+  /// @brief All the indices from nextUnused on are available.
+  std::size_t nextUnused = 0;
+
+  /// @brief The number of indices available before growing.
+  std::size_t capacity;
+
+public:
+  IndexPool(std::size_t capacity = 30) : capacity(capacity) {}
+
+  /// @brief Set the capacity, it never drops below the number of indices
+  /// in use.
+  void setCapacity(std::size_t newCapacity) {
+    capacity = std::max(newCapacity, numAllocated());
+  }
+
+  /// @brief Return the lowest available index.
+  std::size_t getNextIndex() {
+    if (numAllocated() == capacity)
+      capacity = std::max<std::size_t>(2 * capacity, 1);
+    if (returned.empty())
+      return nextUnused++;
+    std::pop_heap(returned.begin(), returned.end(), std::greater<>());
+    auto next = returned.back();
+    returned.pop_back();
+    return next;
+  }
+
+  /// @brief Make the index available again.
+  void returnIndex(std::size_t idx) {
+    if (idx + 1 == nextUnused) {
+      --nextUnused;
+    } else {
+      returned.push_back(idx);
+      std::push_heap(returned.begin(), returned.end(), std::greater<>());
+    }
+    // If all the indices were returned, forget them.
+    if (numAllocated() == 0) {
+      returned.clear();
+      nextUnused = 0;
+    }
+  }
+
+  /// @brief Return the number of indices in use.
+  std::size_t numAllocated() const { return nextUnused - returned.size(); }
+
+  /// @brief Return the number of indices available before growing.
+  std::size_t numAvailable() const { return capacity - numAllocated(); }
+
+  /// @brief Return the current capacity.
+  std::size_t totalNum() const { return capacity; }
+};
+
+} // namespace cudaq
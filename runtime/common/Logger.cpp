@@ -14,6 +14,14 @@
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
 namespace cudaq {
 /// @brief This function will run at startup and initialize
 /// the logger for the runtime to use. It will set the log
@@ -38,6 +46,112 @@ __attribute__((constructor)) void initializeLogger() {
   }
 }
 
+namespace {
+/// @brief A completed ScopedTrace, times in microseconds since startup.
+struct TraceEvent {
+  std::string name;
+  std::string args;
+  double start;
+  double duration;
+};
+
+/// @brief Write the string as a JSON string literal.
+void writeJSONString(std::ostream &os, std::string_view str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      os << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      os << fmt::format("\\u{:04x}", static_cast<int>(c));
+    else
+      os << c;
+  }
+  os << '"';
+}
+
+/// @brief The trace events of one thread. Only that thread adds events,
+/// the mutex orders it with the writer.
+struct ThreadTraceEvents {
+  int threadId;
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+};
+
+/// @brief The TraceEventWriter collects the trace events of all threads and
+/// writes them to CUDAQ_TRACE_FILE at exit, in the Chrome trace-event JSON
+/// format (also read by Perfetto), with one track per thread. It is never
+/// destroyed, so threads still running at exit can keep tracing.
+class TraceEventWriter {
+private:
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadTraceEvents>> threads;
+
+public:
+  const std::string path;
+  const std::chrono::steady_clock::time_point startupTime;
+
+  TraceEventWriter()
+      : path(std::getenv("CUDAQ_TRACE_FILE") ? std::getenv("CUDAQ_TRACE_FILE")
+                                             : ""),
+        startupTime(std::chrono::steady_clock::now()) {}
+
+  /// @brief Return the events buffer of a new thread.
+  std::shared_ptr<ThreadTraceEvents> addThread() {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto thread = std::make_shared<ThreadTraceEvents>();
+    thread->threadId = threads.size();
+    threads.push_back(thread);
+    return thread;
+  }
+
+  void write() {
+    std::ofstream os(path);
+    if (!os)
+      return;
+    auto pid = getpid();
+    std::lock_guard<std::mutex> lock(mutex);
+    os << "{\"traceEvents\":[";
+    for (auto &thread : threads) {
+      std::lock_guard<std::mutex> threadLock(thread->mutex);
+      auto tid = thread->threadId;
+      os << (tid == 0 ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+         << "\"pid\":" << pid << ",\"tid\":" << tid
+         << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+      for (auto &event : thread->events) {
+        os << ",\n{\"name\":";
+        writeJSONString(os, event.name);
+        os << ",\"cat\":\"cudaq\",\"ph\":\"X\",\"ts\":"
+           << fmt::format("{:.3f}", event.start)
+           << ",\"dur\":" << fmt::format("{:.3f}", event.duration)
+           << ",\"pid\":" << pid << ",\"tid\":" << tid;
+        if (!event.args.empty()) {
+          os << ",\"args\":{\"args\":";
+          writeJSONString(os, event.args);
+          os << "}";
+        }
+        os << "}";
+      }
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  }
+};
+
+TraceEventWriter &getTraceEventWriter() {
+  static TraceEventWriter *writer = []() {
+    auto *writer = new TraceEventWriter();
+    if (!writer->path.empty())
+      std::atexit([]() { getTraceEventWriter().write(); });
+    return writer;
+  }();
+  return *writer;
+}
+
+bool traceEventsEnabled() {
+  static const bool enabled = !getTraceEventWriter().path.empty();
+  return enabled;
+}
+} // namespace
+
 namespace details {
 void trace(const std::string_view msg) { spdlog::trace(msg); }
 void info(const std::string_view msg) { spdlog::info(msg); }
@@ -46,5 +160,48 @@ void debug(const std::string_view msg) {
   spdlog::debug(msg);
 #endif
 }
+
+bool should_log(const LogLevel logLevel) {
+  switch (logLevel) {
+  case LogLevel::trace:
+    return spdlog::should_log(spdlog::level::trace);
+  case LogLevel::info:
+    return spdlog::should_log(spdlog::level::info);
+  case LogLevel::debug:
+#ifdef CUDAQ_DEBUG
+    return spdlog::should_log(spdlog::level::debug);
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+bool should_trace() {
+  return traceEventsEnabled() || spdlog::should_log(spdlog::level::trace);
+}
+
+void endTrace(std::string_view name, std::string_view args,
+              std::chrono::steady_clock::time_point start, int depth) {
+  auto end = std::chrono::steady_clock::now();
+  if (spdlog::should_log(spdlog::level::trace)) {
+    auto duration =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    spdlog::trace("{}{} executed in {} ms.{}{}{}",
+                  depth > 0 ? std::string(depth, '-') + " " : "", name,
+                  duration, args.empty() ? "" : " (args = ", args,
+                  args.empty() ? "" : ")");
+  }
+
+  if (traceEventsEnabled()) {
+    thread_local auto threadEvents = getTraceEventWriter().addThread();
+    auto startupTime = getTraceEventWriter().startupTime;
+    using micros = std::chrono::duration<double, std::micro>;
+    std::lock_guard<std::mutex> lock(threadEvents->mutex);
+    threadEvents->events.push_back({std::string(name), std::string(args),
+                                    micros(start - startupTime).count(),
+                                    micros(end - start).count()});
+  }
+}
 } // namespace details
 } // namespace cudaq
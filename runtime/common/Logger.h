@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <filesystem>
+#include <string>
+#include <string_view>
 
 // Be careful about Logger.h getting into public headers
 #include <fmt/core.h>
@@ -21,6 +24,21 @@ namespace details {
 void trace(const std::string_view msg);
 void info(const std::string_view msg);
 void debug(const std::string_view msg);
+
+/// @brief The log levels of the above functions.
+enum class LogLevel { trace, info, debug };
+
+/// @brief Return true if messages at the given level will be emitted. Use
+/// this to avoid building expensive log messages when logging is off.
+bool should_log(const LogLevel logLevel);
+
+/// @brief Return true if ScopedTrace instances are reported, to the trace
+/// log level or to the CUDAQ_TRACE_FILE trace-event file.
+bool should_trace();
+
+/// @brief Report a completed ScopedTrace, nested depth levels deep.
+void endTrace(std::string_view name, std::string_view args,
+              std::chrono::steady_clock::time_point start, int depth);
 } // namespace details
 
 /// This type seeks to enable automated injection of the
@@ -40,14 +58,12 @@ void debug(const std::string_view msg);
          const char *funcName = __builtin_FUNCTION(),                          \
          const char *fileName = __builtin_FILE(),                              \
          int lineNo = __builtin_LINE()) {                                      \
-      auto msg = fmt::format(fmt::runtime(message), args...);                  \
-      std::string name = funcName;                                             \
-      auto start = name.find_first_of(" ");                                    \
-      name = name.substr(start + 1, name.find_first_of("(") - start - 1);      \
-      std::filesystem::path file = fileName;                                   \
-      msg = "[" + file.filename().string() + ":" + std::to_string(lineNo) +    \
-            "] " + msg;                                                        \
-      details::NAME(msg);                                                      \
+      if (!details::should_log(details::LogLevel::NAME))                       \
+        return;                                                                \
+      std::string_view file = fileName;                                        \
+      file.remove_prefix(file.find_last_of('/') + 1);                          \
+      details::NAME(fmt::format("[{}:{}] {}", file, lineNo,                    \
+                                fmt::format(fmt::runtime(message), args...))); \
     }                                                                          \
   };                                                                           \
   template <typename... Args>                                                  \
@@ -82,10 +98,14 @@ CUDAQ_LOGGER_DEDUCTION_STRUCT(debug);
 // [2022-12-15 18:54:39.346] [trace] -- foobar() executed in 0.026 ms.
 // [2022-12-15 18:54:39.347] [trace] - bar executed in 0.604 ms.
 // [2022-12-15 18:54:39.347] [trace] foo executed in 2.572 ms.
+//
+// If the CUDAQ_TRACE_FILE environment variable is set, the traces are also
+// written to that file as Chrome trace events (one track per thread), to be
+// opened with chrome://tracing or https://ui.perfetto.dev.
 class ScopedTrace {
 private:
   /// @brief Time when this ScopedTrace is created.
-  std::chrono::time_point<std::chrono::system_clock> startTime;
+  std::chrono::steady_clock::time_point startTime;
 
   /// @brief The name of this trace, typically the function name
   std::string traceName;
@@ -93,42 +113,55 @@ private:
   /// @brief Any args the user would also like to print
   std::string argsMsg;
 
-  static inline short int globalTraceStack = -1;
+  /// @brief False if tracing is off, then nothing is formatted or reported.
+  bool enabled;
+
+  static inline thread_local short int globalTraceStack = -1;
 
 public:
   /// @brief The constructor
-  ScopedTrace(const std::string &name)
-      : startTime(std::chrono::system_clock::now()), traceName(name) {
+  ScopedTrace(std::string_view name) : enabled(details::should_trace()) {
+    if (!enabled)
+      return;
+    traceName = name;
     globalTraceStack++;
+    startTime = std::chrono::steady_clock::now();
   }
 
   /// @brief  Constructor, take and print user-specified critical args
   template <typename... Args>
-  ScopedTrace(const std::string &name, Args &&...args)
-      : startTime(std::chrono::system_clock::now()), traceName(name) {
-    argsMsg = " (args = {{";
+  ScopedTrace(std::string_view name, Args &&...args)
+      : enabled(details::should_trace()) {
+    if (!enabled)
+      return;
+    traceName = name;
+    argsMsg = "{{";
     constexpr std::size_t nArgs = sizeof...(Args);
     for (std::size_t i = 0; i < nArgs; i++) {
-      argsMsg += (i != nArgs - 1) ? "{}, " : "{}}})";
+      argsMsg += (i != nArgs - 1) ? "{}, " : "{}}}";
     }
     argsMsg = fmt::format(fmt::runtime(argsMsg), args...);
     globalTraceStack++;
+    startTime = std::chrono::steady_clock::now();
   }
 
   /// The destructor, get the elapsed time and trace.
   ~ScopedTrace() {
-    auto duration = static_cast<double>(
-        std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::system_clock::now() - startTime)
-            .count() /
-        1000.0);
-    details::trace(fmt::format(
-        "{}{} executed in {} ms.{}",
-        globalTraceStack > 0 ? std::string(globalTraceStack, '-') + " " : "",
-        traceName, duration, argsMsg));
+    if (!enabled)
+      return;
+    details::endTrace(traceName, argsMsg, startTime, globalTraceStack);
     globalTraceStack--;
   }
 };
+
+/// @brief Trace the enclosing scope with a ScopedTrace, taking the same
+/// arguments. Building with CUDAQ_DISABLE_TRACE removes these trace points,
+/// including the evaluation of their arguments.
+#ifdef CUDAQ_DISABLE_TRACE
+#define CUDAQ_TRACE_SCOPE(...) (void)0
+#else
+#define CUDAQ_TRACE_SCOPE(...) cudaq::ScopedTrace cudaqScopedTrace(__VA_ARGS__)
+#endif
 } // namespace cudaq
 
 // Note from Alex:
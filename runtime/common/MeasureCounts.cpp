@@ -9,6 +9,8 @@
 #include "MeasureCounts.h"
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <numeric>
 #include <string.h>
 
@@ -17,15 +19,219 @@
 #include <vector>
 
 namespace cudaq {
-std::string longToBitString(int size, long x) {
-  std::string s(size, '0');
-  int counter = 0;
-  do {
-    s[counter] = '0' + (x & 1);
-    counter++;
-  } while (x >>= 1);
-  std::reverse(s.begin(), s.end());
-  return s;
+static std::size_t numWords(std::size_t nBits) { return (nBits + 63) / 64; }
+
+void packBitString(std::string_view bitString,
+                   std::vector<std::uint64_t> &words) {
+  words.assign(numWords(bitString.size()), 0);
+  for (std::size_t j = 0; j < bitString.size(); j++) {
+    if (bitString[j] == '1')
+      words[j / 64] |= 1ULL << (j % 64);
+    else if (bitString[j] != '0')
+      throw std::runtime_error("Invalid measurement bit string (" +
+                               std::string(bitString) + ").");
+  }
+}
+
+std::string unpackBitString(const std::uint64_t *words, std::size_t nBits) {
+  std::string bitString;
+  unpackBitString(words, nBits, bitString);
+  return bitString;
+}
+
+void unpackBitString(const std::uint64_t *words, std::size_t nBits,
+                     std::string &bitString) {
+  bitString.assign(nBits, '0');
+  for (std::size_t j = 0; j < nBits; j++)
+    if ((words[j / 64] >> (j % 64)) & 1ULL)
+      bitString[j] = '1';
+}
+
+/// @brief The process-wide sequential data recording setting.
+static std::atomic<bool> sequentialDataRecording = true;
+
+void set_record_sequential_data(bool record) {
+  sequentialDataRecording = record;
+}
+
+bool get_record_sequential_data() { return sequentialDataRecording; }
+
+/// @brief Return the packed bit string in a per-thread scratch buffer, to
+/// avoid an allocation per lookup.
+static const std::vector<std::uint64_t> &
+packToScratch(std::string_view bitString) {
+  thread_local std::vector<std::uint64_t> scratch;
+  packBitString(bitString, scratch);
+  return scratch;
+}
+
+static std::size_t hashBits(const std::uint64_t *words, std::size_t nBits) {
+  // Combine the words with the splitmix64 finalizer.
+  auto mix = [](std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  };
+  std::uint64_t hash = mix(nBits);
+  for (std::size_t w = 0; w < numWords(nBits); w++)
+    hash = mix(hash ^ words[w]);
+  return static_cast<std::size_t>(hash);
+}
+
+PackedCounts::PackedCounts(const CountsDictionary &counts) {
+  for (auto &[bits, count] : counts)
+    add(bits, count);
+}
+
+void PackedCounts::clear() {
+  stride = 1;
+  lengths.clear();
+  keys.clear();
+  values.clear();
+  slots.clear();
+}
+
+std::size_t PackedCounts::find(const std::uint64_t *words, std::size_t nBits,
+                               std::size_t hash) const {
+  if (slots.empty())
+    return npos;
+  const std::size_t mask = slots.size() - 1;
+  const std::size_t nKeyWords = numWords(nBits);
+  for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    auto entry = slots[slot];
+    if (entry == 0)
+      return npos;
+    entry--;
+    if (lengths[entry] == nBits &&
+        std::equal(words, words + nKeyWords, bits(entry)))
+      return entry;
+  }
+}
+
+std::size_t PackedCounts::find(const std::uint64_t *words,
+                               std::size_t nBits) const {
+  return find(words, nBits, hashBits(words, nBits));
+}
+
+std::size_t PackedCounts::find(std::string_view bitString) const {
+  return find(packToScratch(bitString).data(), bitString.size());
+}
+
+void PackedCounts::rehash(std::size_t nSlots) {
+  slots.assign(nSlots, 0);
+  const std::size_t mask = nSlots - 1;
+  for (std::size_t entry = 0; entry < values.size(); entry++) {
+    auto slot = hashBits(bits(entry), lengths[entry]) & mask;
+    while (slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    slots[slot] = entry + 1;
+  }
+}
+
+std::size_t PackedCounts::insert(const std::uint64_t *words,
+                                 std::size_t nBits) {
+  auto hash = hashBits(words, nBits);
+  auto entry = find(words, nBits, hash);
+  if (entry != npos)
+    return entry;
+
+  // Widen the stored keys if this bit string does not fit.
+  const std::size_t nKeyWords = numWords(nBits);
+  if (nKeyWords > stride) {
+    std::vector<std::uint64_t> widened(values.size() * nKeyWords, 0);
+    for (std::size_t i = 0; i < values.size(); i++)
+      std::copy_n(bits(i), stride, widened.begin() + i * nKeyWords);
+    keys = std::move(widened);
+    stride = nKeyWords;
+  }
+
+  // Keep the index at most half full.
+  entry = values.size();
+  lengths.push_back(nBits);
+  keys.insert(keys.end(), words, words + nKeyWords);
+  keys.resize(keys.size() + stride - nKeyWords, 0);
+  values.push_back(0);
+  if (2 * values.size() > slots.size()) {
+    rehash(std::max<std::size_t>(16, 2 * slots.size()));
+    return entry;
+  }
+
+  const std::size_t mask = slots.size() - 1;
+  auto slot = hash & mask;
+  while (slots[slot] != 0)
+    slot = (slot + 1) & mask;
+  slots[slot] = entry + 1;
+  return entry;
+}
+
+std::size_t PackedCounts::get(std::string_view bitString) const {
+  auto entry = find(bitString);
+  return entry == npos ? 0 : values[entry];
+}
+
+std::size_t &PackedCounts::operator[](std::string_view bitString) {
+  auto &words = packToScratch(bitString);
+  return values[insert(words.data(), bitString.size())];
+}
+
+void PackedCounts::add(std::string_view bitString, std::size_t count) {
+  (*this)[bitString] += count;
+}
+
+void PackedCounts::add(const std::uint64_t *words, std::size_t nBits,
+                       std::size_t count) {
+  values[insert(words, nBits)] += count;
+}
+
+void PackedCounts::merge(const PackedCounts &other) {
+  for (std::size_t i = 0; i < other.size(); i++)
+    add(other.bits(i), other.numBits(i), other.countAt(i));
+}
+
+std::size_t PackedCounts::totalCount() const {
+  return std::accumulate(values.begin(), values.end(), std::size_t(0));
+}
+
+CountsDictionary PackedCounts::toMap() const {
+  CountsDictionary counts;
+  counts.reserve(size());
+  for (std::size_t i = 0; i < size(); i++)
+    counts.emplace(bitString(i), values[i]);
+  return counts;
+}
+
+bool PackedCounts::operator==(const PackedCounts &other) const {
+  if (size() != other.size())
+    return false;
+  for (std::size_t i = 0; i < size(); i++) {
+    auto entry = other.find(bits(i), lengths[i]);
+    if (entry == npos || other.values[entry] != values[i])
+      return false;
+  }
+  return true;
+}
+
+void PackedShotLog::push_back(const std::uint64_t *words, std::size_t nBits) {
+  data.push_back(nBits);
+  data.insert(data.end(), words, words + numWords(nBits));
+  nEntries++;
+}
+
+void PackedShotLog::push_back(std::string_view bitString) {
+  push_back(packToScratch(bitString).data(), bitString.size());
+}
+
+void PackedShotLog::append(const PackedShotLog &other) {
+  data.insert(data.end(), other.data.begin(), other.data.end());
+  nEntries += other.nEntries;
+}
+
+std::vector<std::string> PackedShotLog::toStrings() const {
+  std::vector<std::string> bitStrings;
+  bitStrings.reserve(nEntries);
+  for (std::size_t i = 0; i < data.size(); i += 1 + numWords(data[i]))
+    bitStrings.push_back(unpackBitString(&data[i + 1], data[i]));
+  return bitStrings;
 }
 
 ExecutionResult::ExecutionResult(CountsDictionary c) : counts(c) {}
@@ -41,24 +247,28 @@ ExecutionResult::ExecutionResult(CountsDictionary c, double e)
     : counts(c), expectationValue(e) {}
 ExecutionResult::ExecutionResult(const ExecutionResult &other)
     : counts(other.counts), expectationValue(other.expectationValue),
-      registerName(other.registerName), sequentialData(other.sequentialData) {}
+      registerName(other.registerName), sequentialData(other.sequentialData),
+      recordSequentialData(other.recordSequentialData) {}
 
 ExecutionResult &ExecutionResult::operator=(ExecutionResult &other) {
   counts = other.counts;
   expectationValue = other.expectationValue;
   registerName = other.registerName;
   sequentialData = other.sequentialData;
+  recordSequentialData = other.recordSequentialData;
   return *this;
 }
 
 void ExecutionResult::appendResult(std::string bitString, std::size_t count) {
-  auto iter = counts.find(bitString);
-  if (iter == counts.end())
-    counts.insert({bitString, count});
-  else
-    iter->second += count;
+  auto &words = packToScratch(bitString);
+  appendResult(words.data(), bitString.size(), count);
+}
 
-  sequentialData.push_back(bitString);
+void ExecutionResult::appendResult(const std::uint64_t *words,
+                                   std::size_t nBits, std::size_t count) {
+  counts.add(words, nBits, count);
+  if (recordSequentialData)
+    sequentialData.push_back(words, nBits);
 }
 
 bool ExecutionResult::operator==(const ExecutionResult &result) const {
@@ -67,7 +277,7 @@ bool ExecutionResult::operator==(const ExecutionResult &result) const {
 
 /// @brief  Encoding - 1st element is size of the register name N, then next N
 // represent register name, number of bitstrings M, then for each bit string
-// {l, bs.length, count}
+// {bs.length, count, packed words}
 /// @return
 std::vector<std::size_t> ExecutionResult::serialize() {
   std::vector<std::size_t> retData;
@@ -80,40 +290,48 @@ std::vector<std::size_t> ExecutionResult::serialize() {
 
   // Encode the counts data
   retData.push_back(counts.size());
-  for (auto &kv : counts) {
-    auto bits = kv.first;
-    auto count = kv.second;
-    auto l = std::stol(bits, NULL, 2);
-    retData.push_back(l);
-    retData.push_back(bits.length());
-    retData.push_back(count);
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    auto nBits = counts.numBits(i);
+    retData.push_back(nBits);
+    retData.push_back(counts.countAt(i));
+    retData.insert(retData.end(), counts.bits(i),
+                   counts.bits(i) + numWords(nBits));
   }
 
   return retData;
 }
 
+/// @brief Decode the counts of one ExecutionResult (see
+/// ExecutionResult::serialize()) starting at stride, return its register name
+/// and advance stride past it.
+static std::string deserializeCounts(std::vector<std::size_t> &data,
+                                     std::size_t &stride,
+                                     PackedCounts &counts) {
+  auto nChars = data[stride];
+  stride++;
+  std::string name = "";
+  for (std::size_t i = 0; i < nChars; i++)
+    name += std::string(1, char(data[stride + i]));
+  stride += nChars;
+
+  auto nBs = data[stride];
+  stride++;
+  std::vector<std::uint64_t> words;
+  for (std::size_t j = 0; j < nBs; j++) {
+    auto nBits = data[stride];
+    auto count = data[stride + 1];
+    auto first = data.begin() + stride + 2;
+    words.assign(first, first + numWords(nBits));
+    counts.add(words.data(), nBits, count);
+    stride += 2 + numWords(nBits);
+  }
+  return name;
+}
+
 void ExecutionResult::deserialize(std::vector<std::size_t> &data) {
   std::size_t stride = 0;
-  while (stride < data.size()) {
-    auto nChars = data[stride];
-    stride++;
-    std::string name = "";
-    for (std::size_t i = 0; i < nChars; i++)
-      name += std::string(1, char(data[stride + i]));
-
-    stride += nChars;
-    std::unordered_map<std::string, std::size_t> localCounts;
-    auto nBs = data[stride];
-    stride++;
-    for (std::size_t j = stride; j < stride + nBs * 3; j += 3) {
-      auto bitstring_as_long = data[j];
-      auto size_of_bitstring = data[j + 1];
-      auto count = data[j + 2];
-      auto bs = longToBitString(size_of_bitstring, bitstring_as_long);
-      counts.insert({bs, count});
-    }
-    stride += nBs * 3;
-  }
+  while (stride < data.size())
+    deserializeCounts(data, stride, counts);
 }
 
 std::vector<std::size_t> sample_result::serialize() {
@@ -128,45 +346,24 @@ std::vector<std::size_t> sample_result::serialize() {
 void sample_result::deserialize(std::vector<std::size_t> &data) {
   std::size_t stride = 0;
   while (stride < data.size()) {
-    auto nChars = data[stride];
-    stride++;
-    std::string name = "";
-    for (std::size_t i = 0; i < nChars; i++)
-      name += std::string(1, char(data[stride + i]));
-
-    stride += nChars;
-    std::size_t localShots = 0;
-    std::unordered_map<std::string, std::size_t> localCounts;
-    auto nBs = data[stride];
-    stride++;
-    for (std::size_t j = stride; j < stride + nBs * 3; j += 3) {
-      auto bitstring_as_long = data[j];
-      auto size_of_bitstring = data[j + 1];
-      auto count = data[j + 2];
-      auto bs = longToBitString(size_of_bitstring, bitstring_as_long);
-      localShots += count;
-      localCounts.insert({bs, count});
-    }
-
-    sampleResults.insert({name, ExecutionResult{localCounts, name}});
-
-    stride += nBs * 3;
-    totalShots = localShots;
+    ExecutionResult result;
+    auto name = deserializeCounts(data, stride, result.counts);
+    result.registerName = name;
+    totalShots = result.counts.totalCount();
+    sampleResults.insert({name, std::move(result)});
   }
 }
 
 sample_result::sample_result(ExecutionResult &result) {
+  totalShots = result.counts.totalCount();
   sampleResults.insert({result.registerName, std::move(result)});
-  for (auto &[bits, count] : result.counts)
-    totalShots += count;
 }
 
 sample_result::sample_result(std::vector<ExecutionResult> &results) {
   for (auto &result : results) {
     sampleResults.insert({result.registerName, result});
   }
-  for (auto &[bits, count] : results[0].counts)
-    totalShots += count;
+  totalShots = results[0].counts.totalCount();
 }
 
 sample_result::sample_result(double preComputedExp,
@@ -178,15 +375,13 @@ sample_result::sample_result(double preComputedExp,
   // Create a spot for the pre-computed exp val
   sampleResults.emplace(GlobalRegisterName, preComputedExp);
 
-  for (auto &[bits, count] : results[0].counts)
-    totalShots += count;
+  totalShots = results[0].counts.totalCount();
 }
 
 void sample_result::append(ExecutionResult &result) {
   sampleResults.insert({result.registerName, result});
   if (!totalShots)
-    for (auto &[bits, count] : result.counts)
-      totalShots += count;
+    totalShots = result.counts.totalCount();
 }
 
 sample_result::sample_result(const sample_result &m)
@@ -225,18 +420,9 @@ sample_result &sample_result::operator+=(sample_result &other) {
       // we already have a sample result with this name, so
       // now lets just merge them
       auto &sr = sampleResults[regName];
-      for (auto &[bits, count] : otherResults.second.counts) {
-        auto &ourCounts = sr.counts;
-        if (ourCounts.count(bits))
-          ourCounts[bits] += count;
-        else
-          ourCounts.insert({bits, count});
-      }
-
-      if (!otherResults.second.sequentialData.empty())
-        sr.sequentialData.insert(sr.sequentialData.end(),
-                                 otherResults.second.sequentialData.begin(),
-                                 otherResults.second.sequentialData.end());
+      sr.counts.merge(otherResults.second.counts);
+      if (sr.recordSequentialData)
+        sr.sequentialData.append(otherResults.second.sequentialData);
     }
   }
   return *this;
@@ -254,7 +440,7 @@ sample_result::sequential_data(const std::string_view registerName) {
   return data;
 }
 
-CountsDictionary::iterator sample_result::begin() {
+PackedCounts::iterator sample_result::begin() {
   auto iter = sampleResults.find(GlobalRegisterName);
   if (iter == sampleResults.end()) {
     throw std::runtime_error(
@@ -264,7 +450,7 @@ CountsDictionary::iterator sample_result::begin() {
   return iter->second.counts.begin();
 }
 
-CountsDictionary::iterator sample_result::end() {
+PackedCounts::iterator sample_result::end() {
   auto iter = sampleResults.find(GlobalRegisterName);
   if (iter == sampleResults.end()) {
     throw std::runtime_error(
@@ -274,24 +460,24 @@ CountsDictionary::iterator sample_result::end() {
   return iter->second.counts.end();
 }
 
-CountsDictionary::const_iterator sample_result::cbegin() const {
+PackedCounts::const_iterator sample_result::cbegin() const {
   auto iter = sampleResults.find(GlobalRegisterName);
   if (iter == sampleResults.end()) {
     throw std::runtime_error(
         "There is no global counts dictionary in this sample_result.");
   }
 
-  return iter->second.counts.cbegin();
+  return iter->second.counts.begin();
 }
 
-CountsDictionary::const_iterator sample_result::cend() const {
+PackedCounts::const_iterator sample_result::cend() const {
   auto iter = sampleResults.find(GlobalRegisterName);
   if (iter == sampleResults.end()) {
     throw std::runtime_error(
         "There is no global counts dictionary in this sample_result.");
   }
 
-  return iter->second.counts.cend();
+  return iter->second.counts.end();
 }
 
 std::size_t sample_result::size(const std::string_view registerName) noexcept {
@@ -308,7 +494,7 @@ double sample_result::probability(std::string_view bitStr,
   if (iter == sampleResults.end())
     return 0.0;
 
-  return (double)iter->second.counts[bitStr.data()] / totalShots;
+  return (double)iter->second.counts.get(bitStr) / totalShots;
 }
 
 std::size_t sample_result::count(std::string_view bitStr,
@@ -317,7 +503,7 @@ std::size_t sample_result::count(std::string_view bitStr,
   if (iter == sampleResults.end())
     return 0;
 
-  return iter->second.counts[bitStr.data()];
+  return iter->second.counts.get(bitStr);
 }
 
 std::string sample_result::most_probable(const std::string_view registerName) {
@@ -326,12 +512,12 @@ std::string sample_result::most_probable(const std::string_view registerName) {
     throw std::runtime_error(
         "[sample_result::most_probable] invalid sample result register name (" +
         std::string(registerName) + ")");
-  auto counts = iter->second.counts;
-  return std::max_element(counts.begin(), counts.end(),
-                          [](const auto &el1, const auto &el2) {
-                            return el1.second < el2.second;
-                          })
-      ->first;
+  auto &counts = iter->second.counts;
+  std::size_t best = 0;
+  for (std::size_t i = 1; i < counts.size(); i++)
+    if (counts.countAt(i) > counts.countAt(best))
+      best = i;
+  return counts.empty() ? std::string() : counts.bitString(best);
 }
 
 bool sample_result::has_expectation(const std::string_view registerName) {
@@ -343,12 +529,6 @@ bool sample_result::has_expectation(const std::string_view registerName) {
 }
 
 double sample_result::exp_val_z(const std::string_view registerName) {
-  double aver = 0.0;
-  auto has_even_parity = [](const std::string &x) -> bool {
-    int c = std::count(x.begin(), x.end(), '1');
-    return c % 2 == 0;
-  };
-
   auto iter = sampleResults.find(registerName.data());
   if (iter == sampleResults.end())
     return 0.0;
@@ -356,14 +536,15 @@ double sample_result::exp_val_z(const std::string_view registerName) {
   if (iter->second.expectationValue.has_value())
     return iter->second.expectationValue.value();
 
-  auto counts = iter->second.counts;
-  for (auto &kv : counts) {
-    auto par = has_even_parity(kv.first);
-    auto p = probability(kv.first, registerName);
-    if (!par) {
-      p = -p;
-    }
-    aver += p;
+  // The parity of each bit string is the parity of its packed words.
+  auto &counts = iter->second.counts;
+  double aver = 0.0;
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    int ones = 0;
+    for (std::size_t w = 0; w < (counts.numBits(i) + 63) / 64; w++)
+      ones += std::popcount(counts.bits(i)[w]);
+    double p = (double)counts.countAt(i) / totalShots;
+    aver += ones % 2 == 0 ? p : -p;
   }
 
   return aver;
@@ -382,6 +563,16 @@ CountsDictionary sample_result::to_map(const std::string_view registerName) {
   if (iter == sampleResults.end())
     return CountsDictionary();
 
+  return iter->second.counts.toMap();
+}
+
+const PackedCounts &
+sample_result::packed_counts(const std::string_view registerName) const {
+  static const PackedCounts empty;
+  auto iter = sampleResults.find(registerName.data());
+  if (iter == sampleResults.end())
+    return empty;
+
   return iter->second.counts;
 }
 
@@ -392,25 +583,28 @@ sample_result::get_marginal(const std::vector<std::size_t> &marginalIndices,
   if (iter == sampleResults.end())
     return sample_result();
 
-  auto counts = iter->second.counts;
+  auto &counts = iter->second.counts;
   auto mutableIndices = marginalIndices;
 
   std::sort(mutableIndices.begin(), mutableIndices.end());
 
   ExecutionResult sr;
-  for (auto &[bits, count] : counts) {
-    std::string newBits;
-    for ([[maybe_unused]] auto &m : mutableIndices)
-      newBits += "0";
-    for (int counter = 0; auto &index : mutableIndices) {
-      if (index > bits.size())
+  std::vector<std::uint64_t> newBits;
+  for (std::size_t i = 0; i < counts.size(); i++) {
+    auto nBits = counts.numBits(i);
+    const auto *bits = counts.bits(i);
+    newBits.assign((mutableIndices.size() + 63) / 64, 0);
+    for (std::size_t counter = 0; auto &index : mutableIndices) {
+      if (index >= nBits)
         throw std::runtime_error("Invalid marginal index (" +
                                  std::to_string(index) +
-                                 ", size=" + std::to_string(bits.size()));
+                                 ", size=" + std::to_string(nBits));
 
-      newBits[counter++] = bits[index];
+      if ((bits[index / 64] >> (index % 64)) & 1ULL)
+        newBits[counter / 64] |= 1ULL << (counter % 64);
+      counter++;
     }
-    sr.appendResult(newBits, count);
+    sr.counts.add(newBits.data(), mutableIndices.size(), counts.countAt(i));
   }
 
   return sample_result(sr);
@@ -438,16 +632,15 @@ void sample_result::dump(std::ostream &os) {
 
   } else if (sampleResults.size() == 1) {
 
-    CountsDictionary counts;
     auto iter = sampleResults.find(GlobalRegisterName);
-    if (iter != sampleResults.end())
-      counts = iter->second.counts;
-    else {
+    if (iter == sampleResults.end()) {
       auto first = sampleResults.begin();
       os << "\n   " << first->first << " : { ";
-      counts = sampleResults.begin()->second.counts;
     }
 
+    auto &counts = iter != sampleResults.end()
+                       ? iter->second.counts
+                       : sampleResults.begin()->second.counts;
     for (auto &kv : counts) {
       os << kv.first << ":" << kv.second << " ";
     }
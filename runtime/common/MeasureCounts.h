@@ -8,9 +8,12 @@
 
 #pragma once
 
+#include <cstdint>
+#include <iterator>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -21,6 +24,187 @@ using CountsDictionary = std::unordered_map<std::string, std::size_t>;
 
 inline static const std::string GlobalRegisterName = "__global__";
 
+/// @brief Pack the measurement bit string (of '0' and '1' characters) into
+/// words, character j is bit j % 64 of word j / 64.
+void packBitString(std::string_view bitString,
+                   std::vector<std::uint64_t> &words);
+
+/// @brief Return the bit string of nBits bits packed into the given words.
+std::string unpackBitString(const std::uint64_t *words, std::size_t nBits);
+
+/// @brief Unpack the bit string of nBits bits into bitString, reusing its
+/// buffer.
+void unpackBitString(const std::uint64_t *words, std::size_t nBits,
+                     std::string &bitString);
+
+/// @brief Turn the recording of the sequential bit strings (see
+/// sample_result::sequential_data) on or off for the ExecutionResults
+/// created from then on. It is on by default, turning it off saves the
+/// memory and time of the shot log when only the counts are needed.
+void set_record_sequential_data(bool record);
+
+/// @brief Return true if new ExecutionResults record their sequential bit
+/// strings.
+bool get_record_sequential_data();
+
+/// @brief The PackedCounts is a flat hash table from measurement bit strings
+/// to the number of times they were observed. The bit strings are packed into
+/// words (see packBitString), stored contiguously in insertion order and
+/// indexed with open addressing, so that wide registers with many unique
+/// outcomes take a few words per outcome rather than a std::string and a map
+/// node each. The string-based API (lookup, iteration) packs or unpacks the
+/// bit strings on the fly.
+class PackedCounts {
+private:
+  /// @brief The number of words each bit string is stored in, for the widest
+  /// bit string inserted so far.
+  std::size_t stride = 1;
+
+  /// @brief The length (in bits) of each bit string.
+  std::vector<std::size_t> lengths;
+
+  /// @brief The packed bit strings, stride words each.
+  std::vector<std::uint64_t> keys;
+
+  /// @brief The number of times each bit string was observed.
+  std::vector<std::size_t> values;
+
+  /// @brief Open addressing (linear probing) index, holds the entry index
+  /// plus one, zero marks an empty slot. The size is a power of 2.
+  std::vector<std::size_t> slots;
+
+  std::size_t find(const std::uint64_t *words, std::size_t nBits,
+                   std::size_t hash) const;
+  std::size_t insert(const std::uint64_t *words, std::size_t nBits);
+  void rehash(std::size_t nSlots);
+
+public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  /// @brief Iterator over the (bit string, count) pairs in insertion order,
+  /// the bit string is unpacked when dereferenced. The returned pair is
+  /// owned by the iterator, which reuses its string buffer, and is read-only
+  /// (use countAt to update a count).
+  class const_iterator {
+  private:
+    const PackedCounts *table = nullptr;
+    std::size_t index = 0;
+    mutable std::pair<std::string, std::size_t> current;
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<std::string, std::size_t>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    const_iterator() = default;
+    const_iterator(const PackedCounts *t, std::size_t i) : table(t), index(i) {}
+
+    reference operator*() const {
+      unpackBitString(table->bits(index), table->lengths[index],
+                      current.first);
+      current.second = table->values[index];
+      return current;
+    }
+    pointer operator->() const { return &**this; }
+    const_iterator &operator++() {
+      index++;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto tmp = *this;
+      index++;
+      return tmp;
+    }
+    bool operator==(const const_iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return index != other.index;
+    }
+  };
+  using iterator = const_iterator;
+
+  PackedCounts() = default;
+  PackedCounts(const CountsDictionary &counts);
+
+  /// @brief Return the number of unique bit strings.
+  std::size_t size() const { return values.size(); }
+  bool empty() const { return values.empty(); }
+  void clear();
+
+  /// @brief Return the index of the bit string, or npos if not observed.
+  std::size_t find(std::string_view bitString) const;
+  std::size_t find(const std::uint64_t *words, std::size_t nBits) const;
+
+  /// @brief Return the number of times the bit string was observed.
+  std::size_t get(std::string_view bitString) const;
+  bool contains(std::string_view bitString) const {
+    return find(bitString) != npos;
+  }
+
+  /// @brief Return the count of the bit string, inserting it if not observed.
+  std::size_t &operator[](std::string_view bitString);
+
+  /// @brief Add count observations of the bit string.
+  void add(std::string_view bitString, std::size_t count);
+  void add(const std::uint64_t *words, std::size_t nBits, std::size_t count);
+
+  /// @brief Add all the observations in other.
+  void merge(const PackedCounts &other);
+
+  /// @brief Return the total number of observations.
+  std::size_t totalCount() const;
+
+  /// @brief Return the number of words each bit string is stored in. The
+  /// bit strings are contiguous, zero padded to that width.
+  std::size_t wordsPerEntry() const { return stride; }
+
+  /// @brief Entry access, in insertion order.
+  std::size_t numBits(std::size_t i) const { return lengths[i]; }
+  const std::uint64_t *bits(std::size_t i) const {
+    return keys.data() + i * stride;
+  }
+  std::size_t countAt(std::size_t i) const { return values[i]; }
+  std::size_t &countAt(std::size_t i) { return values[i]; }
+  std::string bitString(std::size_t i) const {
+    return unpackBitString(bits(i), lengths[i]);
+  }
+
+  /// @brief Return the counts keyed by the bit strings.
+  CountsDictionary toMap() const;
+
+  /// @brief Return true if both hold the same counts, in any order.
+  bool operator==(const PackedCounts &other) const;
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+};
+
+/// @brief The PackedShotLog records measurement bit strings in the order they
+/// were observed, packed into words (see packBitString).
+class PackedShotLog {
+private:
+  /// @brief Each entry is its length in bits followed by its words.
+  std::vector<std::uint64_t> data;
+  std::size_t nEntries = 0;
+
+public:
+  void push_back(const std::uint64_t *words, std::size_t nBits);
+  void push_back(std::string_view bitString);
+  void append(const PackedShotLog &other);
+  std::size_t size() const { return nEntries; }
+  bool empty() const { return nEntries == 0; }
+  void clear() {
+    data.clear();
+    nEntries = 0;
+  }
+
+  /// @brief Return the bit strings in the order they were observed.
+  std::vector<std::string> toStrings() const;
+};
+
 /// The ExecutionResult models the result of a typical
 /// quantum state sampling task. It will contain the
 /// observed measurement bit strings and corresponding number
@@ -28,7 +212,7 @@ inline static const std::string GlobalRegisterName = "__global__";
 /// respect to the Z...Z operator.
 struct ExecutionResult {
   // Measurements and times observed
-  CountsDictionary counts;
+  PackedCounts counts;
 
   // <Z...Z> expected value
   std::optional<double> expectationValue = std::nullopt;
@@ -36,14 +220,19 @@ struct ExecutionResult {
   /// Register name for the classicla bits
   std::string registerName = GlobalRegisterName;
 
-  /// @brief Sequential bit strings observed (not collated into a map)
-  std::vector<std::string> sequentialData;
+  /// @brief Sequential bit strings observed (not collated into a map), one
+  /// per appendResult call, if recordSequentialData.
+  PackedShotLog sequentialData;
+
+  /// @brief Record the sequentialData, by default if
+  /// get_record_sequential_data() was true when this was created.
+  bool recordSequentialData = get_record_sequential_data();
 
   /// @brief Serialize this sample result to a vector of integers.
   /// Encoding: 1st element is size of the register name N, then next N
   /// represent register name, next is the number of Bitstrings M,
-  /// then for each bit string a triple {stringMappedToLong, bit string
-  /// length, count}
+  /// then for each bit string {bit string length L, count, packed words}
+  /// with ceil(L / 64) packed words (see packBitString).
   /// @return
   std::vector<std::size_t> serialize();
 
@@ -80,6 +269,9 @@ struct ExecutionResult {
   /// @param other
   ExecutionResult(const ExecutionResult &other);
 
+  /// @brief Move constructor
+  ExecutionResult(ExecutionResult &&other) = default;
+
   /// @brief Set this ExecutionResult equal to the provided one
   /// @param other
   /// @return
@@ -95,7 +287,14 @@ struct ExecutionResult {
   /// @param count
   void appendResult(std::string bitString, std::size_t count);
 
-  std::vector<std::string> getSequentialData() { return sequentialData; }
+  /// @brief Append the packed bit string of nBits bits and count to this
+  /// ExecutionResult.
+  void appendResult(const std::uint64_t *words, std::size_t nBits,
+                    std::size_t count);
+
+  std::vector<std::string> getSequentialData() {
+    return sequentialData.toStrings();
+  }
 };
 
 /// @brief The sample_result abstraction wraps a set of ExecutionResults for
@@ -222,6 +421,11 @@ public:
   CountsDictionary
   to_map(const std::string_view registerName = GlobalRegisterName);
 
+  /// @brief Return the packed counts of the given register, without
+  /// converting the bit strings. Empty if there is no such register.
+  const PackedCounts &
+  packed_counts(const std::string_view registerName = GlobalRegisterName) const;
+
   /// @brief Extract marginal counts, ie those counts for a subset of measured
   /// qubits
   /// @param marginalIndices The qubit indices as an rvalue
@@ -244,27 +448,27 @@ public:
 
   /// @brief Range-based iterator begin function
   /// @return
-  CountsDictionary::iterator begin();
+  PackedCounts::iterator begin();
 
   /// @brief Range-based iterator end function
   /// @return
-  CountsDictionary::iterator end();
+  PackedCounts::iterator end();
 
   /// @brief Range-based const iterator begin function
   /// @return
-  CountsDictionary::const_iterator cbegin() const;
+  PackedCounts::const_iterator cbegin() const;
 
   /// @brief Range-based const iterator end function
   /// @return
-  CountsDictionary::const_iterator cend() const;
+  PackedCounts::const_iterator cend() const;
 
   /// @brief Range-based const iterator begin function
   /// @return
-  CountsDictionary::const_iterator begin() const { return cbegin(); }
+  PackedCounts::const_iterator begin() const { return cbegin(); }
 
   /// @brief Range-based const iterator end function
   /// @return
-  CountsDictionary::const_iterator end() const { return cend(); }
+  PackedCounts::const_iterator end() const { return cend(); }
 };
 
 } // namespace cudaq
@@ -9,9 +9,13 @@
 #include "NoiseModel.h"
 #include "Logger.h"
 #include <Eigen/Dense>
+#include <atomic>
 
 namespace cudaq {
 
+/// @brief The next noise_model version, see noise_model::get_version().
+static std::atomic<std::size_t> nextNoiseModelVersion = 1;
+
 kraus_op &kraus_op::operator=(const kraus_op &other) {
   data = other.data;
   return *this;
@@ -87,6 +91,8 @@ kraus_channel &kraus_channel::operator=(const kraus_channel &other) {
 std::vector<kraus_op> kraus_channel::get_ops() { return ops; }
 void kraus_channel::push_back(kraus_op op) { ops.push_back(op); }
 
+noise_model::noise_model() : version(nextNoiseModelVersion++) {}
+
 void noise_model::add_channel(const std::string &quantumOp,
                               const std::vector<std::size_t> &qubits,
                               const kraus_channel &channel) {
@@ -106,6 +112,7 @@ void noise_model::add_channel(const std::string &quantumOp,
         std::to_string(channelDim) + " on " + std::to_string(nQubits) +
         " qubits.");
 
+  version = nextNoiseModelVersion++;
   auto key = std::make_pair(quantumOp, qubits);
   auto iter = noiseModel.find(key);
   if (iter == noiseModel.end()) {
@@ -166,14 +166,23 @@ protected:
   // names to a kraus channel applied after the operation is applied.
   NoiseModelOpMap noiseModel;
 
+  /// @brief Identifier of the current contents of this noise model.
+  std::size_t version;
+
 public:
   /// @brief default constructor
-  noise_model() = default;
+  noise_model();
 
   /// @brief Return true if there are no kraus_channels in this noise model.
   /// @return
   bool empty() const { return noiseModel.empty(); }
 
+  /// @brief Return an identifier of the contents of this noise model. It is
+  /// unique across noise models, changes whenever a kraus_channel is added,
+  /// and is shared by copies. Simulators use it to cache data derived from
+  /// the noise model.
+  std::size_t get_version() const { return version; }
+
   /// @brief Add the Kraus channel to the specified one-qubit quantum
   /// operation. It applies to the quantumOp operation for the specified
   /// qubits in the kraus_channel.
@@ -0,0 +1,152 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "ObserveGrouping.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace cudaq {
+
+std::vector<MeasurementGroup> groupQubitWiseCommuting(const spin_op &op) {
+  const auto bsf = op.get_bsf();
+  const std::size_t nQubits = op.n_qubits();
+
+  // Order the non-identity terms by decreasing weight, heavy terms constrain
+  // the groups the most.
+  std::vector<std::size_t> order;
+  std::vector<std::size_t> weights(bsf.size(), 0);
+  for (std::size_t t = 0; t < bsf.size(); t++) {
+    for (std::size_t i = 0; i < nQubits; i++)
+      if (bsf[t][i] || bsf[t][i + nQubits])
+        weights[t]++;
+    if (weights[t] > 0)
+      order.push_back(t);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+    return weights[a] > weights[b];
+  });
+
+  // Greedily add each term to the first group it commutes with qubit-wise.
+  std::vector<std::vector<bool>> groupBases;
+  std::vector<std::vector<std::size_t>> groupTerms;
+  for (auto t : order) {
+    const auto &term = bsf[t];
+    auto commutes = [&](const std::vector<bool> &basis) {
+      for (std::size_t i = 0; i < nQubits; i++) {
+        bool termIsIdentity = !term[i] && !term[i + nQubits];
+        bool basisIsIdentity = !basis[i] && !basis[i + nQubits];
+        if (termIsIdentity || basisIsIdentity)
+          continue;
+        if (term[i] != basis[i] || term[i + nQubits] != basis[i + nQubits])
+          return false;
+      }
+      return true;
+    };
+
+    auto iter = std::find_if(groupBases.begin(), groupBases.end(), commutes);
+    if (iter == groupBases.end()) {
+      groupBases.push_back(term);
+      groupTerms.push_back({t});
+      continue;
+    }
+
+    auto &basis = *iter;
+    for (std::size_t i = 0; i < 2 * nQubits; i++)
+      if (term[i])
+        basis[i] = true;
+    groupTerms[std::distance(groupBases.begin(), iter)].push_back(t);
+  }
+
+  std::vector<MeasurementGroup> groups;
+  groups.reserve(groupBases.size());
+  for (std::size_t g = 0; g < groupBases.size(); g++) {
+    std::vector<std::vector<bool>> basisData{groupBases[g]};
+    std::vector<std::complex<double>> basisCoeffs{1.0};
+    std::sort(groupTerms[g].begin(), groupTerms[g].end());
+    groups.push_back(
+        {spin_op::from_binary_symplectic(basisData, basisCoeffs),
+         std::move(groupTerms[g])});
+  }
+  return groups;
+}
+
+std::vector<std::size_t> getMarginalIndices(const spin_op &basis,
+                                            const spin_op &term) {
+  const auto basisData = basis.get_bsf()[0];
+  const auto termData = term.get_bsf()[0];
+  const std::size_t nQubits = basis.n_qubits();
+  const std::size_t nTermQubits = term.n_qubits();
+
+  std::vector<std::size_t> indices;
+  for (std::size_t i = 0, position = 0; i < nQubits; i++) {
+    if (!basisData[i] && !basisData[i + nQubits])
+      continue;
+    if (i < nTermQubits && (termData[i] || termData[i + nTermQubits]))
+      indices.push_back(position);
+    position++;
+  }
+  return indices;
+}
+
+ExecutionResult marginalizeGroupCounts(const PackedCounts &groupCounts,
+                                       const spin_op &basis,
+                                       const spin_op &term) {
+  const auto indices = getMarginalIndices(basis, term);
+  ExecutionResult result(term.to_string(false));
+  std::size_t totalShots = 0;
+  double parityTotal = 0.0;
+  std::vector<std::uint64_t> bits((indices.size() + 63) / 64);
+  for (std::size_t i = 0; i < groupCounts.size(); i++) {
+    const auto *groupBits = groupCounts.bits(i);
+    auto count = groupCounts.countAt(i);
+    bool odd = false;
+    std::fill(bits.begin(), bits.end(), 0);
+    for (std::size_t j = 0; j < indices.size(); j++) {
+      if ((groupBits[indices[j] / 64] >> (indices[j] % 64)) & 1ULL) {
+        bits[j / 64] |= 1ULL << (j % 64);
+        odd = !odd;
+      }
+    }
+    result.counts.add(bits.data(), indices.size(), count);
+    totalShots += count;
+    parityTotal += odd ? -static_cast<double>(count) : count;
+  }
+
+  result.expectationValue = totalShots ? parityTotal / totalShots : 0.0;
+  return result;
+}
+
+sample_result expandMeasurementGroups(sample_result &data, const spin_op &op) {
+  auto names = data.register_names();
+  std::unordered_set<std::string> registers(names.begin(), names.end());
+  auto groups = groupQubitWiseCommuting(op);
+
+  sample_result expanded(data);
+  for (auto &group : groups) {
+    // A single job is returned under the global register.
+    std::string groupRegister = group.basis.to_string(false);
+    if (!registers.count(groupRegister)) {
+      if (groups.size() != 1 || !registers.count(GlobalRegisterName))
+        continue;
+      groupRegister = GlobalRegisterName;
+    }
+
+    auto &groupCounts = data.packed_counts(groupRegister);
+    for (auto t : group.termIndices) {
+      auto term = op[t];
+      if (registers.count(term.to_string(false)))
+        continue;
+      auto result = marginalizeGroupCounts(groupCounts, group.basis, term);
+      expanded.append(result);
+    }
+  }
+  return expanded;
+}
+
+} // namespace cudaq
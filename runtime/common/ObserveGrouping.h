@@ -0,0 +1,54 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include "MeasureCounts.h"
+#include "cudaq/spin_op.h"
+
+#include <vector>
+
+namespace cudaq {
+
+/// @brief A set of qubit-wise commuting spin_op terms that can be measured
+/// with a single basis change circuit.
+struct MeasurementGroup {
+  /// @brief The measurement basis, a single unit-coefficient term holding the
+  /// non-identity Pauli of every grouped term on each qubit.
+  spin_op basis;
+
+  /// @brief The indices of the grouped terms in the original spin_op.
+  std::vector<std::size_t> termIndices;
+};
+
+/// @brief Partition the non-identity terms of the given spin_op into sets of
+/// qubit-wise commuting terms, i.e. terms that act with the same Pauli (or
+/// the identity) on every qubit. Terms are assigned greedily, heaviest first,
+/// to the first compatible group. The result only depends on the spin_op.
+std::vector<MeasurementGroup> groupQubitWiseCommuting(const spin_op &op);
+
+/// @brief Return the positions of the non-identity qubits of `term` within
+/// the bit strings measured in the `basis` of its group. Bit strings measured
+/// in a basis list the non-identity qubits of the basis in increasing order.
+std::vector<std::size_t> getMarginalIndices(const spin_op &basis,
+                                            const spin_op &term);
+
+/// @brief Return the ExecutionResult of `term`, registered under
+/// `term.to_string(false)`, from the counts measured in the `basis` of its
+/// group. The expectation value is the parity of the marginal counts.
+ExecutionResult marginalizeGroupCounts(const PackedCounts &groupCounts,
+                                       const spin_op &basis,
+                                       const spin_op &term);
+
+/// @brief Expand the registers of a grouped observe execution, each named
+/// `basis.to_string(false)` (or the global register if there was a single
+/// group), into one register per term of `op`. Terms that already have a
+/// register are kept as they are.
+sample_result expandMeasurementGroups(sample_result &data, const spin_op &op);
+
+} // namespace cudaq
@@ -47,6 +47,9 @@ public:
   observe_result(double &&e, spin_op &H, sample_result counts)
       : expValZ(e), spinOp(H), data(counts) {}
 
+  observe_result(double e, const spin_op &H, sample_result counts)
+      : expValZ(e), spinOp(H), data(std::move(counts)) {}
+
   /// @brief Return the raw counts data for all terms
   /// @return
   sample_result raw_data() { return data; };
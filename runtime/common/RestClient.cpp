@@ -8,29 +8,52 @@
 
 #include "RestClient.h"
 #include "Logger.h"
+#include <algorithm>
+#include <atomic>
 #include <cpr/cpr.h>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace cudaq {
 constexpr long validHttpCode = 205;
 
-nlohmann::json RestClient::post(const std::string_view remoteUrl,
-                                const std::string_view path,
-                                nlohmann::json &post,
-                                std::map<std::string, std::string> &headers) {
-  if (headers.empty())
-    headers.insert(std::make_pair("Content-type", "application/json"));
+/// @brief Return the HTTP session of the calling thread for POST or for GET
+/// requests. Reusing them keeps the connections to the server open between
+/// requests. The GET requests have their own session, otherwise cpr would
+/// send them as custom requests that carry the body of the last POST.
+static cpr::Session &getSession(bool forPost) {
+  thread_local cpr::Session postSession, getSession;
+  return forPost ? postSession : getSession;
+}
 
+static cpr::Header toCprHeaders(std::map<std::string, std::string> &headers) {
   cpr::Header cprHeaders;
+  if (headers.empty())
+    cprHeaders.insert({"Content-type", "application/json"});
   for (auto &kv : headers)
     cprHeaders.insert({kv.first, kv.second});
+  return cprHeaders;
+}
 
+nlohmann::json RestClient::post(const std::string_view remoteUrl,
+                                const std::string_view path,
+                                nlohmann::json &post,
+                                std::map<std::string, std::string> &headers) {
   cudaq::info("Posting to {}/{} with data = {}", remoteUrl, path, post.dump());
 
   auto actualPath = std::string(remoteUrl) + std::string(path);
-  auto r = cpr::Post(cpr::Url{actualPath}, cpr::Body(post.dump()), cprHeaders,
-                     cpr::VerifySsl(false));
+  auto &session = getSession(/*forPost=*/true);
+  session.SetUrl(cpr::Url{actualPath});
+  session.SetHeader(toCprHeaders(headers));
+  session.SetBody(cpr::Body(post.dump()));
+  session.SetVerifySsl(cpr::VerifySsl(false));
+  session.SetTimeout(cpr::Timeout(timeout));
+  auto r = session.Post();
 
-  if (r.status_code > validHttpCode)
+  if (r.error || r.status_code > validHttpCode)
     throw std::runtime_error("HTTP POST Error - status code " +
                              std::to_string(r.status_code) + ": " +
                              r.error.message + ": " + r.text);
@@ -41,19 +64,76 @@ nlohmann::json RestClient::post(const std::string_view remoteUrl,
 nlohmann::json RestClient::get(const std::string_view remoteUrl,
                                const std::string_view path,
                                std::map<std::string, std::string> &headers) {
-  if (headers.empty())
-    headers.insert(std::make_pair("Content-type", "application/json"));
-
-  cpr::Header cprHeaders;
-  for (auto &kv : headers)
-    cprHeaders.insert({kv.first, kv.second});
-
-  cpr::Parameters cprParams;
   auto actualPath = std::string(remoteUrl) + std::string(path);
-  auto r = cpr::Get(cpr::Url{actualPath}, cprHeaders, cprParams,
-                    cpr::VerifySsl(false));
+  auto &session = getSession(/*forPost=*/false);
+  session.SetUrl(cpr::Url{actualPath});
+  session.SetHeader(toCprHeaders(headers));
+  session.SetParameters(cpr::Parameters{});
+  session.SetVerifySsl(cpr::VerifySsl(false));
+  session.SetTimeout(cpr::Timeout(timeout));
+  auto r = session.Get();
+
+  if (r.error || r.status_code > validHttpCode)
+    throw std::runtime_error("HTTP GET Error - status code " +
+                             std::to_string(r.status_code) + ": " +
+                             r.error.message + ": " + r.text);
 
   return nlohmann::json::parse(r.text);
 }
 
+std::size_t getMaxRestRequestsInFlight() {
+  std::size_t maxInFlight = 8;
+  if (auto *envVal = std::getenv("CUDAQ_REST_MAX_IN_FLIGHT")) {
+    try {
+      maxInFlight = std::stoul(envVal);
+    } catch (...) {
+      throw std::runtime_error("Invalid CUDAQ_REST_MAX_IN_FLIGHT environment "
+                               "variable, must be integer.");
+    }
+    if (maxInFlight < 1)
+      throw std::runtime_error("Invalid CUDAQ_REST_MAX_IN_FLIGHT environment "
+                               "variable, must be positive.");
+  }
+  return maxInFlight;
+}
+
+void runConcurrentRequests(std::size_t nTasks, std::size_t maxInFlight,
+                           const std::function<void(std::size_t)> &task) {
+  std::size_t nThreads =
+      std::min(nTasks, std::max<std::size_t>(maxInFlight, 1));
+  if (nThreads < 2) {
+    for (std::size_t i = 0; i < nTasks; i++)
+      task(i);
+    return;
+  }
+
+  // Every thread takes the next task as soon as its last one finished, so a
+  // slow request does not hold back the others.
+  std::atomic<std::size_t> next = 0;
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto worker = [&]() {
+    for (std::size_t i = next++; i < nTasks; i = next++) {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+        next = nTasks;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < nThreads; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
 } // namespace cudaq
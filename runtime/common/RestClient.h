@@ -8,6 +8,8 @@
 
 #pragma once
 #include "nlohmann/json.hpp"
+#include <chrono>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -15,16 +17,25 @@ namespace cudaq {
 
 /// @brief The RestClient exposes a simple REST GET/POST
 /// interface for interacting with remote REST servers.
+///
+/// Requests reuse one HTTP session (and its open connections) per thread, so
+/// a RestClient can be shared by concurrent requests.
 class RestClient {
 protected:
   // Use verbose printout
   bool verbose = false;
 
+  /// @brief The timeout of a single request, zero waits forever.
+  std::chrono::milliseconds timeout{60000};
+
 public:
   /// @brief set verbose printout
   /// @param v
   void setVerbose(bool v) { verbose = v; }
 
+  /// @brief Set the timeout of a single request, zero waits forever.
+  void setTimeout(std::chrono::milliseconds t) { timeout = t; }
+
   /// Post the message to the remote path at the provided URL.
   nlohmann::json post(const std::string_view remoteUrl,
                       const std::string_view path, nlohmann::json &postStr,
@@ -36,4 +47,15 @@ public:
 
   ~RestClient() = default;
 };
+
+/// @brief Return the maximum number of REST requests (job posts, job polls)
+/// in flight at once, CUDAQ_REST_MAX_IN_FLIGHT (default 8).
+std::size_t getMaxRestRequestsInFlight();
+
+/// @brief Run task(i) for every i in [0, nTasks) on up to maxInFlight
+/// threads, in no particular order. Each task is expected to block on the
+/// network. The first exception thrown by a task is rethrown here, after the
+/// tasks already started have finished.
+void runConcurrentRequests(std::size_t nTasks, std::size_t maxInFlight,
+                           const std::function<void(std::size_t)> &task);
 } // namespace cudaq
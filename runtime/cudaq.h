@@ -190,6 +190,11 @@ void unset_noise();
 /// @brief Utility function for clearing the shots
 void clear_shots(const std::size_t nShots);
 
+/// @brief Seed the simulator random number generators, so that sampling
+/// results are reproducible. Each subsequent execution draws its seed (one
+/// per worker thread for parallel shots) from a generator seeded with this.
+void set_random_seed(std::size_t seed);
+
 } // namespace cudaq
 
 // Users should get sample by default
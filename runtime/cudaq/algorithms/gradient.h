@@ -43,6 +43,32 @@ protected:
     return cudaq::observe(ansatz_functor, h, x);
   }
 
+  // Given a batch of parameter sets and the spin_op h, compute the expected
+  // value at each of them. If the platform exposes more than one QPU, the
+  // batch is submitted up front with observe_async, round-robin across the
+  // QPUs, and the results are gathered at the end.
+  std::vector<double>
+  getExpectedValues(const std::vector<std::vector<double>> &xs, spin_op h) {
+    std::vector<double> results;
+    results.reserve(xs.size());
+    auto &platform = cudaq::get_platform();
+    const auto nQpus = platform.num_qpus();
+    if (nQpus < 2 || xs.size() < 2) {
+      for (auto x : xs)
+        results.push_back(getExpectedValue(x, h));
+      return results;
+    }
+
+    std::vector<async_observe_result> asyncResults;
+    asyncResults.reserve(xs.size());
+    for (std::size_t i = 0; i < xs.size(); i++)
+      asyncResults.emplace_back(
+          cudaq::observe_async(i % nQpus, ansatz_functor, h, xs[i]));
+    for (auto &asyncResult : asyncResults)
+      results.push_back(asyncResult.get().exp_val_z());
+    return results;
+  }
+
 public:
   /// Constructor, takes the quantum kernel with prescribed signature
   gradient(std::function<void(std::vector<double>)> &&kernel)
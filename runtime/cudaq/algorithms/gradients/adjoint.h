@@ -0,0 +1,94 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include "cudaq/algorithms/gradient.h"
+#include "cudaq/platform.h"
+
+namespace cudaq::gradients {
+
+/// @brief The adjoint gradient computes all the parameter derivatives of
+/// <psi(x) | H | psi(x)> from a single forward simulation and a reverse
+/// sweep over the recorded gates, instead of two observe calls per
+/// parameter. It requires a state vector simulator and a kernel without
+/// measurements or noise.
+///
+/// The simulator returns the derivative with respect to each gate rotation
+/// angle. These are mapped onto the kernel parameters with the Jacobian of
+/// the angles, which is computed by central differences over runs that only
+/// record the gate angles. These runs neither allocate nor simulate the
+/// state, so they cost as much as the classical part of the kernel.
+class adjoint : public gradient {
+protected:
+  /// @brief Run the kernel under the given execution context.
+  void runWithContext(ExecutionContext &context, std::vector<double> x) {
+    auto &platform = cudaq::get_platform();
+    if (!platform.is_simulator())
+      throw std::runtime_error(
+          "The adjoint gradient is only supported in simulation.");
+    platform.set_exec_ctx(&context);
+    ansatz_functor(x);
+    platform.reset_exec_ctx();
+  }
+
+  /// @brief Return the gate rotation angles of the kernel at x.
+  std::vector<double> getGateParameters(const std::vector<double> &x) {
+    ExecutionContext context("gate-parameters");
+    runWithContext(context, x);
+    return context.gateParameters;
+  }
+
+public:
+  using gradient::gradient;
+
+  /// @brief The step used to differentiate the gate angles with respect to
+  /// the kernel parameters. Angles that are affine in the parameters, the
+  /// common case, are differentiated exactly.
+  double step = 1e-4;
+
+  void compute(const std::vector<double> &x, std::vector<double> &dx,
+               spin_op &h, double exp_h) override {
+    ExecutionContext context("adjoint-gradient");
+    context.spin = &h;
+    runWithContext(context, x);
+    const auto &angles = context.gateParameters;
+    const auto &angleGradients = context.gateParameterGradients;
+
+    auto tmpX = x;
+    for (std::size_t i = 0; i < x.size(); i++) {
+      // Gate angles at x_i + step and x_i - step.
+      tmpX[i] += step;
+      auto pAngles = getGateParameters(tmpX);
+      tmpX[i] -= 2 * step;
+      auto mAngles = getGateParameters(tmpX);
+      tmpX[i] += step;
+      if (pAngles.size() != angles.size() || mAngles.size() != angles.size())
+        throw std::runtime_error("The adjoint gradient requires the kernel to "
+                                 "apply the same gates for all parameters.");
+
+      // Chain rule, dE / dx_i = sum_k dE / dangle_k * dangle_k / dx_i.
+      dx[i] = 0.0;
+      for (std::size_t k = 0; k < angles.size(); k++)
+        if (pAngles[k] != mAngles[k])
+          dx[i] +=
+              angleGradients[k] * (pAngles[k] - mAngles[k]) / (2. * step);
+    }
+  }
+
+  /// @brief The adjoint method differentiates an observable of the kernel
+  /// state, it can not be applied to an arbitrary function.
+  std::vector<double>
+  compute(const std::vector<double> &x,
+          std::function<double(std::vector<double>)> &func) override {
+    throw std::runtime_error(
+        "The adjoint gradient requires a kernel and a cudaq::spin_op, it "
+        "can not differentiate an arbitrary function.");
+  }
+};
+} // namespace cudaq::gradients
@@ -19,18 +19,17 @@ public:
 
   void compute(const std::vector<double> &x, std::vector<double> &dx,
                spin_op &h, double exp_h) override {
-    auto tmpX = x;
+    // Build all the shifted parameter sets, x_i + dx_i and x_i - dx_i, and
+    // evaluate them as a single batch.
+    std::vector<std::vector<double>> shiftedX(2 * x.size(), x);
     for (std::size_t i = 0; i < x.size(); i++) {
-      // increase value to x_i + dx_i
-      tmpX[i] += step;
-      auto px = getExpectedValue(tmpX, h);
-      // decrease the value to x_i - dx_i
-      tmpX[i] -= 2 * step;
-      auto mx = getExpectedValue(tmpX, h);
-      // return value back to x_i
-      tmpX[i] += step;
-      dx[i] = (px - mx) / (2. * step);
+      shiftedX[2 * i][i] += step;
+      shiftedX[2 * i + 1][i] -= step;
     }
+
+    auto values = getExpectedValues(shiftedX, h);
+    for (std::size_t i = 0; i < x.size(); i++)
+      dx[i] = (values[2 * i] - values[2 * i + 1]) / (2. * step);
   }
 
   /// @brief Compute the `central_difference` gradient for the arbitary
@@ -11,6 +11,7 @@
 #include <cudaq/spin_op.h>
 
 #include <functional>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -34,6 +35,28 @@ concept ObserveCallValid =
 
 namespace details {
 
+/// @brief Return the expectation value of h after a kernel execution under
+/// the given "observe" context. It is either computed by the backend, or
+/// computed here from the measurement counts of each term.
+inline double getExpectationValue(ExecutionContext &ctx, cudaq::spin_op &h) {
+  // It is possible for the expectation value to be
+  // pre computed, if so grab it and set it so the client gets it
+  if (ctx.expectationValue.has_value())
+    return ctx.expectationValue.value_or(0.0);
+
+  // If not, we have everything we need to compute it.
+  double sum = 0.0;
+  for (std::size_t i = 0; i < h.n_terms(); i++) {
+    auto term = h[i];
+    if (term.is_identity())
+      sum += term.get_coefficients()[0].real();
+    else
+      sum += ctx.result.exp_val_z(term.to_string(false)) *
+             term.get_coefficients()[0].real();
+  }
+  return sum;
+}
+
 /// @brief Take the input KernelFunctor (a lambda that captures runtime args and
 /// invokes the quantum kernel) and invoke the spin_op observation process.
 template <typename KernelFunctor>
@@ -44,13 +67,13 @@ runObservation(KernelFunctor &&k, cudaq::spin_op &h, quantum_platform &platform,
   auto ctx = std::make_unique<ExecutionContext>("observe", shots);
   ctx->kernelName = kernelName;
   ctx->spin = &h;
+  ctx->randomSeed = cudaq::getNextRandomSeed();
   if (shots > 0)
     ctx->shots = shots;
 
   // Indicate that this is an async exec
   ctx->asyncExec = futureResult != nullptr;
 
-  platform.set_current_qpu(qpu_id);
   platform.set_exec_ctx(ctx.get(), qpu_id);
 
   k();
@@ -65,29 +88,53 @@ runObservation(KernelFunctor &&k, cudaq::spin_op &h, quantum_platform &platform,
   platform.reset_exec_ctx(qpu_id);
 
   // Extract the results
-  sample_result data;
-  double expectationValue;
-  data = ctx->result;
+  double expectationValue = getExpectationValue(*ctx, h);
+  return observe_result(expectationValue, h, ctx->result);
+}
 
-  // It is possible for the expectation value to be
-  // pre computed, if so grab it and set it so the client gets it
-  if (ctx->expectationValue.has_value())
-    expectationValue = ctx->expectationValue.value_or(0.0);
-  else {
-    // If not, we have everything we need to compute it.
-    double sum = 0.0;
-    for (std::size_t i = 0; i < h.n_terms(); i++) {
-      auto term = h[i];
-      if (term.is_identity())
-        sum += term.get_coefficients()[0].real();
-      else
-        sum += data.exp_val_z(term.to_string(false)) *
-               term.get_coefficients()[0].real();
-    }
-    expectationValue = sum;
+/// @brief Run the observation of the argument sets [begin, end) back to back
+/// on one execution context and QPU, launch(i) invokes the kernel with the
+/// argument set i. The expectation values are written to results[i].
+template <typename KernelLauncher>
+void runObservationBatch(KernelLauncher &&launch, cudaq::spin_op &h,
+                         quantum_platform &platform, int shots,
+                         const std::string &kernelName, std::size_t qpu_id,
+                         std::size_t begin, std::size_t end,
+                         std::vector<double> &results) {
+  ExecutionContext ctx("observe", shots);
+  ctx.kernelName = kernelName;
+  ctx.spin = &h;
+
+  for (std::size_t i = begin; i < end; i++) {
+    ctx.result.clear();
+    ctx.expectationValue = std::nullopt;
+    ctx.randomSeed = cudaq::getNextRandomSeed();
+    platform.set_exec_ctx(&ctx, qpu_id);
+    launch(i);
+    platform.reset_exec_ctx(qpu_id);
+    results[i] = getExpectationValue(ctx, h);
   }
+}
+
+/// @brief Observe the batch of nSets argument sets, spread over the platform
+/// QPUs, launch(i) invokes the kernel with the argument set i.
+template <typename QuantumKernel, typename KernelLauncher>
+std::vector<double> observeBatch(QuantumKernel &kernel, spin_op &H,
+                                 std::size_t nSets, KernelLauncher &&launch) {
+  // JIT compile builder kernels once, before the QPU threads invoke them.
+  if constexpr (has_name<QuantumKernel>::value)
+    static_cast<cudaq::details::kernel_builder_base &>(kernel).jitCode();
 
-  return observe_result(expectationValue, h, data);
+  auto &platform = cudaq::get_platform();
+  auto shots = platform.get_shots().value_or(-1);
+  auto kernelName = cudaq::getKernelName(kernel);
+  std::vector<double> results(nSets);
+  platform.runBatch(nSets, [&](std::size_t qpu_id, std::size_t begin,
+                               std::size_t end) {
+    runObservationBatch(launch, H, platform, shots, kernelName, qpu_id, begin,
+                        end, results);
+  });
+  return results;
 }
 
 /// @brief Take the input KernelFunctor (a lambda that captures runtime args and
@@ -294,6 +341,58 @@ observe_result observe(std::size_t shots, QuantumKernel &&kernel, spin_op H,
       .value();
 }
 
+///
+/// \brief Compute the expected value of \p H with respect to kernel(Args...)
+/// for each of the given argument sets.
+///
+/// \param kernel The instantiated ansatz callable, a CUDA Quantum kernel,
+///         cannot contain measure statements.
+/// \param H The hermitian cudaq::spin_op to compute the expected value for.
+/// \param argSets The concrete arguments of each kernel evaluation.
+/// \returns The expected values, one per argument set.
+///
+/// \details The argument sets run back to back on one execution context, so
+///          the per-call overhead of observe (context setup, simulator state
+///          allocation) is paid once per QPU rather than once per set. On a
+///          multi-QPU platform the batch is split over all QPUs.
+///
+/// Usage:
+/// \code{.cpp}
+/// std::vector<std::tuple<double>> scan;
+/// for (double theta = 0.; theta < M_PI; theta += .1)
+///   scan.emplace_back(theta);
+/// auto energies = cudaq::observe_batch(ansatz{}, H, scan);
+/// \endcode
+///
+template <typename QuantumKernel, typename... Args>
+  requires ObserveCallValid<QuantumKernel, Args...>
+std::vector<double>
+observe_batch(QuantumKernel &&kernel, spin_op H,
+              const std::vector<std::tuple<Args...>> &argSets) {
+  return details::observeBatch(kernel, H, argSets.size(), [&](std::size_t i) {
+    std::apply(kernel, argSets[i]);
+  });
+}
+
+///
+/// \brief Compute the expected value of \p H with respect to kernel(arg) for
+/// each of the given arguments, for kernels with a single argument (e.g. a
+/// std::vector<double> of parameters).
+///
+/// \param kernel The instantiated ansatz callable, a CUDA Quantum kernel,
+///         cannot contain measure statements.
+/// \param H The hermitian cudaq::spin_op to compute the expected value for.
+/// \param argSets The concrete argument of each kernel evaluation.
+/// \returns The expected values, one per argument.
+///
+template <typename QuantumKernel, typename Arg>
+  requires ObserveCallValid<QuantumKernel, Arg>
+std::vector<double> observe_batch(QuantumKernel &&kernel, spin_op H,
+                                  const std::vector<Arg> &argSets) {
+  return details::observeBatch(kernel, H, argSets.size(),
+                               [&](std::size_t i) { kernel(argSets[i]); });
+}
+
 ///
 /// \brief Asynchronously compute the expected value of \p H with respect to
 /// kernel(Args...).
@@ -12,6 +12,10 @@
 #include "common/MeasureCounts.h"
 #include "cudaq/concepts.h"
 #include "cudaq/platform.h"
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <tuple>
 
 namespace cudaq {
 bool kernelHasConditionalFeedback(const std::string &);
@@ -28,6 +32,23 @@ concept SampleCallValid =
 
 namespace details {
 
+/// @brief The number of shots of conditional feedback emulation that are
+/// seeded together. Seeding blocks of shots rather than worker threads keeps
+/// the counts independent of the number of workers.
+inline constexpr std::size_t feedbackShotBlockSize = 64;
+
+/// @brief Return the number of worker threads that emulate conditional
+/// feedback shot by shot, at most nBlocks. Every worker holds a full
+/// simulator state, so the shots only run on CUDAQ_SHOT_THREADS workers if
+/// it is set, and on the calling thread otherwise.
+inline std::size_t getNumShotWorkers(std::size_t nBlocks) {
+  std::size_t nWorkers = 1;
+  if (auto *envVal = std::getenv("CUDAQ_SHOT_THREADS"))
+    nWorkers = std::strtoul(envVal, nullptr, 10);
+  return std::clamp<std::size_t>(nWorkers, 1,
+                                 std::max<std::size_t>(nBlocks, 1));
+}
+
 /// @brief Take the input KernelFunctor (a lambda that captures runtime args and
 /// invokes the quantum kernel) and invoke the sampling process.
 template <typename KernelFunctor>
@@ -38,6 +59,7 @@ runSampling(KernelFunctor &&wrappedKernel, quantum_platform &platform,
   // Create the execution context.
   auto ctx = std::make_unique<ExecutionContext>("sample", shots);
   ctx->kernelName = kernelName;
+  ctx->randomSeed = cudaq::getNextRandomSeed();
 
   // Tell the context if this quantum kernel has
   // conditionals on measure results
@@ -47,9 +69,8 @@ runSampling(KernelFunctor &&wrappedKernel, quantum_platform &platform,
   // Indicate that this is an async exec
   ctx->asyncExec = futureResult != nullptr;
 
-  // Set the platform and the qpu id.
+  // Set the execution context on the qpu.
   platform.set_exec_ctx(ctx.get(), qpu_id);
-  platform.set_current_qpu(qpu_id);
   auto hasCondFeedback = platform.supports_conditional_feedback();
 
   // If no conditionals, nothing special to do for library mode
@@ -71,24 +92,72 @@ runSampling(KernelFunctor &&wrappedKernel, quantum_platform &platform,
   // If the execution backend does not support
   // sampling with cond feedback, we'll emulate it here
   if (!hasCondFeedback) {
-    sample_result counts;
-
-    // If it has conditionals, loop over individual circuit executions
-    for (auto &i : cudaq::range(shots)) {
-      // Run the kernel
-      wrappedKernel();
-      // Reset the context and get the single measure result,
-      // add it to the sample_result and clear the context result
-      platform.reset_exec_ctx(qpu_id);
-      counts += ctx->result;
-      ctx->result.clear();
-      // Reset the context for the next round,
-      // don't need to reset on the last exec
-      if (i < static_cast<unsigned>(shots) - 1)
-        platform.set_exec_ctx(ctx.get(), qpu_id);
-    }
-
-    return counts;
+    // The shots are independent full kernel executions, split them in
+    // blocks over worker threads (this thread being worker 0), each with its
+    // own context and thread_local platform and simulator. The platform of a
+    // worker thread is a fresh default platform, so only split the shots
+    // when the caller runs on the default single simulated QPU.
+    std::size_t nBlocks =
+        (shots + feedbackShotBlockSize - 1) / feedbackShotBlockSize;
+    std::size_t nWorkers = 1;
+    using Functor = std::decay_t<KernelFunctor>;
+    if constexpr (std::is_copy_constructible_v<Functor>)
+      if (platform.name() == "default" && platform.num_qpus() == 1 &&
+          !platform.is_remote(qpu_id) && platform.is_simulator(qpu_id))
+        nWorkers = getNumShotWorkers(nBlocks);
+    std::vector<Functor> kernels;
+    if constexpr (std::is_copy_constructible_v<Functor>)
+      for (std::size_t worker = 1; worker < nWorkers; worker++)
+        kernels.emplace_back(wrappedKernel);
+    std::vector<sample_result> counts(nWorkers);
+    std::vector<std::exception_ptr> errors(nWorkers);
+    auto baseSeed = ctx->randomSeed;
+
+    details::runOnWorkerThreads(nWorkers, [&](std::size_t worker) {
+      try {
+        // Worker 0 uses the calling thread's platform and context.
+        auto &workerPlatform = worker ? cudaq::get_platform() : platform;
+        auto workerQpu = worker ? 0 : qpu_id;
+        ExecutionContext workerCtx("sample", shots);
+        workerCtx.kernelName = kernelName;
+        workerCtx.hasConditionalsOnMeasureResults = true;
+        workerCtx.noiseModel = ctx->noiseModel;
+        auto &context = worker ? workerCtx : *ctx;
+        auto &kernel = worker ? kernels[worker - 1] : wrappedKernel;
+
+        for (std::size_t block = worker; block < nBlocks; block += nWorkers) {
+          std::size_t begin = block * feedbackShotBlockSize;
+          std::size_t end =
+              std::min<std::size_t>(begin + feedbackShotBlockSize, shots);
+          for (std::size_t i = begin; i < end; i++) {
+            // Seed the first shot of every block from the block index.
+            if (i == begin && baseSeed)
+              context.randomSeed =
+                  *baseSeed + block * 0x9e3779b97f4a7c15ULL;
+            // The caller already set the context of the first shot.
+            if (i)
+              workerPlatform.set_exec_ctx(&context, workerQpu);
+            // Run the kernel
+            kernel();
+            // Reset the context and get the single measure result,
+            // add it to the sample_result and clear the context result
+            workerPlatform.reset_exec_ctx(workerQpu);
+            counts[worker] += context.result;
+            context.result.clear();
+            context.randomSeed.reset();
+          }
+        }
+      } catch (...) {
+        errors[worker] = std::current_exception();
+      }
+    });
+
+    for (auto &error : errors)
+      if (error)
+        std::rethrow_exception(error);
+    for (std::size_t worker = 1; worker < nWorkers; worker++)
+      counts[0] += counts[worker];
+    return counts[0];
   }
 
   // At this point, the kernel has conditional
@@ -105,6 +174,60 @@ runSampling(KernelFunctor &&wrappedKernel, quantum_platform &platform,
   return ctx->result;
 }
 
+/// @brief Sample the argument sets [begin, end) back to back on one execution
+/// context and QPU, launch(i) invokes the kernel with the argument set i. The
+/// counts are written to results[i].
+template <typename KernelLauncher>
+void runSamplingBatch(KernelLauncher &&launch, quantum_platform &platform,
+                      const std::string &kernelName, int shots,
+                      std::size_t qpu_id, std::size_t begin, std::size_t end,
+                      std::vector<sample_result> &results) {
+  ExecutionContext ctx("sample", shots);
+  ctx.kernelName = kernelName;
+  ctx.hasConditionalsOnMeasureResults =
+      cudaq::kernelHasConditionalFeedback(kernelName);
+
+  for (std::size_t i = begin; i < end; i++) {
+    // Kernels with conditional feedback may need shot by shot execution.
+    if (ctx.hasConditionalsOnMeasureResults) {
+      results[i] = runSampling([&]() { launch(i); }, platform, kernelName,
+                               shots, qpu_id)
+                       .value();
+      continue;
+    }
+
+    ctx.result.clear();
+    ctx.randomSeed = cudaq::getNextRandomSeed();
+    platform.set_exec_ctx(&ctx, qpu_id);
+    launch(i);
+    platform.reset_exec_ctx(qpu_id);
+    results[i] = std::move(ctx.result);
+  }
+}
+
+/// @brief Sample the batch of nSets argument sets, spread over the platform
+/// QPUs, launch(i) invokes the kernel with the argument set i.
+template <typename QuantumKernel, typename KernelLauncher>
+std::vector<sample_result> sampleBatch(QuantumKernel &kernel,
+                                       std::size_t nSets,
+                                       KernelLauncher &&launch) {
+  // Need the code to be lowered to llvm and the kernel to be registered
+  // so that we can check for conditional feedback / mid circ measurement
+  if constexpr (has_name<QuantumKernel>::value)
+    static_cast<cudaq::details::kernel_builder_base &>(kernel).jitCode();
+
+  auto &platform = cudaq::get_platform();
+  auto shots = platform.get_shots().value_or(1000);
+  auto kernelName = cudaq::getKernelName(kernel);
+  std::vector<sample_result> results(nSets);
+  platform.runBatch(nSets, [&](std::size_t qpu_id, std::size_t begin,
+                               std::size_t end) {
+    runSamplingBatch(launch, platform, kernelName, shots, qpu_id, begin, end,
+                     results);
+  });
+  return results;
+}
+
 /// @brief Take the input KernelFunctor (a lambda that captures runtime args and
 /// invokes the quantum kernel) and invoke the sampling process asynchronously.
 /// Return a async_sample_result, clients can retrieve the results at a later
@@ -208,6 +331,39 @@ auto sample(std::size_t shots, QuantumKernel &&kernel, Args &&...args) {
       .value();
 }
 
+/// \brief Sample the given quantum kernel expression for each of the given
+/// argument sets.
+///
+/// \param kernel the kernel expression, must contain final measurements
+/// \param argSets the concrete arguments of each kernel evaluation.
+/// \returns The counts dictionaries, one per argument set.
+///
+/// \details The argument sets run back to back on one execution context, and
+///          on a multi-QPU platform the batch is split over all QPUs.
+template <typename QuantumKernel, typename... Args>
+  requires SampleCallValid<QuantumKernel, Args...>
+std::vector<sample_result>
+sample_batch(QuantumKernel &&kernel,
+             const std::vector<std::tuple<Args...>> &argSets) {
+  return details::sampleBatch(kernel, argSets.size(), [&](std::size_t i) {
+    std::apply(kernel, argSets[i]);
+  });
+}
+
+/// \brief Sample the given quantum kernel expression for each of the given
+/// arguments, for kernels with a single argument.
+///
+/// \param kernel the kernel expression, must contain final measurements
+/// \param argSets the concrete argument of each kernel evaluation.
+/// \returns The counts dictionaries, one per argument.
+template <typename QuantumKernel, typename Arg>
+  requires SampleCallValid<QuantumKernel, Arg>
+std::vector<sample_result> sample_batch(QuantumKernel &&kernel,
+                                        const std::vector<Arg> &argSets) {
+  return details::sampleBatch(kernel, argSets.size(),
+                              [&](std::size_t i) { kernel(argSets[i]); });
+}
+
 /// \brief Sample the given kernel expression asynchronously and return
 /// the mapping of observed bit strings to corresponding number of
 /// times observed.
@@ -14,10 +14,11 @@ namespace cudaq {
 
 void state::dump() { dump(std::cout); }
 void state::dump(std::ostream &os) {
-  auto &[shape, stateData] = data;
+  auto &shape = data.getShape();
+  auto *stateData = data.data();
   if (shape.size() == 1) {
-    for (auto &d : stateData)
-      os << d.real() << " ";
+    for (std::size_t i = 0; i < shape[0]; i++)
+      os << stateData[i].real() << " ";
     os << "\n";
   } else {
     for (std::size_t i = 0; i < shape[0]; i++) {
@@ -29,41 +30,40 @@ void state::dump(std::ostream &os) {
   }
 }
 std::complex<double> state::operator[](std::size_t idx) {
-  auto &[shape, stateData] = data;
-  if (shape.size() != 1)
+  if (data.getShape().size() != 1)
     throw std::runtime_error("Cannot request 1-d index into density matrix. "
                              "Must be a state vector.");
-  return stateData[idx];
+  return data.data()[idx];
 }
 
 std::complex<double> state::operator()(std::size_t idx, std::size_t jdx) {
-  auto &[shape, stateData] = data;
+  auto &shape = data.getShape();
 
   if (shape.size() != 2)
     throw std::runtime_error("Cannot request 2-d index into state vector. "
                              "Must be a density matrix.");
 
-  return stateData[idx * std::get<0>(data)[0] + jdx];
+  return data.data()[idx * shape[0] + jdx];
 }
 
 double state::overlap(state &other) {
   double sum = 0.0;
-  auto &[shape, stateData] = data;
-  if (shape.size() != std::get<0>(other.data).size())
+  auto &shape = data.getShape();
+  if (shape.size() != other.get_shape().size())
     throw std::runtime_error(
         "Cannot compare state vectors and density matrices.");
 
   if (shape.size() == 1) {
-    for (std::size_t i = 0; i < std::get<1>(data).size(); i++) {
-      sum += std::abs(std::get<1>(data)[i] * other[i]);
+    for (std::size_t i = 0; i < data.size(); i++) {
+      sum += std::abs(data.data()[i] * other[i]);
     }
   } else {
 
     // Create rho and sigma matrices
     Eigen::MatrixXcd rho =
-        Eigen::Map<Eigen::MatrixXcd>(stateData.data(), shape[0], shape[1]);
-    Eigen::MatrixXcd sigma = Eigen::Map<Eigen::MatrixXcd>(
-        std::get<1>(other.data).data(), shape[0], shape[1]);
+        Eigen::Map<Eigen::MatrixXcd>(data.data(), shape[0], shape[1]);
+    Eigen::MatrixXcd sigma =
+        Eigen::Map<Eigen::MatrixXcd>(other.get_data(), shape[0], shape[1]);
 
     // For qubit systems, F(rho,sigma) = tr(rho*sigma) + 2 *
     // sqrt(det(rho)*det(sigma))
@@ -24,8 +24,16 @@ private:
   State data;
 
 public:
-  /// @brief The constructor, takes the simulation data
-  state(State d) : data(d) {}
+  /// @brief The constructor, takes the simulation data. Copies of the state
+  /// share the data buffer.
+  state(State d) : data(std::move(d)) {}
+
+  /// @brief Return the shape of the data, (n) for a state vector or (n,n)
+  /// for a density matrix.
+  const std::vector<std::size_t> &get_shape() const { return data.getShape(); }
+
+  /// @brief Return the row-major data, without copying it.
+  std::complex<double> *get_data() const { return data.data(); }
 
   /// @brief Return the data element at the given indices
   std::complex<double> operator[](std::size_t idx);
@@ -63,8 +71,8 @@ state extractState(KernelFunctor &&kernel) {
   kernel();
   platform.reset_exec_ctx();
 
-  // Return the state data.
-  return state(context.simulationData);
+  // Return the state data, handing its buffer over.
+  return state(std::move(context.simulationData));
 }
 } // namespace details
 
@@ -0,0 +1,425 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "KernelJIT.h"
+#include "common/Logger.h"
+#include "mlir/ExecutionEngine/OptUtils.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <tuple>
+
+namespace fs = std::filesystem;
+
+namespace cudaq {
+
+JITEngine::JITEngine(std::unique_ptr<llvm::orc::LLJIT> jit)
+    : jit(std::move(jit)) {}
+
+JITEngine::~JITEngine() = default;
+
+std::unique_ptr<JITEngine>
+JITEngine::create(llvm::StringRef objectCode,
+                  const std::vector<std::string> &sharedLibPaths) {
+  auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!jtmb)
+    throw std::runtime_error("cudaq::builder failed to detect the host: " +
+                             llvm::toString(jtmb.takeError()));
+
+  auto jit = llvm::orc::LLJITBuilder()
+                 .setJITTargetMachineBuilder(std::move(*jtmb))
+                 .create();
+  if (!jit)
+    throw std::runtime_error("cudaq::builder failed to create the JIT: " +
+                             llvm::toString(jit.takeError()));
+
+  // Resolve the runtime functions the kernel calls from the current process
+  // and the extra libraries.
+  auto &mainLib = (*jit)->getMainJITDylib();
+  const char prefix = (*jit)->getDataLayout().getGlobalPrefix();
+  mainLib.addGenerator(llvm::cantFail(
+      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(prefix)));
+  for (auto &lib : sharedLibPaths) {
+    cudaq::info("Extra library loaded: {}", lib);
+    auto generator =
+        llvm::orc::DynamicLibrarySearchGenerator::Load(lib.c_str(), prefix);
+    if (!generator)
+      throw std::runtime_error("cudaq::builder failed to load " + lib + ": " +
+                               llvm::toString(generator.takeError()));
+    mainLib.addGenerator(std::move(*generator));
+  }
+
+  if (auto err = (*jit)->addObjectFile(
+          llvm::MemoryBuffer::getMemBufferCopy(objectCode, "cudaq-kernel")))
+    throw std::runtime_error("cudaq::builder failed to link the kernel: " +
+                             llvm::toString(std::move(err)));
+
+  return std::unique_ptr<JITEngine>(new JITEngine(std::move(*jit)));
+}
+
+llvm::Expected<void *> JITEngine::lookup(llvm::StringRef name) const {
+  auto address = jit->lookup(name);
+  if (!address)
+    return address.takeError();
+  return address->toPtr<void *>();
+}
+
+static std::atomic<int> &jitOptLevelSetting() {
+  static std::atomic<int> level = []() {
+    auto *envVal = std::getenv("CUDAQ_JIT_OPT_LEVEL");
+    if (!envVal)
+      return -1;
+    int value = 0;
+    try {
+      value = std::stoi(envVal);
+    } catch (...) {
+      value = -2;
+    }
+    if (value < -1 || value > 3)
+      throw std::runtime_error("Invalid CUDAQ_JIT_OPT_LEVEL environment "
+                               "variable, must be -1 (auto) or 0 to 3.");
+    return value;
+  }();
+  return level;
+}
+
+void set_jit_opt_level(int level) {
+  if (level < -1 || level > 3)
+    throw std::runtime_error("Invalid JIT optimization level " +
+                             std::to_string(level) +
+                             ", must be -1 (auto) or 0 to 3.");
+  jitOptLevelSetting() = level;
+}
+
+int getJITOptLevelSetting() { return jitOptLevelSetting(); }
+
+unsigned getJITOptLevel(llvm::Module &module) {
+  int setting = getJITOptLevelSetting();
+  if (setting >= 0)
+    return setting;
+
+  // The O2 pipeline is roughly linear in the instruction count, a few
+  // milliseconds for typical kernels but seconds for circuits unrolled into
+  // tens of thousands of QIR calls, which gain little from it.
+  constexpr unsigned smallKernel = 10000;
+  constexpr unsigned mediumKernel = 50000;
+  auto count = module.getInstructionCount();
+  unsigned level = count < smallKernel ? 2 : count < mediumKernel ? 1 : 0;
+  cudaq::info("JIT compiling a kernel of {} instructions at O{}.", count,
+              level);
+  return level;
+}
+
+std::string compileToObjectCode(llvm::Module &module, unsigned optLevel) {
+  auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!jtmb)
+    throw std::runtime_error("cudaq::builder failed to detect the host: " +
+                             llvm::toString(jtmb.takeError()));
+  constexpr llvm::CodeGenOpt::Level codeGenLevels[] = {
+      llvm::CodeGenOpt::None, llvm::CodeGenOpt::Less,
+      llvm::CodeGenOpt::Default, llvm::CodeGenOpt::Aggressive};
+  jtmb->setCodeGenOptLevel(codeGenLevels[std::min(optLevel, 3u)]);
+  auto tm = jtmb->createTargetMachine();
+  if (!tm)
+    throw std::runtime_error(
+        "cudaq::builder failed to create the target machine: " +
+        llvm::toString(tm.takeError()));
+
+  module.setDataLayout((*tm)->createDataLayout());
+  module.setTargetTriple((*tm)->getTargetTriple().str());
+  if (optLevel > 0) {
+    auto optimize = mlir::makeOptimizingTransformer(optLevel, /*sizeLevel=*/0,
+                                                    tm->get());
+    if (auto err = optimize(&module))
+      throw std::runtime_error(
+          "cudaq::builder failed to optimize the kernel: " +
+          llvm::toString(std::move(err)));
+  }
+
+  llvm::orc::SimpleCompiler compiler(**tm);
+  auto object = compiler(module);
+  if (!object)
+    throw std::runtime_error("cudaq::builder failed to compile the kernel: " +
+                             llvm::toString(object.takeError()));
+  return (*object)->getBuffer().str();
+}
+
+JITObjectCache::JITObjectCache(fs::path cacheDirectory,
+                               std::uintmax_t maxBytes)
+    : maxBytes(maxBytes) {
+  if (maxBytes == 0 || cacheDirectory.empty())
+    return;
+
+  std::error_code ec;
+  fs::create_directories(cacheDirectory, ec);
+  if (ec) {
+    cudaq::info("Disabling the on-disk JIT cache, cannot create {} ({}).",
+                cacheDirectory.string(), ec.message());
+    return;
+  }
+  directory = std::move(cacheDirectory);
+  cudaq::info("On-disk JIT cache at {} (max {} MB).", directory.string(),
+              maxBytes >> 20);
+}
+
+JITObjectCache &JITObjectCache::get() {
+  static JITObjectCache cache = []() {
+    std::uintmax_t maxMegabytes = 256;
+    if (auto *envVal = std::getenv("CUDAQ_JIT_CACHE_MAX_MB")) {
+      try {
+        maxMegabytes = std::stoull(envVal);
+      } catch (...) {
+        throw std::runtime_error("Invalid CUDAQ_JIT_CACHE_MAX_MB environment "
+                                 "variable, must be integer.");
+      }
+    }
+
+    fs::path directory;
+    if (auto *envVal = std::getenv("CUDAQ_JIT_CACHE_DIR"))
+      directory = envVal;
+    else if (auto *cacheHome = std::getenv("XDG_CACHE_HOME"))
+      directory = fs::path(cacheHome) / "cudaq" / "jit";
+    else if (auto *home = std::getenv("HOME"))
+      directory = fs::path(home) / ".cache" / "cudaq" / "jit";
+    return JITObjectCache(directory, maxMegabytes << 20);
+  }();
+  return cache;
+}
+
+std::string JITObjectCache::computeKey(llvm::ArrayRef<std::string> inputs) {
+  static const std::string hostTarget = []() -> std::string {
+    auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!jtmb) {
+      llvm::consumeError(jtmb.takeError());
+      return "";
+    }
+    return jtmb->getTargetTriple().str() + ";" + jtmb->getCPU() + ";" +
+           jtmb->getFeatures().getString();
+  }();
+
+  // Separate the inputs, so that moving bytes between them changes the key.
+  llvm::SHA256 hasher;
+  auto update = [&](llvm::StringRef data) {
+    hasher.update(data);
+    hasher.update(llvm::StringRef("\0", 1));
+  };
+  update(LLVM_VERSION_STRING);
+  update(hostTarget);
+  for (auto &input : inputs)
+    update(input);
+  return llvm::toHex(hasher.result(), /*LowerCase=*/true);
+}
+
+std::optional<std::string> JITObjectCache::lookup(const std::string &key) {
+  if (maxBytes == 0)
+    return std::nullopt;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = objects.find(key);
+  if (iter != objects.end()) {
+    hits++;
+    cudaq::info("JIT cache hit (in process) for {}, {} hits / {} misses.", key,
+                hits, misses);
+    recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed,
+                        iter->second.usePosition);
+    return iter->second.objectCode;
+  }
+
+  if (!directory.empty()) {
+    auto path = directory / (key + ".o");
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+      std::string objectCode((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+      if (!file.bad() && !objectCode.empty()) {
+        // Refresh the modification time, it orders the eviction.
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        hits++;
+        cudaq::info("JIT cache hit (on disk) for {}, {} hits / {} misses.",
+                    key, hits, misses);
+        return keepObject(key, std::move(objectCode));
+      }
+    }
+  }
+
+  misses++;
+  cudaq::info("JIT cache miss for {}, {} hits / {} misses.", key, hits,
+              misses);
+  return std::nullopt;
+}
+
+void JITObjectCache::insert(const std::string &key,
+                            const std::string &objectCode) {
+  if (maxBytes == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  keepObject(key, objectCode);
+  if (directory.empty())
+    return;
+
+  // Write to a temporary file and rename it, so that concurrent processes
+  // never read a partially written object.
+  auto path = directory / (key + ".o");
+  auto tmpPath = path;
+  tmpPath += ".tmp" + std::to_string(llvm::sys::Process::getProcessId());
+  {
+    std::ofstream file(tmpPath, std::ios::binary);
+    file.write(objectCode.data(), objectCode.size());
+    // Flush before the rename, a failed write must not replace the entry.
+    file.close();
+    if (!file) {
+      cudaq::info("Failed to write the JIT cache entry {}.", tmpPath.string());
+      std::error_code ec;
+      fs::remove(tmpPath, ec);
+      return;
+    }
+  }
+
+  std::error_code ec;
+  fs::rename(tmpPath, path, ec);
+  if (ec) {
+    fs::remove(tmpPath, ec);
+    return;
+  }
+  evict();
+}
+
+void JITObjectCache::erase(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  dropObject(key);
+  if (directory.empty())
+    return;
+
+  std::error_code ec;
+  fs::remove(directory / (key + ".o"), ec);
+}
+
+const std::string &JITObjectCache::keepObject(const std::string &key,
+                                              std::string objectCode) {
+  dropObject(key);
+  recentlyUsed.push_front(key);
+  objectBytes += objectCode.size();
+  auto &object =
+      objects.emplace(key, CachedObject{std::move(objectCode),
+                                        recentlyUsed.begin()})
+          .first->second;
+
+  // Never drop the new object itself, it is returned to the caller.
+  while (objectBytes > maxBytes && recentlyUsed.size() > 1) {
+    cudaq::info("Evicted {} from the in-process JIT cache.",
+                recentlyUsed.back());
+    dropObject(recentlyUsed.back());
+  }
+  return object.objectCode;
+}
+
+void JITObjectCache::dropObject(const std::string &key) {
+  auto iter = objects.find(key);
+  if (iter == objects.end())
+    return;
+  objectBytes -= iter->second.objectCode.size();
+  recentlyUsed.erase(iter->second.usePosition);
+  objects.erase(iter);
+}
+
+/// @brief Return the object code with every occurrence of `from` replaced
+/// by `to`, of the same length. Symbol names and strings are stored verbatim
+/// in the string tables and data sections of a relocatable object, and an
+/// equal length substitution keeps every offset valid.
+static std::string renameInObjectCode(std::string objectCode,
+                                      llvm::StringRef from,
+                                      llvm::StringRef to) {
+  if (from.empty())
+    return objectCode;
+  if (from.size() != to.size())
+    throw std::runtime_error("cudaq::builder cannot rename " + from.str() +
+                             " to " + to.str() + " in the object code.");
+  for (auto pos = objectCode.find(from); pos != std::string::npos;
+       pos = objectCode.find(from, pos + from.size()))
+    objectCode.replace(pos, from.size(), to.data(), to.size());
+  return objectCode;
+}
+
+std::unique_ptr<JITEngine>
+JITObjectCache::link(const std::string &key,
+                     const std::function<std::string()> &compile,
+                     const std::vector<std::string> &sharedLibPaths,
+                     llvm::StringRef entrySymbol, llvm::StringRef placeholder,
+                     llvm::StringRef name) {
+  // Linking is lazy, resolve the entry symbol to check the object.
+  auto tryLink = [&](const std::string &objectCode) {
+    auto engine = JITEngine::create(
+        renameInObjectCode(objectCode, placeholder, name), sharedLibPaths);
+    auto address = engine->lookup(entrySymbol);
+    if (!address)
+      throw std::runtime_error("cudaq::builder failed to resolve " +
+                               entrySymbol.str() + ": " +
+                               llvm::toString(address.takeError()));
+    return engine;
+  };
+
+  if (auto objectCode = lookup(key)) {
+    try {
+      return tryLink(*objectCode);
+    } catch (std::exception &e) {
+      cudaq::info("Evicting the JIT cache entry {}, it failed to link ({}).",
+                  key, e.what());
+      erase(key);
+    }
+  }
+
+  auto objectCode = compile();
+  insert(key, objectCode);
+  return tryLink(objectCode);
+}
+
+void JITObjectCache::evict() {
+  std::error_code ec;
+  std::vector<std::tuple<fs::file_time_type, std::uintmax_t, fs::path>>
+      entries;
+  std::uintmax_t totalBytes = 0;
+  for (auto &entry : fs::directory_iterator(directory, ec)) {
+    if (!entry.is_regular_file(ec) || entry.path().extension() != ".o")
+      continue;
+    auto size = entry.file_size(ec);
+    if (ec)
+      continue;
+    entries.emplace_back(entry.last_write_time(ec), size, entry.path());
+    totalBytes += size;
+  }
+  if (totalBytes <= maxBytes)
+    return;
+
+  // Oldest first.
+  std::sort(entries.begin(), entries.end());
+  for (auto &[time, size, path] : entries) {
+    if (totalBytes <= maxBytes)
+      break;
+    if (fs::remove(path, ec)) {
+      totalBytes -= size;
+      cudaq::info("Evicted {} from the JIT cache.", path.string());
+    }
+  }
+}
+
+} // namespace cudaq
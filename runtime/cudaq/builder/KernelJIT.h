@@ -0,0 +1,163 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class Module;
+namespace orc {
+class LLJIT;
+} // namespace orc
+} // namespace llvm
+
+namespace cudaq {
+
+/// @brief The JITEngine owns the native object code of a JIT compiled
+/// kernel_builder kernel, linked against the current process and the given
+/// shared libraries.
+class JITEngine {
+private:
+  std::unique_ptr<llvm::orc::LLJIT> jit;
+
+  JITEngine(std::unique_ptr<llvm::orc::LLJIT> jit);
+
+public:
+  ~JITEngine();
+
+  /// @brief Link the object code and return the engine.
+  static std::unique_ptr<JITEngine>
+  create(llvm::StringRef objectCode,
+         const std::vector<std::string> &sharedLibPaths);
+
+  /// @brief Return the address of the given (unmangled) symbol.
+  llvm::Expected<void *> lookup(llvm::StringRef name) const;
+};
+
+/// @brief Return the LLVM optimization level setting for builder kernels,
+/// from cudaq::set_jit_opt_level or CUDAQ_JIT_OPT_LEVEL. -1 (the default)
+/// picks the level per kernel.
+int getJITOptLevelSetting();
+
+/// @brief Return the LLVM optimization level (0 to 3) to compile the module
+/// with. If the setting is -1, small kernels, where optimizing the classical
+/// code is cheap, are compiled at O2 and large (typically fully unrolled)
+/// kernels at O1 or O0, where the compile time would dominate.
+unsigned getJITOptLevel(llvm::Module &module);
+
+/// @brief Optimize the LLVM module at the given level (0 to 3) and compile it
+/// to native object code for the host. This sets the module target triple
+/// and data layout.
+std::string compileToObjectCode(llvm::Module &module, unsigned optLevel);
+
+/// @brief The JITObjectCache is a content-addressed cache of kernel object
+/// code, kept in process and on disk, so that JIT compiling an identical
+/// kernel again (in this or a later process) skips both the MLIR pass
+/// pipeline and LLVM code generation.
+///
+/// The disk cache lives in CUDAQ_JIT_CACHE_DIR (by default
+/// $XDG_CACHE_HOME/cudaq/jit or ~/.cache/cudaq/jit). The in-process and the
+/// disk caches are each capped at CUDAQ_JIT_CACHE_MAX_MB megabytes (default
+/// 256, 0 disables the cache), evicting the least recently used objects
+/// first.
+class JITObjectCache {
+private:
+  std::mutex mutex;
+
+  /// @brief An object of the in-process cache, and its position in the
+  /// recently used list.
+  struct CachedObject {
+    std::string objectCode;
+    std::list<std::string>::iterator usePosition;
+  };
+
+  /// @brief In-process cache, key to object code.
+  std::unordered_map<std::string, CachedObject> objects;
+
+  /// @brief The keys of the in-process cache, most recently used first.
+  std::list<std::string> recentlyUsed;
+
+  /// @brief The total size of the in-process objects, in bytes.
+  std::uintmax_t objectBytes = 0;
+
+  /// @brief The on-disk cache directory, empty if disabled.
+  std::filesystem::path directory;
+
+  /// @brief The maximum total size of the in-process and of the on-disk
+  /// cache, in bytes.
+  std::uintmax_t maxBytes = 0;
+
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+
+  /// @brief Add (or refresh) the in-process object for the key, then drop
+  /// the least recently used objects until the in-process cache fits in
+  /// maxBytes. The caller holds the mutex.
+  const std::string &keepObject(const std::string &key,
+                                std::string objectCode);
+
+  /// @brief Remove the in-process object for the key. The caller holds the
+  /// mutex.
+  void dropObject(const std::string &key);
+
+  /// @brief Remove the least recently used objects until the disk cache fits
+  /// in maxBytes.
+  void evict();
+
+public:
+  /// @brief Create a cache backed by the given directory, capped at maxBytes.
+  /// An empty directory keeps the cache in process only, a zero size
+  /// disables it.
+  JITObjectCache(std::filesystem::path directory, std::uintmax_t maxBytes);
+
+  /// @brief Return the process-wide cache, configured from the environment.
+  static JITObjectCache &get();
+
+  /// @brief Return a key for the given inputs (e.g. the module, the pass
+  /// pipeline), which also covers the host target and LLVM version.
+  static std::string computeKey(llvm::ArrayRef<std::string> inputs);
+
+  /// @brief Return the object code for the key, if cached.
+  std::optional<std::string> lookup(const std::string &key);
+
+  /// @brief Add the object code for the key to the cache.
+  void insert(const std::string &key, const std::string &objectCode);
+
+  /// @brief Remove the object code for the key, in process and on disk.
+  void erase(const std::string &key);
+
+  /// @brief Return the engine for the key, with entrySymbol resolved. On a
+  /// miss, compile() produces the object code, which is then cached. A cached
+  /// object that fails to link (e.g. a corrupt file) is evicted and compiled
+  /// again.
+  ///
+  /// The cached objects may be compiled with a placeholder in place of the
+  /// kernel name, so that kernels that only differ by their name share an
+  /// entry. The linked copy then has every occurrence of
+  /// `placeholder` replaced by `name`, which must have the same length.
+  std::unique_ptr<JITEngine>
+  link(const std::string &key, const std::function<std::string()> &compile,
+       const std::vector<std::string> &sharedLibPaths,
+       llvm::StringRef entrySymbol, llvm::StringRef placeholder = {},
+       llvm::StringRef name = {});
+};
+
+} // namespace cudaq
@@ -7,6 +7,7 @@
  *******************************************************************************/
 
 #include "kernel_builder.h"
+#include "KernelJIT.h"
 #include "common/Logger.h"
 #include "common/RuntimeMLIR.h"
 #include "cudaq/Optimizer/Builder/Runtime.h"
@@ -19,10 +20,10 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Affine/Passes.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
-#include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/ImplicitLocOpBuilder.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/Pass/Pass.h"
@@ -103,7 +104,7 @@ MLIRContext *initializeContext() {
   return cudaq::initializeMLIR().release();
 }
 void deleteContext(MLIRContext *context) { delete context; }
-void deleteJitEngine(ExecutionEngine *jit) { delete jit; }
+void deleteJitEngine(JITEngine *jit) { delete jit; }
 
 ImplicitLocOpBuilder *
 initializeBuilder(MLIRContext *context,
@@ -571,9 +572,36 @@ bool hasAnyQubitTypes(FunctionType funcTy) {
   return false;
 }
 
-ExecutionEngine *jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
-                         std::string kernelName,
-                         std::vector<std::string> extraLibPaths) {
+/// @brief Add the passes lowering the builder module to QIR. The first
+/// stage only unrolls and inlines, the whole pipeline lowers to QIR.
+static void addJITPasses(PassManager &pm, bool lowerToQIR) {
+  pm.addPass(createCanonicalizerPass());
+  OpPassManager &optPM = pm.nest<func::FuncOp>();
+  pm.addPass(cudaq::opt::createExpandMeasurementsPass());
+  pm.addPass(createCanonicalizerPass());
+  pm.addPass(cudaq::opt::createApplyOpSpecializationPass());
+  pm.addPass(cudaq::opt::createLoopUnrollPass());
+  pm.addPass(createCanonicalizerPass());
+  pm.addPass(createInlinerPass());
+  pm.addPass(createCanonicalizerPass());
+  pm.addPass(createCSEPass());
+  if (!lowerToQIR)
+    return;
+
+  pm.addPass(createInlinerPass());
+  optPM.addPass(cudaq::opt::createQuakeAddDeallocs());
+  optPM.addPass(cudaq::opt::createQuakeAddMetadata());
+  pm.addPass(cudaq::opt::createGenerateDeviceCodeLoader(/*genAsQuake=*/true));
+  pm.addPass(cudaq::opt::createGenerateKernelExecution());
+  optPM.addPass(cudaq::opt::createLowerToCFGPass());
+  pm.addPass(createCanonicalizerPass());
+  pm.addPass(createCSEPass());
+  pm.addPass(cudaq::opt::createConvertToQIRPass());
+}
+
+JITEngine *jitCode(ImplicitLocOpBuilder &builder, JITEngine *jit,
+                   std::string kernelName,
+                   std::vector<std::string> extraLibPaths) {
   if (jit)
     return jit;
 
@@ -590,8 +618,27 @@ ExecutionEngine *jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
   auto currentModule = function->getParentOfType<ModuleOp>();
   auto module = currentModule.clone();
   auto ctx = module.getContext();
+
+  // The name ends with random digits (see initializeBuilder). Compile the
+  // kernel under a placeholder of the same length, so that identical kernels
+  // share their JIT cache entry. The cache puts the digits back in the
+  // linked object code.
+  constexpr std::string_view namePlaceholder = "cudaqJITname";
+  std::string nameSuffix, compiledName = kernelName;
+  auto kernelFunc = module.lookupSymbol<func::FuncOp>(kernelName);
+  if (kernelFunc && kernelName.size() > namePlaceholder.size()) {
+    auto suffixPos = kernelName.size() - namePlaceholder.size();
+    nameSuffix = kernelName.substr(suffixPos);
+    compiledName.replace(suffixPos, namePlaceholder.size(), namePlaceholder);
+    if (failed(SymbolTable::replaceAllSymbolUses(
+            kernelFunc, StringAttr::get(ctx, compiledName), module)))
+      throw std::runtime_error("cudaq::builder failed to rename " +
+                               kernelName + " for the JIT cache.");
+    SymbolTable::setSymbolName(kernelFunc, compiledName);
+  }
+
   SmallVector<mlir::NamedAttribute> names;
-  names.emplace_back(mlir::StringAttr::get(ctx, kernelName),
+  names.emplace_back(mlir::StringAttr::get(ctx, compiledName),
                      mlir::StringAttr::get(ctx, "BuilderKernel.EntryPoint"));
   auto mapAttr = mlir::DictionaryAttr::get(ctx, names);
   module->setAttr("qtx.mangled_name_map", mapAttr);
@@ -607,76 +654,56 @@ ExecutionEngine *jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
     return WalkResult::advance();
   });
 
-  PassManager pm(context);
-  pm.addPass(createCanonicalizerPass());
-  OpPassManager &optPM = pm.nest<func::FuncOp>();
-  pm.addPass(cudaq::opt::createExpandMeasurementsPass());
-  pm.addPass(createCanonicalizerPass());
-  pm.addPass(cudaq::opt::createApplyOpSpecializationPass());
-  pm.addPass(cudaq::opt::createLoopUnrollPass());
-  pm.addPass(createCanonicalizerPass());
-  pm.addPass(createInlinerPass());
-  pm.addPass(createCanonicalizerPass());
-  pm.addPass(createCSEPass());
-
   // For some reason I get CFG ops from the LowerToCFGPass
   // instead of the unrolled cc loop if I don't run
-  // the above manually.
-  if (failed(pm.run(module)))
-    throw std::runtime_error(
-        "cudaq::builder failed to JIT compile the Quake representation.");
+  // the first stage manually.
+  PassManager firstStage(context), pipeline(context);
+  addJITPasses(firstStage, /*lowerToQIR=*/false);
+  addJITPasses(pipeline, /*lowerToQIR=*/true);
+
+  // The object code is determined by the Quake module, the pipeline and the
+  // LLVM optimization level (the cache key also covers the host target).
+  std::string moduleText, pipelineText;
+  {
+    llvm::raw_string_ostream os(moduleText);
+    module.print(os);
+  }
+  {
+    llvm::raw_string_ostream os(pipelineText);
+    pipeline.printAsTextualPipeline(os);
+  }
+  auto &cache = cudaq::JITObjectCache::get();
+  auto optLevelText = std::to_string(cudaq::getJITOptLevelSetting());
+  auto key = cudaq::JITObjectCache::computeKey(
+      {moduleText, pipelineText, optLevelText});
 
-  // Continue on...
-  pm.addPass(createInlinerPass());
-  optPM.addPass(cudaq::opt::createQuakeAddDeallocs());
-  optPM.addPass(cudaq::opt::createQuakeAddMetadata());
-  pm.addPass(cudaq::opt::createGenerateDeviceCodeLoader(/*genAsQuake=*/true));
-  pm.addPass(cudaq::opt::createGenerateKernelExecution());
-  optPM.addPass(cudaq::opt::createLowerToCFGPass());
-  pm.addPass(createCanonicalizerPass());
-  pm.addPass(createCSEPass());
-  pm.addPass(cudaq::opt::createConvertToQIRPass());
+  // Kernel names are __nvqpp__mlirgen__BuilderKernelPTRSTR
+  // for the following we want the proper name, BuilderKernelPTRST
+  std::string properName = name(kernelName);
 
-  if (failed(pm.run(module)))
-    throw std::runtime_error(
-        "cudaq::builder failed to JIT compile the Quake representation.");
+  auto compile = [&]() {
+    if (failed(firstStage.run(module)) || failed(pipeline.run(module)))
+      throw std::runtime_error(
+          "cudaq::builder failed to JIT compile the Quake representation.");
+    cudaq::info("- Pass manager was applied.");
 
-  cudaq::info("- Pass manager was applied.");
-  ExecutionEngineOptions opts;
-  opts.transformer = [](llvm::Module *m) { return llvm::ErrorSuccess(); };
-  opts.jitCodeGenOptLevel = llvm::CodeGenOpt::None;
-  SmallVector<StringRef, 4> sharedLibs;
-  for (auto &lib : extraLibPaths) {
-    cudaq::info("Extra library loaded: {}", lib);
-    sharedLibs.push_back(lib);
-  }
-  opts.sharedLibPaths = sharedLibs;
-  opts.llvmModuleBuilder =
-      [](Operation *module,
-         llvm::LLVMContext &llvmContext) -> std::unique_ptr<llvm::Module> {
+    llvm::LLVMContext llvmContext;
     llvmContext.setOpaquePointers(false);
     auto llvmModule = translateModuleToLLVMIR(module, llvmContext);
-    if (!llvmModule) {
-      llvm::errs() << "Failed to emit LLVM IR\n";
-      return nullptr;
-    }
-    ExecutionEngine::setupTargetTriple(llvmModule.get());
-    return llvmModule;
+    if (!llvmModule)
+      throw std::runtime_error("cudaq::builder failed to emit LLVM IR.");
+    return cudaq::compileToObjectCode(*llvmModule,
+                                      cudaq::getJITOptLevel(*llvmModule));
   };
 
-  cudaq::info(" - Creating the MLIR ExecutionEngine");
-  auto jitOrError = ExecutionEngine::create(module, opts);
-  assert(!!jitOrError);
-
-  auto uniqueJit = std::move(jitOrError.get());
-  jit = uniqueJit.release();
+  cudaq::info(" - Creating the JIT Engine");
+  jit = cache
+            .link(key, compile, extraLibPaths, properName + ".init_func",
+                  nameSuffix.empty() ? "" : namePlaceholder, nameSuffix)
+            .release();
 
   cudaq::info("- JIT Engine created successfully.");
 
-  // Kernel names are __nvqpp__mlirgen__BuilderKernelPTRSTR
-  // for the following we want the proper name, BuilderKernelPTRST
-  std::string properName = name(kernelName);
-
   // Need to first invoke the init_func()
   auto kernelInitFunc = properName + ".init_func";
   auto initFuncPtr = jit->lookup(kernelInitFunc);
@@ -700,11 +727,11 @@ ExecutionEngine *jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
   return jit;
 }
 
-void invokeCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
+void invokeCode(ImplicitLocOpBuilder &builder, JITEngine *jit,
                 std::string kernelName, void **argsArray,
                 std::vector<std::string> extraLibPaths) {
 
-  assert(jit != nullptr && "JIT ExecutionEngine was null.");
+  assert(jit != nullptr && "JIT Engine was null.");
   cudaq::info("kernel_builder invoke kernel with args.");
 
   // Kernel names are __nvqpp__mlirgen__BuilderKernelPTRSTR
@@ -30,15 +30,21 @@ class ImplicitLocOpBuilder;
 class MLIRContext;
 class DialectRegistry;
 class Value;
-class ExecutionEngine;
 class PassManager;
 } // namespace mlir
 
 using namespace mlir;
 
 namespace cudaq {
+class JITEngine;
 std::string get_quake_by_name(const std::string &);
 
+/// @brief Set the LLVM optimization level (0 to 3) used to JIT compile
+/// kernel_builder kernels, or -1 (the default) to pick it per kernel from the
+/// kernel size. This overrides the CUDAQ_JIT_OPT_LEVEL environment variable
+/// for kernels compiled afterwards.
+void set_jit_opt_level(int level);
+
 /// @brief Define a floating point concept
 template <typename T>
 concept NumericType = requires(T param) { std::is_floating_point_v<T>; };
@@ -135,7 +141,7 @@ void deleteBuilder(ImplicitLocOpBuilder *builder);
 
 /// @brief Delete function for the JIT pointer,
 /// also given to the unique_ptr
-void deleteJitEngine(ExecutionEngine *jit);
+void deleteJitEngine(JITEngine *jit);
 
 /// @brief Allocate a qubit or a qreg.
 QuakeValue qalloc(ImplicitLocOpBuilder &builder, const std::size_t nQubits = 1);
@@ -186,14 +192,16 @@ std::string name(std::string_view kernelName);
 /// @brief Apply our MLIR passes before JIT execution
 void applyPasses(PassManager &);
 
-/// @brief Create the ExecutionEngine and return a raw
-/// pointer, which we will wrap in a unique_ptr
-ExecutionEngine *jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
-                         std::string kernelName,
-                         std::vector<std::string> extraLibPaths);
+/// @brief Create the JITEngine and return a raw
+/// pointer, which we will wrap in a unique_ptr. The
+/// object code is taken from the JITObjectCache if the
+/// same kernel was compiled before.
+JITEngine *jitCode(ImplicitLocOpBuilder &builder, JITEngine *jit,
+                   std::string kernelName,
+                   std::vector<std::string> extraLibPaths);
 
 /// @brief Invoke the function with the given kernel name.
-void invokeCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
+void invokeCode(ImplicitLocOpBuilder &builder, JITEngine *jit,
                 std::string kernelName, void **argsArray,
                 std::vector<std::string> extraLibPaths);
 
@@ -318,10 +326,10 @@ private:
   std::unique_ptr<ImplicitLocOpBuilder, void (*)(ImplicitLocOpBuilder *)>
       opBuilder;
 
-  /// @brief Handle to the MLIR ExecutionEngine, stored
+  /// @brief Handle to the JITEngine, stored
   /// as a pointer here to keep implementation details
   /// out of CUDA Quantum code
-  std::unique_ptr<ExecutionEngine, void (*)(ExecutionEngine *)> jitEngine;
+  std::unique_ptr<JITEngine, void (*)(JITEngine *)> jitEngine;
 
   /// @brief Name of the CUDA Quantum kernel quake function
   std::string kernelName = "__nvqpp__mlirgen____nvqppBuilderKernel";
@@ -337,7 +345,7 @@ public:
   kernel_builder(std::vector<details::KernelBuilderType> &types)
       : context(details::initializeContext(), details::deleteContext),
         opBuilder(nullptr, [](ImplicitLocOpBuilder *) {}),
-        jitEngine(nullptr, [](ExecutionEngine *) {}) {
+        jitEngine(nullptr, [](JITEngine *) {}) {
     auto *ptr =
         details::initializeBuilder(context.get(), types, arguments, kernelName);
     opBuilder =
@@ -597,7 +605,7 @@ public:
                                  extraLibPaths);
     // Store for the next time if we haven't already
     if (!jitEngine)
-      jitEngine = std::unique_ptr<ExecutionEngine, void (*)(ExecutionEngine *)>(
+      jitEngine = std::unique_ptr<JITEngine, void (*)(JITEngine *)>(
           ptr, details::deleteJitEngine);
   }
 
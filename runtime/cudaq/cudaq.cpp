@@ -14,6 +14,9 @@
 #include "cudaq/utils/registry.h"
 #include <dlfcn.h>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <regex>
 #include <string>
 #include <vector>
@@ -148,6 +151,22 @@ void unset_noise() {
   auto &platform = cudaq::get_platform();
   platform.set_noise(nullptr);
 }
+
+/// @brief The generator of the execution seeds, set by set_random_seed.
+static std::mutex randomSeedMutex;
+static std::optional<std::mt19937_64> randomSeedGenerator;
+
+void set_random_seed(std::size_t seed) {
+  std::lock_guard<std::mutex> lock(randomSeedMutex);
+  randomSeedGenerator.emplace(seed);
+}
+
+std::optional<std::size_t> getNextRandomSeed() {
+  std::lock_guard<std::mutex> lock(randomSeedMutex);
+  if (!randomSeedGenerator)
+    return std::nullopt;
+  return (*randomSeedGenerator)();
+}
 } // namespace cudaq
 
 namespace cudaq::support {
@@ -23,4 +23,8 @@ inline quantum_platform &get_platform() {
 // Declare this function, implemented elsewhere
 std::string getQIR(const std::string &);
 
+/// @brief Return the seed for the next execution if cudaq::set_random_seed
+/// was called, std::nullopt otherwise.
+std::optional<std::size_t> getNextRandomSeed();
+
 } // namespace cudaq
@@ -0,0 +1,21 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include "common/ExecutionContext.h"
+
+namespace cudaq {
+
+/// @brief Compute the expectation value of the spin_op of an "observe"
+/// ExecutionContext on the current simulator, and store it with the measured
+/// data in the context. This is the observe post-processing shared by the
+/// simulated QPUs, called when the context is reset.
+void computeSimulatedObservation(ExecutionContext &ctx);
+
+} // namespace cudaq
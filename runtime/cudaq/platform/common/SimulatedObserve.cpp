@@ -0,0 +1,77 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "cudaq/platform/SimulatedObserve.h"
+#include "common/ObserveGrouping.h"
+#include "cudaq/qis/qubit_qis.h"
+#include "cudaq/spin_op.h"
+
+namespace cudaq {
+
+void computeSimulatedObservation(ExecutionContext &ctx) {
+  double sum = 0.0;
+  if (!ctx.spin.has_value())
+    throw std::runtime_error(
+        "Observe ExecutionContext specified without a cudaq::spin_op.");
+
+  std::vector<cudaq::ExecutionResult> results;
+  cudaq::spin_op &H = *ctx.spin.value();
+
+  // If the backend supports the observe task,
+  // let it compute the expectation value instead of
+  // manually looping over terms, applying basis change ops,
+  // and computing <ZZ..ZZZ>. The backend registers the per-term results.
+  if (ctx.canHandleObserve) {
+    auto [exp, data] = cudaq::measure(H);
+    ctx.expectationValue = exp;
+    ctx.result = std::move(data);
+    return;
+  }
+
+  // Without shots (the -1 stored in the size_t field), the measurements
+  // return exact expectation values and no counts, so measure term by term.
+  if (static_cast<int>(ctx.shots) < 1) {
+    H.for_each_term([&](cudaq::spin_op &term) {
+      if (term.is_identity())
+        sum += term.get_term_coefficient(0).real();
+      else {
+        auto [exp, data] = cudaq::measure(term);
+        results.emplace_back(data.to_map(), term.to_string(false), exp);
+        sum += term.get_term_coefficient(0).real() * exp;
+      }
+    });
+
+    ctx.expectationValue = sum;
+    ctx.result = cudaq::sample_result(sum, results);
+    return;
+  }
+
+  // Measure each set of qubit-wise commuting terms with a single basis
+  // change, and get every term's counts from the shared measurement.
+  for (std::size_t t = 0; t < H.n_terms(); t++)
+    if (H[t].is_identity())
+      sum += H.get_term_coefficient(t).real();
+
+  for (auto &group : cudaq::groupQubitWiseCommuting(H)) {
+    auto measured = cudaq::measure(group.basis).second;
+    auto &groupCounts = measured.packed_counts();
+    for (auto t : group.termIndices) {
+      auto term = H[t];
+      auto result =
+          cudaq::marginalizeGroupCounts(groupCounts, group.basis, term);
+      sum += H.get_term_coefficient(t).real() *
+             result.expectationValue.value();
+      results.push_back(result);
+    }
+  }
+
+  ctx.expectationValue = sum;
+  ctx.result = cudaq::sample_result(sum, results);
+}
+
+} // namespace cudaq
@@ -9,6 +9,7 @@
 #include "common/ExecutionContext.h"
 #include "common/Logger.h"
 #include "common/NoiseModel.h"
+#include "cudaq/platform/SimulatedObserve.h"
 #include "cudaq/platform/qpu.h"
 #include "cudaq/platform/quantum_platform.h"
 #include "cudaq/qis/qubit_qis.h"
@@ -34,63 +35,30 @@ public:
 
   void launchKernel(const std::string &name, void (*kernelFunc)(void *),
                     void *args, std::uint64_t, std::uint64_t) override {
-    cudaq::ScopedTrace trace("QPU::launchKernel");
+    CUDAQ_TRACE_SCOPE("QPU::launchKernel");
     kernelFunc(args);
   }
 
   /// Overrides setExecutionContext to forward it to the ExecutionManager
   void setExecutionContext(cudaq::ExecutionContext *context) override {
-    cudaq::ScopedTrace trace("DefaultPlatform::setExecutionContext",
-                             context->name);
+    CUDAQ_TRACE_SCOPE("DefaultPlatform::setExecutionContext", context->name);
     executionContext = context;
     if (noiseModel)
       executionContext->noiseModel = noiseModel;
 
+    cudaq::getExecutionManager()->setQuditCapacity(numQubits);
     cudaq::getExecutionManager()->setExecutionContext(executionContext);
   }
 
   /// Overrides resetExecutionContext to forward to
   /// the ExecutionManager. Also handles observe post-processing
   void resetExecutionContext() override {
-    cudaq::ScopedTrace trace("DefaultPlatform::resetExecutionContext",
-                             executionContext->name);
+    CUDAQ_TRACE_SCOPE("DefaultPlatform::resetExecutionContext",
+                      executionContext->name);
 
     auto ctx = executionContext;
-    if (ctx && ctx->name == "observe") {
-      double sum = 0.0;
-      if (!ctx->spin.has_value())
-        throw std::runtime_error(
-            "Observe ExecutionContext specified without a cudaq::spin_op.");
-
-      std::vector<cudaq::ExecutionResult> results;
-      cudaq::spin_op &H = *ctx->spin.value();
-
-      // If the backend supports the observe task,
-      // let it compute the expectation value instead of
-      // manually looping over terms, applying basis change ops,
-      // and computing <ZZ..ZZZ>
-      if (executionContext->canHandleObserve) {
-        auto [exp, data] = cudaq::measure(H);
-        results.emplace_back(data.to_map(), H.to_string());
-        ctx->expectationValue = exp;
-        ctx->result = cudaq::sample_result(results);
-      } else {
-
-        // Loop over each term and compute coeff * <term>
-        H.for_each_term([&](cudaq::spin_op &term) {
-          if (term.is_identity())
-            sum += term.get_term_coefficient(0).real();
-          else {
-            auto [exp, data] = cudaq::measure(term);
-            results.emplace_back(data.to_map(), term.to_string(false), exp);
-            sum += term.get_term_coefficient(0).real() * exp;
-          }
-        });
-
-        ctx->expectationValue = sum;
-        ctx->result = cudaq::sample_result(sum, results);
-      }
-    }
+    if (ctx && ctx->name == "observe")
+      cudaq::computeSimulatedObservation(*ctx);
     cudaq::getExecutionManager()->resetExecutionContext();
     executionContext = nullptr;
   }
@@ -104,6 +72,7 @@ constexpr char platformQPU[] = "PLATFORM_QPU";
 class DefaultQuantumPlatform : public cudaq::quantum_platform {
 public:
   DefaultQuantumPlatform() {
+    platformName = "default";
     // Populate the information and add the QPUs
     platformQPUs.emplace_back(std::make_unique<DefaultQPU>());
     platformNumQPUs = platformQPUs.size();
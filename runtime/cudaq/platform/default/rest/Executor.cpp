@@ -8,6 +8,7 @@
 
 #include "Executor.h"
 #include "common/Logger.h"
+#include <mutex>
 
 namespace cudaq {
 details::future
@@ -22,21 +23,25 @@ Executor::execute(std::vector<KernelExecution> &codesToExecute) {
   // and the job json messages themselves
   auto [jobPostPath, headers, jobs] = serverHelper->createJob(codesToExecute);
 
-  std::vector<details::future::Job> ids;
-  for (std::size_t i = 0; auto &job : jobs) {
-    cudaq::info("Job (name={}) created, posting to {}", codesToExecute[i].name,
-                jobPostPath);
-
-    // Post it, get the response
-    auto response = client.post(jobPostPath, "", job, headers);
-    cudaq::info("Job (name={}) posted, response was {}", codesToExecute[i].name,
-                response.dump());
-
-    // Add the job id and the job name.
-    ids.emplace_back(serverHelper->extractJobId(response),
-                     codesToExecute[i].name);
-    i++;
-  }
+  // Post the jobs concurrently, the ServerHelper is not required to be
+  // thread safe.
+  std::vector<details::future::Job> ids(jobs.size());
+  std::mutex helperMutex;
+  runConcurrentRequests(
+      jobs.size(), getMaxRestRequestsInFlight(), [&](std::size_t i) {
+        cudaq::info("Job (name={}) created, posting to {}",
+                    codesToExecute[i].name, jobPostPath);
+
+        // Post it, get the response
+        auto response = client.post(jobPostPath, "", jobs[i], headers);
+        cudaq::info("Job (name={}) posted, response was {}",
+                    codesToExecute[i].name, response.dump());
+
+        // Add the job id and the job name.
+        std::lock_guard<std::mutex> lock(helperMutex);
+        ids[i] = std::make_pair(serverHelper->extractJobId(response),
+                                codesToExecute[i].name);
+      });
 
   auto config = serverHelper->getConfig();
   std::string name = serverHelper->name();
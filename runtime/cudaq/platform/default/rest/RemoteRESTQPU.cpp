@@ -9,6 +9,7 @@
 #include "Executor.h"
 #include "common/ExecutionContext.h"
 #include "common/Logger.h"
+#include "common/ObserveGrouping.h"
 #include "common/RestClient.h"
 #include "cudaq/platform/qpu.h"
 #include "nvqpp_config.h"
@@ -266,12 +267,10 @@ public:
     // Apply observations if necessary
     if (executionContext && executionContext->name == "observe") {
 
+      // Measure each set of qubit-wise commuting terms with one circuit, the
+      // term results are recovered from the shared counts in launchKernel.
       cudaq::spin_op &spin = *executionContext->spin.value();
-      for (std::size_t i = 0; i < spin.n_terms(); i++) {
-        auto term = spin[i];
-        if (term.is_identity())
-          continue;
-
+      for (auto &group : cudaq::groupQubitWiseCommuting(spin)) {
         // Get the ansatz
         auto ansatz = moduleOp.lookupSymbol<func::FuncOp>(
             std::string("__nvqpp__mlirgen__") + kernelName);
@@ -280,8 +279,8 @@ public:
         auto tmpModuleOp = builder.create<ModuleOp>();
         tmpModuleOp.push_back(ansatz.clone());
 
-        // Extract the binary symplectic encoding
-        auto binarySymplecticForm = term.get_bsf()[0];
+        // Extract the binary symplectic encoding of the group basis
+        auto binarySymplecticForm = group.basis.get_bsf()[0];
 
         // Create the pass manager, add the quake observe ansatz pass
         // and run it followed by the canonicalizer
@@ -292,7 +291,7 @@ public:
         if (failed(pm.run(tmpModuleOp)))
           throw std::runtime_error("Could not apply measurements to ansatz.");
         runPassPipeline("canonicalize", tmpModuleOp);
-        modules.emplace_back(term.to_string(false), tmpModuleOp);
+        modules.emplace_back(group.basis.to_string(false), tmpModuleOp);
       }
 
     } else
@@ -344,6 +343,9 @@ public:
 
     // Otherwise make this synchronous
     executionContext->result = future.get();
+    if (executionContext->name == "observe")
+      executionContext->result = cudaq::expandMeasurementGroups(
+          executionContext->result, *executionContext->spin.value());
   }
 };
 } // namespace
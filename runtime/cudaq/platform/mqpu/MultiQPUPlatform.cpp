@@ -9,6 +9,7 @@
 #include "common/ExecutionContext.h"
 #include "common/Logger.h"
 #include "common/NoiseModel.h"
+#include "cudaq/platform/SimulatedObserve.h"
 #include "cuda_runtime_api.h"
 #include "cudaq/platform/qpu.h"
 #include "cudaq/platform/quantum_platform.h"
@@ -56,6 +57,7 @@ public:
     if (noiseModel)
       contexts[tid]->noiseModel = noiseModel;
 
+    cudaq::getExecutionManager()->setQuditCapacity(numQubits);
     cudaq::getExecutionManager()->setExecutionContext(contexts[tid]);
   }
 
@@ -66,40 +68,8 @@ public:
     auto tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
 
     auto ctx = contexts[tid];
-    if (ctx && ctx->name == "observe") {
-      double sum = 0.0;
-      if (!ctx->spin.has_value())
-        throw std::runtime_error(
-            "Observe ExecutionContext specified without a cudaq::spin_op.");
-
-      std::vector<cudaq::ExecutionResult> results;
-      cudaq::spin_op &H = *ctx->spin.value();
-
-      // If the backend supports the observe task,
-      // let it compute the expectation value instead of
-      // manually looping over terms, applying basis change ops,
-      // and computing <ZZ..ZZZ>
-      if (ctx->canHandleObserve) {
-        auto [exp, data] = cudaq::measure(H);
-        results.emplace_back(data.to_map(), H.to_string());
-        ctx->expectationValue = exp;
-        ctx->result = cudaq::sample_result(results);
-      } else {
-        H.for_each_term([&](cudaq::spin_op &term) {
-          if (term.is_identity())
-            sum += term.get_term_coefficient(0).real();
-          else {
-
-            auto [exp, data] = cudaq::measure(term);
-            results.emplace_back(data.to_map(), term.to_string(), exp);
-            sum += term.get_term_coefficient(0).real() * exp;
-          }
-        });
-
-        ctx->expectationValue = sum;
-        ctx->result = cudaq::sample_result(sum, results);
-      }
-    }
+    if (ctx && ctx->name == "observe")
+      cudaq::computeSimulatedObservation(*ctx);
 
     cudaq::getExecutionManager()->resetExecutionContext();
     contexts[tid] = nullptr;
@@ -0,0 +1,151 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "common/ExecutionContext.h"
+#include "common/Logger.h"
+#include "common/NoiseModel.h"
+#include "cudaq/platform/SimulatedObserve.h"
+#include "cudaq/platform/qpu.h"
+#include "cudaq/platform/quantum_platform.h"
+#include "cudaq/qis/qubit_qis.h"
+#include "cudaq/spin_op.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <spdlog/cfg/env.h>
+#include <thread>
+
+#ifdef CUDAQ_HAS_OPENMP
+#include <omp.h>
+#endif
+
+/// This file defines the CPU multi-QPU platform. It exposes a configurable
+/// number of simulated QPUs, each executing its tasks on its own thread.
+/// The simulator and the execution manager are thread_local, so each QPU
+/// owns an independent simulator instance.
+
+namespace cudaq {
+// Defined in the CUDA Quantum runtime library.
+void setQuantumPlatformInternal(quantum_platform *p);
+} // namespace cudaq
+
+namespace {
+
+/// @brief This QPU implementation enqueues kernel execution tasks on its own
+/// execution queue thread. There is a CPUEmulatedQPU per requested thread.
+class CPUEmulatedQPU : public cudaq::QPU {
+protected:
+  /// @brief The platform owning this QPU, made the current platform of the
+  /// execution queue thread.
+  cudaq::quantum_platform *platform = nullptr;
+
+  /// @brief The number of OpenMP threads each simulator may use, so that the
+  /// QPUs share the cores instead of oversubscribing them.
+  int numOmpThreads = 1;
+
+  /// @brief Execution contexts, keyed by the thread they were set on.
+  std::map<std::size_t, cudaq::ExecutionContext *> contexts;
+  std::mutex contextsMutex;
+
+public:
+  CPUEmulatedQPU(std::size_t id, cudaq::quantum_platform *owner,
+                 int ompThreads)
+      : QPU(id), platform(owner), numOmpThreads(ompThreads) {}
+
+  void enqueue(cudaq::QuantumTask &task) override {
+    cudaq::info("Enqueue Task on QPU {}", qpu_id);
+    cudaq::QuantumTask wrapped = [this, task]() {
+      cudaq::setQuantumPlatformInternal(platform);
+#ifdef CUDAQ_HAS_OPENMP
+      omp_set_num_threads(numOmpThreads);
+#endif
+      task();
+    };
+    execution_queue->enqueue(wrapped);
+  }
+
+  void launchKernel(const std::string &name, void (*kernelFunc)(void *),
+                    void *args, std::uint64_t, std::uint64_t) override {
+    cudaq::info("QPU::launchKernel CPU QPU {}", qpu_id);
+    kernelFunc(args);
+  }
+
+  /// Overrides setExecutionContext to forward it to the ExecutionManager
+  void setExecutionContext(cudaq::ExecutionContext *context) override {
+    cudaq::info("CPUMultiQPUPlatform::setExecutionContext QPU {}", qpu_id);
+    auto tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    if (noiseModel)
+      context->noiseModel = noiseModel;
+    {
+      std::lock_guard<std::mutex> guard(contextsMutex);
+      contexts[tid] = context;
+    }
+
+    cudaq::getExecutionManager()->setQuditCapacity(numQubits);
+    cudaq::getExecutionManager()->setExecutionContext(context);
+  }
+
+  /// Overrides resetExecutionContext to forward to
+  /// the ExecutionManager. Also handles observe post-processing
+  void resetExecutionContext() override {
+    cudaq::info("CPUMultiQPUPlatform::resetExecutionContext QPU {}", qpu_id);
+    auto tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    cudaq::ExecutionContext *ctx = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(contextsMutex);
+      auto iter = contexts.find(tid);
+      if (iter != contexts.end()) {
+        ctx = iter->second;
+        contexts.erase(iter);
+      }
+    }
+
+    if (ctx && ctx->name == "observe")
+      cudaq::computeSimulatedObservation(*ctx);
+
+    cudaq::getExecutionManager()->resetExecutionContext();
+  }
+};
+
+class CPUMultiQPUQuantumPlatform : public cudaq::quantum_platform {
+public:
+  ~CPUMultiQPUQuantumPlatform() = default;
+  CPUMultiQPUQuantumPlatform() {
+    int nCores = std::max(1u, std::thread::hardware_concurrency());
+    int nQpus = nCores;
+
+    auto envVal = spdlog::details::os::getenv("CUDAQ_MQPU_NTHREADS");
+    if (!envVal.empty()) {
+      try {
+        nQpus = std::stoi(envVal);
+      } catch (...) {
+        throw std::runtime_error("Invalid CUDAQ_MQPU_NTHREADS environment "
+                                 "variable, must be integer.");
+      }
+      if (nQpus < 1)
+        throw std::runtime_error("Invalid CUDAQ_MQPU_NTHREADS environment "
+                                 "variable, must be positive.");
+    }
+
+    // Split the cores between the QPUs for the simulators' own threading.
+    int ompThreads = std::max(1, nCores / nQpus);
+    cudaq::info("Creating {} CPU QPUs with {} OpenMP threads each.", nQpus,
+                ompThreads);
+
+    // Add a QPU for each thread.
+    for (int i = 0; i < nQpus; i++)
+      platformQPUs.emplace_back(
+          std::make_unique<CPUEmulatedQPU>(i, this, ompThreads));
+
+    platformNumQPUs = platformQPUs.size();
+    platformCurrentQPU = 0;
+  }
+};
+} // namespace
+
+CUDAQ_REGISTER_PLATFORM(CPUMultiQPUQuantumPlatform, mqpu_cpu)
@@ -20,9 +20,12 @@
 #include "cudaq/qis/qubit_qis.h"
 #include "cudaq/qis/qudit.h"
 #include "nvqpp_config.h"
+#include <algorithm>
+#include <condition_variable>
 #include <fmt/core.h>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <stdio.h>
 #include <string>
@@ -35,6 +38,10 @@ namespace cudaq {
 std::string get_quake(const std::string &);
 
 thread_local static quantum_platform *platform;
+/// The QPU this thread set an execution context on, launchKernel runs the
+/// kernels of this thread there. Threads running on different QPUs do not
+/// share a current QPU.
+thread_local static std::optional<std::size_t> threadQPU;
 inline static constexpr std::string_view GetQuantumPlatformSymbol =
     "getQuantumPlatform";
 
@@ -60,7 +67,9 @@ void quantum_platform::set_noise(noise_model *model) {
 std::future<sample_result>
 quantum_platform::enqueueAsyncTask(const std::size_t qpu_id,
                                    KernelExecutionTask &task) {
-  set_current_qpu(qpu_id);
+  if (qpu_id >= platformNumQPUs)
+    throw std::invalid_argument(
+        "QPU device id is not valid (greater than number of available QPUs).");
 
   std::promise<sample_result> promise;
   auto f = promise.get_future();
@@ -70,10 +79,119 @@ quantum_platform::enqueueAsyncTask(const std::size_t qpu_id,
         p.set_value(counts);
       });
 
-  platformQPUs[platformCurrentQPU]->enqueue(wrapped);
+  platformQPUs[qpu_id]->enqueue(wrapped);
   return f;
 }
 
+void quantum_platform::runBatch(
+    std::size_t nTasks,
+    const std::function<void(std::size_t, std::size_t, std::size_t)>
+        &runChunk) {
+  auto nQpus = std::min(num_qpus(), nTasks);
+  if (nQpus < 2 || is_remote()) {
+    runChunk(0, 0, nTasks);
+    return;
+  }
+
+  cudaq::info("Running a batch of {} tasks on {} QPUs.", nTasks, nQpus);
+  std::vector<std::exception_ptr> errors(nQpus);
+  std::vector<std::future<sample_result>> futures;
+  for (std::size_t qpu = 0; qpu < nQpus; qpu++) {
+    std::size_t begin = qpu * nTasks / nQpus;
+    std::size_t end = (qpu + 1) * nTasks / nQpus;
+    KernelExecutionTask task([&runChunk, &errors, qpu, begin, end]() {
+      // The QPU thread does not propagate exceptions, keep them for the
+      // calling thread.
+      try {
+        runChunk(qpu, begin, end);
+      } catch (...) {
+        errors[qpu] = std::current_exception();
+      }
+      return sample_result();
+    });
+    futures.emplace_back(enqueueAsyncTask(qpu, task));
+  }
+
+  for (auto &future : futures)
+    future.wait();
+  for (auto &error : errors)
+    if (error)
+      std::rethrow_exception(error);
+}
+
+namespace details {
+namespace {
+/// @brief The pool of threads behind runOnWorkerThreads. Thread i runs
+/// worker i + 1 of each generation of tasks.
+class WorkerPool {
+  std::mutex mutex;
+  std::condition_variable taskReady;
+  std::condition_variable tasksDone;
+  std::vector<std::thread> threads;
+  const std::function<void(std::size_t)> *task = nullptr;
+  std::size_t nActive = 0;
+  std::size_t nPending = 0;
+  std::size_t generation = 0;
+
+  void handler(std::size_t worker) {
+    std::size_t seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      taskReady.wait(lock, [&] { return generation != seenGeneration; });
+      seenGeneration = generation;
+      if (worker >= nActive)
+        continue;
+      auto *currentTask = task;
+      lock.unlock();
+      (*currentTask)(worker);
+      lock.lock();
+      if (--nPending == 0)
+        tasksDone.notify_all();
+    }
+  }
+
+public:
+  /// @brief Serializes callers, the pool runs one generation at a time.
+  std::mutex runMutex;
+
+  void run(std::size_t nWorkers,
+           const std::function<void(std::size_t)> &newTask) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (threads.size() + 1 < nWorkers) {
+      threads.emplace_back(&WorkerPool::handler, this, threads.size() + 1);
+      // The threads block on the condition variable until exit.
+      threads.back().detach();
+    }
+    task = &newTask;
+    nActive = nWorkers;
+    nPending = nWorkers - 1;
+    generation++;
+    taskReady.notify_all();
+    lock.unlock();
+
+    newTask(0);
+
+    lock.lock();
+    tasksDone.wait(lock, [&] { return nPending == 0; });
+  }
+};
+} // namespace
+
+void runOnWorkerThreads(std::size_t nWorkers,
+                        const std::function<void(std::size_t)> &task) {
+  if (nWorkers < 2) {
+    task(0);
+    return;
+  }
+
+  // Never destroyed, the worker threads (and their thread_local runtime)
+  // live until the process exits.
+  static auto *pool = new WorkerPool;
+  std::lock_guard<std::mutex> lock(pool->runMutex);
+  pool->run(nWorkers, task);
+}
+} // namespace details
+
 void quantum_platform::set_current_qpu(const std::size_t device_id) {
   if (device_id >= platformNumQPUs) {
     throw std::invalid_argument(
@@ -90,6 +208,7 @@ std::size_t quantum_platform::get_current_qpu() { return platformCurrentQPU; }
 void quantum_platform::set_exec_ctx(cudaq::ExecutionContext *ctx,
                                     std::size_t qid) {
   executionContext = ctx;
+  threadQPU = qid;
   auto &platformQPU = platformQPUs[qid];
   platformQPU->setExecutionContext(ctx);
 }
@@ -99,6 +218,15 @@ void quantum_platform::reset_exec_ctx(std::size_t qid) {
   auto &platformQPU = platformQPUs[qid];
   platformQPU->resetExecutionContext();
   executionContext = nullptr;
+  threadQPU = std::nullopt;
+}
+
+std::size_t quantum_platform::get_num_qubits() {
+  return platformQPUs[platformCurrentQPU]->getNumQubits();
+}
+
+std::size_t quantum_platform::get_num_qubits(std::size_t qpu_id) {
+  return platformQPUs[qpu_id]->getNumQubits();
 }
 
 std::optional<QubitConnectivity> quantum_platform::connectivity() {
@@ -122,7 +250,7 @@ void quantum_platform::launchKernel(std::string kernelName,
                                     void (*kernelFunc)(void *), void *args,
                                     std::uint64_t voidStarSize,
                                     std::uint64_t resultOffset) {
-  auto &qpu = platformQPUs[platformCurrentQPU];
+  auto &qpu = platformQPUs[threadQPU.value_or(platformCurrentQPU)];
   qpu->launchKernel(kernelName, kernelFunc, args, voidStarSize, resultOffset);
 }
 
@@ -131,7 +259,7 @@ void quantum_platform::launchKernel(std::string kernelName,
 void cudaq::altLaunchKernel(const char *kernelName, void (*kernelFunc)(void *),
                             void *kernelArgs, std::uint64_t argsSize,
                             std::uint64_t resultOffset) {
-  ScopedTrace trace("altLaunchKernel", kernelName, argsSize);
+  CUDAQ_TRACE_SCOPE("altLaunchKernel", kernelName, argsSize);
   auto &platform = *cudaq::getQuantumPlatformInternal();
   std::string kernName = kernelName;
   platform.launchKernel(kernName, kernelFunc, kernelArgs, argsSize,
@@ -66,7 +66,8 @@ public:
   /// Reset shots
   void clear_shots() { platformNumShots = std::nullopt; }
 
-  /// Specify the execution context for this platform.
+  /// Specify the execution context for this platform. Until the context is
+  /// reset, the kernels launched from the calling thread run on qpu_id.
   void set_exec_ctx(cudaq::ExecutionContext *ctx, std::size_t qpu_id = 0);
 
   /// Reset the execution context for this platform.
@@ -99,6 +100,15 @@ public:
   std::future<sample_result> enqueueAsyncTask(const std::size_t qpu_id,
                                               KernelExecutionTask &t);
 
+  /// @brief Run a batch of nTasks independent tasks. The batch is split in
+  /// contiguous chunks over the platform QPUs, runChunk(qpu_id, begin, end)
+  /// runs the tasks [begin, end) back to back on the QPU execution thread.
+  /// With a single QPU, or a remote QPU, the whole batch runs in the calling
+  /// thread. Rethrows the first exception thrown by a chunk.
+  void runBatch(std::size_t nTasks,
+                const std::function<void(std::size_t, std::size_t,
+                                         std::size_t)> &runChunk);
+
   /// Enqueue an asynchronous observation task
   // std::future<observe_result>
   // enqueueAsyncObserveTask(const std::size_t qpu_id, ObserveTask &t);
@@ -143,6 +153,15 @@ protected:
   ExecutionContext *executionContext = nullptr;
 };
 
+namespace details {
+/// @brief Run task(w) for each worker w in [0, nWorkers), and wait for all of
+/// them. Worker 0 is the calling thread. The other workers are persistent
+/// threads, so that their thread_local platform, execution manager and
+/// simulator are reused across calls. The task must not throw.
+void runOnWorkerThreads(std::size_t nWorkers,
+                        const std::function<void(std::size_t)> &task);
+} // namespace details
+
 /// Entry point for the auto-generated kernel execution path. TODO: Needs to be
 /// tied to the quantum platform instance somehow. Note that the compiler cannot
 /// provide that information.
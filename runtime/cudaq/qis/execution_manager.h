@@ -8,11 +8,11 @@
 
 #pragma once
 
+#include "common/IndexPool.h"
 #include "cudaq/spin_op.h"
 #include <cassert>
 #include <complex>
 #include <cstddef>
-#include <deque>
 #include <span>
 #include <string_view>
 #include <vector>
@@ -37,38 +37,29 @@ struct QuditInfo {
 class ExecutionManager {
 protected:
   /// Available qudit indices
-  std::deque<std::size_t> availableIndices;
-
-  /// Total qudits available
-  std::size_t totalQudits;
+  IndexPool availableIndices;
 
   /// Internal - return the next qudit index
-  std::size_t getNextIndex() {
-    assert(!availableIndices.empty() && "No more qudits available.");
-    auto next = availableIndices.front();
-    availableIndices.pop_front();
-    return next;
-  }
+  std::size_t getNextIndex() { return availableIndices.getNextIndex(); }
 
   /// Internal - At qudit deallocation, return the qudit index
-  void returnIndex(std::size_t idx) {
-    availableIndices.push_front(idx);
-    std::sort(availableIndices.begin(), availableIndices.end());
-  }
+  void returnIndex(std::size_t idx) { availableIndices.returnIndex(idx); }
 
   /// Internal - Get the number of remaining available qudit ids
-  std::size_t numAvailable() { return availableIndices.size(); }
+  std::size_t numAvailable() { return availableIndices.numAvailable(); }
 
   /// Internal - Get the total number of qudit ids available
-  std::size_t totalNumQudits() { return totalQudits; }
+  std::size_t totalNumQudits() { return availableIndices.totalNum(); }
 
 public:
-  ExecutionManager() {
-    totalQudits = 30; // platform.get_num_qubits();
-    for (std::size_t i = 0; i < totalQudits; i++) {
-      availableIndices.push_back(i);
-    }
+  ExecutionManager() = default;
+
+  /// Set the number of qudit ids to reserve, e.g. the number of qubits of
+  /// the QPU. More ids are made available on demand.
+  void setQuditCapacity(std::size_t capacity) {
+    availableIndices.setCapacity(capacity);
   }
+
   /// Return the next available qudit index
   virtual std::size_t getAvailableIndex(std::size_t quditLevels = 2) = 0;
 
@@ -77,7 +68,7 @@ public:
   virtual void returnQudit(const QuditInfo &q) = 0;
 
   /// Checker for qudits that were not deallocated
-  bool memoryLeaked() { return numAvailable() != totalNumQudits(); }
+  bool memoryLeaked() { return availableIndices.numAllocated() != 0; }
 
   /// Provide an ExecutionContext for the current cudaq kernel
   virtual void setExecutionContext(cudaq::ExecutionContext *ctx) = 0;
@@ -121,6 +112,12 @@ public:
 };
 
 ExecutionManager *getExecutionManager();
+
+/// @brief Replace the execution manager of the calling thread by the one with
+/// the given name, qir or simulator. Only the QIR execution manager library
+/// provides this, by default it creates the manager named by
+/// CUDAQ_EXECUTION_MANAGER, or else qir.
+void setExecutionManager(std::string_view name);
 } // namespace cudaq
 
 // The following macro is to be used by ExecutionManager subclass
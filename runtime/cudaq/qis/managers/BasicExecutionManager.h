@@ -104,7 +104,7 @@ public:
     handleExecutionContextEnded();
 
     if (ctx_name == "observe" || ctx_name == "sample" ||
-        ctx_name == "extract-state") {
+        ctx_name == "extract-state" || ctx_name == "adjoint-gradient") {
       for (auto &q : contextQuditIdsForDeletion) {
         deallocateQudit(q);
         returnIndex(q);
@@ -133,8 +133,9 @@ public:
 
     // Handle the case where we are sampling with an implicit
     // measure on the entire register.
-    if (executionContext && (ctx_name == "observe" || ctx_name == "sample" ||
-                             ctx_name == "extract-state")) {
+    if (executionContext &&
+        (ctx_name == "observe" || ctx_name == "sample" ||
+         ctx_name == "extract-state" || ctx_name == "adjoint-gradient")) {
       contextQuditIdsForDeletion.push_back(qid.id);
       return;
     }
@@ -244,7 +245,7 @@ public:
 
   void synchronize() override {
     while (!instructionQueue.empty()) {
-      auto instruction = instructionQueue.front();
+      auto instruction = std::move(instructionQueue.front());
       executeInstruction(instruction);
       instructionQueue.pop();
     }
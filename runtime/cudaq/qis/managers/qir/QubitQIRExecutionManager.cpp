@@ -13,6 +13,7 @@
 #include "cudaq/spin_op.h"
 #include "cudaq/utils/cudaq_utils.h"
 #include <complex>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <map>
@@ -258,4 +259,38 @@ Array *spinToArray(cudaq::spin_op &op) {
 
 } // namespace
 
-CUDAQ_REGISTER_EXECUTION_MANAGER(QIRExecutionManager)
+namespace cudaq {
+std::unique_ptr<ExecutionManager> createSimulatorExecutionManager();
+
+/// @brief Create the execution manager with the given name, qir routes the
+/// quantum instructions through the QIR runtime API and simulator applies
+/// them directly on the NVQIR simulator.
+static std::unique_ptr<ExecutionManager>
+createExecutionManager(std::string_view name) {
+  if (name == "qir")
+    return std::make_unique<QIRExecutionManager>();
+  if (name == "simulator")
+    return createSimulatorExecutionManager();
+  throw std::runtime_error("Invalid execution manager " + std::string(name) +
+                           ", must be qir or simulator.");
+}
+
+/// @brief Return the execution manager of the calling thread, by default
+/// created from CUDAQ_EXECUTION_MANAGER or else qir.
+static std::unique_ptr<ExecutionManager> &getThreadExecutionManager() {
+  thread_local static std::unique_ptr<ExecutionManager> qis_manager;
+  if (!qis_manager) {
+    auto *envVal = std::getenv("CUDAQ_EXECUTION_MANAGER");
+    qis_manager = createExecutionManager(envVal ? envVal : "qir");
+  }
+  return qis_manager;
+}
+
+ExecutionManager *getExecutionManager() {
+  return getThreadExecutionManager().get();
+}
+
+void setExecutionManager(std::string_view name) {
+  getThreadExecutionManager() = createExecutionManager(name);
+}
+} // namespace cudaq
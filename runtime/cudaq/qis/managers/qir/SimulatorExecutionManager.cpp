@@ -0,0 +1,195 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "common/Logger.h"
+#include "cudaq/qis/managers/BasicExecutionManager.h"
+#include "cudaq/qis/qudit.h"
+#include "cudaq/spin_op.h"
+#include "nvqir/CircuitSimulator.h"
+#include <array>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace {
+
+/// @brief The operations the library-mode quantum instruction set emits.
+enum class GateKind : std::uint8_t {
+  h,
+  x,
+  y,
+  z,
+  t,
+  s,
+  tdg,
+  sdg,
+  rx,
+  ry,
+  rz,
+  r1,
+  swap,
+  cphase,
+  NumGates
+};
+
+constexpr std::array<std::string_view,
+                     static_cast<std::size_t>(GateKind::NumGates)>
+    gateNames{"h",  "x",  "y",  "z",  "t",  "s",    "tdg",
+              "sdg", "rx", "ry", "rz", "r1", "swap", "cphase"};
+
+GateKind toGateKind(std::string_view name) {
+  for (std::size_t i = 0; i < gateNames.size(); i++)
+    if (gateNames[i] == name)
+      return static_cast<GateKind>(i);
+  throw std::runtime_error("Invalid quantum operation for the simulator "
+                           "execution manager: " +
+                           std::string(name));
+}
+
+/// @brief A gate application, given the rotation parameters, the simulator
+/// indices of the controls and of the targets.
+using GateFunction = void (*)(nvqir::CircuitSimulator &,
+                              std::span<const double>,
+                              const std::vector<std::size_t> &,
+                              std::span<const std::size_t>);
+
+#define ONE_QUBIT_GATE(NAME)                                                   \
+  [](nvqir::CircuitSimulator &sim, std::span<const double>,                    \
+     const std::vector<std::size_t> &ctrls, std::span<const std::size_t> t) {  \
+    sim.NAME(ctrls, t[0]);                                                     \
+  }
+#define ONE_QUBIT_PARAM_GATE(NAME)                                             \
+  [](nvqir::CircuitSimulator &sim, std::span<const double> p,                  \
+     const std::vector<std::size_t> &ctrls, std::span<const std::size_t> t) {  \
+    sim.NAME(p[0], ctrls, t[0]);                                               \
+  }
+
+/// @brief The gate functions, indexed by GateKind.
+constexpr std::array<GateFunction, static_cast<std::size_t>(GateKind::NumGates)>
+    gateTable{
+        ONE_QUBIT_GATE(h),
+        ONE_QUBIT_GATE(x),
+        ONE_QUBIT_GATE(y),
+        ONE_QUBIT_GATE(z),
+        ONE_QUBIT_GATE(t),
+        ONE_QUBIT_GATE(s),
+        ONE_QUBIT_GATE(tdg),
+        ONE_QUBIT_GATE(sdg),
+        ONE_QUBIT_PARAM_GATE(rx),
+        ONE_QUBIT_PARAM_GATE(ry),
+        ONE_QUBIT_PARAM_GATE(rz),
+        ONE_QUBIT_PARAM_GATE(r1),
+        [](nvqir::CircuitSimulator &sim, std::span<const double>,
+           const std::vector<std::size_t> &ctrls,
+           std::span<const std::size_t> t) { sim.swap(ctrls, t[0], t[1]); },
+        // The first target is added to the controls, see executeInstruction.
+        [](nvqir::CircuitSimulator &sim, std::span<const double> p,
+           const std::vector<std::size_t> &ctrls,
+           std::span<const std::size_t> t) { sim.r1(p[0], ctrls, t[1]); }};
+
+#undef ONE_QUBIT_GATE
+#undef ONE_QUBIT_PARAM_GATE
+
+/// The SimulatorExecutionManager applies the quantum instructions directly on
+/// the NVQIR CircuitSimulator of the calling thread. Unlike the
+/// QIRExecutionManager, it allocates no QIR Qubit or Array per operation,
+/// the gates are dispatched through a table indexed by GateKind and the
+/// control indices are gathered in a reused buffer.
+class SimulatorExecutionManager : public cudaq::BasicExecutionManager {
+private:
+  /// @brief The simulator qubit index of each CUDA Quantum qudit id.
+  std::vector<std::size_t> simulatorIds;
+
+  /// @brief Scratch buffer for the control indices of the current operation.
+  std::vector<std::size_t> controlIds;
+
+  nvqir::CircuitSimulator &simulator() {
+    return *nvqir::getCircuitSimulatorInternal();
+  }
+
+protected:
+  void allocateQudit(const cudaq::QuditInfo &q) override {
+    if (q.id >= simulatorIds.size())
+      simulatorIds.resize(q.id + 1);
+    simulatorIds[q.id] = simulator().allocateQubit();
+  }
+
+  void deallocateQudit(std::size_t q) override {
+    simulator().deallocate(simulatorIds[q]);
+  }
+
+  void handleExecutionContextChanged() override {
+    if (executionContext)
+      simulator().setExecutionContext(executionContext);
+  }
+
+  void handleExecutionContextEnded() override {
+    simulator().resetExecutionContext();
+  }
+
+  void executeInstruction(const Instruction &instruction) override {
+    const auto &[gateName, params, controls, targets] = instruction;
+    auto gate = toGateKind(gateName);
+
+    controlIds.clear();
+    for (auto &c : controls)
+      controlIds.push_back(simulatorIds[c.id]);
+
+    std::array<std::size_t, 2> targetIds;
+    if (targets.size() > targetIds.size())
+      throw std::runtime_error("Invalid number of targets for " + gateName);
+    for (std::size_t i = 0; i < targets.size(); i++)
+      targetIds[i] = simulatorIds[targets[i].id];
+    // cphase is an r1 on the second target, controlled by the first.
+    if (gate == GateKind::cphase)
+      controlIds.push_back(targetIds[0]);
+
+    gateTable[static_cast<std::size_t>(gate)](
+        simulator(), params, controlIds, {targetIds.data(), targets.size()});
+  }
+
+  int measureQudit(const cudaq::QuditInfo &q) override {
+    return simulator().mz(simulatorIds[q.id], "") ? 1 : 0;
+  }
+
+public:
+  SimulatorExecutionManager() = default;
+  virtual ~SimulatorExecutionManager() {}
+
+  cudaq::SpinMeasureResult measure(cudaq::spin_op &op) override {
+    synchronize();
+    // Measure the first term of the operator, as the QIR measure does.
+    auto nQubits = op.n_qubits();
+    auto term = op.get_bsf()[0];
+    std::vector<Pauli> paulis(nQubits, Pauli_I);
+    for (std::size_t i = 0; i < nQubits; i++) {
+      if (term[i] && term[i + nQubits])
+        paulis[i] = Pauli_Y;
+      else if (term[i])
+        paulis[i] = Pauli_X;
+      else if (term[i + nQubits])
+        paulis[i] = Pauli_Z;
+    }
+    nvqir::measurePauliTerm(paulis);
+    auto exp = executionContext->expectationValue;
+    auto data = executionContext->result;
+    return std::make_pair(exp.value(), data);
+  }
+
+  void resetQudit(const cudaq::QuditInfo &id) override {
+    simulator().resetQubit(simulatorIds[id.id]);
+  }
+};
+
+} // namespace
+
+namespace cudaq {
+std::unique_ptr<ExecutionManager> createSimulatorExecutionManager() {
+  return std::make_unique<SimulatorExecutionManager>();
+}
+} // namespace cudaq
@@ -240,7 +240,7 @@ void swap(QubitArgs &...args) {
   constexpr std::size_t nArgs = sizeof...(QubitArgs);
   std::vector<QuditInfo> targetIds{qubitToQuditInfo(args)...};
   std::vector<QuditInfo> controls(targetIds.begin(),
-                                  targetIds.begin() + nArgs - 1);
+                                  targetIds.begin() + nArgs - 2);
   std::vector<QuditInfo> targets(targetIds.end() - 2, targetIds.end());
   getExecutionManager()->apply("swap", {}, controls, targets);
 }
@@ -14,72 +14,159 @@
 
 #include <Eigen/Dense>
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <complex>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <numeric>
+#include <optional>
 #include <random>
 #include <utility>
 #include <vector>
 
 namespace cudaq {
 
-/// @brief Compute the action
-/// @param term
-/// @param bitConfiguration
-/// @return
-std::pair<std::string, std::complex<double>>
-actionOnBra(spin_op &term, const std::string &bitConfiguration) {
-  auto coeff = term.get_coefficients()[0];
-  auto newConfiguration = bitConfiguration;
-  std::complex<double> i(0, 1);
-
-  term.for_each_pauli([&](pauli p, std::size_t idx) {
-    if (p == pauli::Z) {
-      coeff *= (newConfiguration[idx] == '1' ? -1 : 1);
-    } else if (p == pauli::X) {
-      newConfiguration[idx] = newConfiguration[idx] == '1' ? '0' : '1';
-    } else if (p == pauli::Y) {
-      coeff *= (newConfiguration[idx] == '1' ? i : -i);
-      newConfiguration[idx] = (newConfiguration[idx] == '1' ? '0' : '1');
+namespace {
+/// @brief A Pauli term acting on basis state indices, qubit i being bit
+/// (nQubits - 1 - i). The only nonzero of row r is in column r ^ xMask, with
+/// value coefficient * (-1)^popcount(r & zMask).
+struct IndexTerm {
+  std::uint64_t xMask;
+  std::uint64_t zMask;
+  std::complex<double> coefficient;
+};
+
+/// @brief Convert the terms of the given spin_op to index masks. The phase
+/// (-i)^#Y is folded into the coefficient: <r|Y|c> = -i * (-1)^r.
+std::vector<IndexTerm> getIndexTerms(const spin_op &op) {
+  const std::size_t n = op.n_qubits();
+  if (n >= 64)
+    throw std::runtime_error("Cannot compute the matrix of a spin_op on " +
+                             std::to_string(n) + " qubits.");
+
+  const std::complex<double> yPhases[4] = {1.0, {0, -1}, -1.0, {0, 1}};
+  std::vector<IndexTerm> indexTerms;
+  indexTerms.reserve(op.n_terms());
+  for (std::size_t t = 0; t < op.n_terms(); t++) {
+    auto term = op.get_term_view(t);
+    IndexTerm indexTerm{0, 0, term.get_coefficient()};
+    std::size_t nY = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      auto p = term.get_pauli(i);
+      const std::uint64_t bit = 1ULL << (n - 1 - i);
+      if (p == pauli::X || p == pauli::Y)
+        indexTerm.xMask |= bit;
+      if (p == pauli::Z || p == pauli::Y)
+        indexTerm.zMask |= bit;
+      nY += p == pauli::Y;
     }
-  });
+    indexTerm.coefficient *= yPhases[nY % 4];
+    indexTerms.push_back(indexTerm);
+  }
+  return indexTerms;
+}
 
-  return std::make_pair(newConfiguration, coeff);
+/// @brief Return the value of the given term in row r.
+inline std::complex<double> rowValue(const IndexTerm &term, std::uint64_t r) {
+  return std::popcount(r & term.zMask) % 2 ? -term.coefficient
+                                            : term.coefficient;
 }
+} // namespace
 
 complex_matrix spin_op::to_matrix() const {
-  auto n = n_qubits();
-  auto dim = 1UL << n;
-  auto getBitStrForIdx = [&](std::size_t i) {
-    std::stringstream s;
-    for (int k = n - 1; k >= 0; k--)
-      s << ((i >> k) & 1);
-    return s.str();
-  };
-
-  // To construct the matrix, we are looping over every
-  // row, computing the binary representation for that index,
-  // e.g <100110|, and then we will compute the action of
-  // each pauli term on that binary configuration, returning a new
-  // product state and coefficient. Call this new state <colState|,
-  // we then compute <rowState | Paulis | colState> and set it in the matrix
-  // data.
+  auto indexTerms = getIndexTerms(*this);
+  const std::size_t dim = 1UL << n_qubits();
 
+  // Every term has exactly one nonzero per row, in column row ^ xMask, so
+  // fill each row from the term masks.
   complex_matrix A(dim, dim);
   A.set_zero();
   auto rawData = A.data();
 #pragma omp parallel for shared(rawData)
+  for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++)
+    for (auto &term : indexTerms)
+      rawData[rowIdx * dim + (rowIdx ^ term.xMask)] += rowValue(term, rowIdx);
+  return A;
+}
+
+csr_spmatrix spin_op::to_sparse_matrix() const {
+  auto indexTerms = getIndexTerms(*this);
+  const std::size_t dim = 1UL << n_qubits();
+
+  // Terms with the same X mask share their nonzeros, sort the terms by X mask
+  // so that each row is built from contiguous runs.
+  std::stable_sort(
+      indexTerms.begin(), indexTerms.end(),
+      [](const IndexTerm &a, const IndexTerm &b) { return a.xMask < b.xMask; });
+
+  // Return the nonzeros of the given row, sorted by column.
+  using RowEntries = std::vector<std::pair<std::size_t, std::complex<double>>>;
+  auto computeRow = [&](std::size_t rowIdx, RowEntries &row) {
+    row.clear();
+    for (std::size_t t = 0; t < indexTerms.size();) {
+      const auto xMask = indexTerms[t].xMask;
+      std::complex<double> value = 0.0;
+      for (; t < indexTerms.size() && indexTerms[t].xMask == xMask; t++)
+        value += rowValue(indexTerms[t], rowIdx);
+      if (value != 0.0)
+        row.emplace_back(rowIdx ^ xMask, value);
+    }
+    std::sort(row.begin(), row.end(),
+              [](auto &a, auto &b) { return a.first < b.first; });
+  };
+
+  // First count the nonzeros per row, then fill them in place.
+  std::vector<std::size_t> rowOffsets(dim + 1, 0);
+#pragma omp parallel
+  {
+    RowEntries row;
+#pragma omp for
+    for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++) {
+      computeRow(rowIdx, row);
+      rowOffsets[rowIdx + 1] = row.size();
+    }
+  }
+  std::partial_sum(rowOffsets.begin(), rowOffsets.end(), rowOffsets.begin());
+
+  std::vector<std::complex<double>> values(rowOffsets.back());
+  std::vector<std::size_t> columns(rowOffsets.back());
+#pragma omp parallel
+  {
+    RowEntries row;
+#pragma omp for
+    for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++) {
+      computeRow(rowIdx, row);
+      for (std::size_t k = 0; k < row.size(); k++) {
+        columns[rowOffsets[rowIdx] + k] = row[k].first;
+        values[rowOffsets[rowIdx] + k] = row[k].second;
+      }
+    }
+  }
+
+  return std::make_tuple(std::move(values), std::move(columns),
+                         std::move(rowOffsets));
+}
+
+std::vector<std::complex<double>>
+spin_op::apply(const std::vector<std::complex<double>> &vec) const {
+  auto indexTerms = getIndexTerms(*this);
+  const std::size_t dim = 1UL << n_qubits();
+  if (vec.size() != dim)
+    throw std::runtime_error("spin_op::apply requires a vector of size " +
+                             std::to_string(dim) + ", got " +
+                             std::to_string(vec.size()) + ".");
+
+  std::vector<std::complex<double>> result(dim);
+#pragma omp parallel for
   for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++) {
-    auto rowBitStr = getBitStrForIdx(rowIdx);
-    for_each_term([&](spin_op &term) {
-      auto [res, coeff] = actionOnBra(term, rowBitStr);
-      auto colIdx = std::stol(res, nullptr, 2);
-      rawData[rowIdx * dim + colIdx] += coeff;
-    });
+    std::complex<double> sum = 0.0;
+    for (auto &term : indexTerms)
+      sum += rowValue(term, rowIdx) * vec[rowIdx ^ term.xMask];
+    result[rowIdx] = sum;
   }
-  return A;
+  return result;
 }
 
 void spin_op::for_each_term(std::function<void(spin_op &)> &&functor) const {
@@ -94,19 +181,9 @@ void spin_op::for_each_pauli(
     throw std::runtime_error(
         "spin_op::for_each_pauli on valid for spin_op with n_terms == 1.");
 
-  auto nQ = n_qubits();
-  auto bsf = get_bsf()[0];
-  for (std::size_t i = 0; i < nQ; i++) {
-    if (bsf[i] && bsf[i + nQ]) {
-      functor(pauli::Y, i);
-    } else if (bsf[i]) {
-      functor(pauli::X, i);
-    } else if (bsf[i + nQ]) {
-      functor(pauli::Z, i);
-    } else {
-      functor(pauli::I, i);
-    }
-  }
+  auto term = get_term_view(0);
+  for (std::size_t i = 0; i < m_n_qubits; i++)
+    functor(term.get_pauli(i), i);
 }
 
 spin_op spin_op::random(std::size_t nQubits, std::size_t nTerms) {
@@ -124,91 +201,158 @@ spin_op spin_op::random(std::size_t nQubits, std::size_t nTerms) {
   return cudaq::spin_op::from_binary_symplectic(randomTerms, coeff);
 }
 
+std::size_t spin_op::hashTerm(const std::uint64_t *words) const {
+  std::size_t seed = 0;
+  for (std::size_t w = 0; w < 2 * nWords; w++)
+    seed ^= std::hash<std::uint64_t>{}(words[w]) + 0x9e3779b97f4a7c15ULL +
+            (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+std::size_t spin_op::findTerm(const std::uint64_t *words) const {
+  auto [first, last] = termIndex.equal_range(hashTerm(words));
+  for (auto it = first; it != last; ++it)
+    if (std::equal(words, words + 2 * nWords, termWords(it->second)))
+      return it->second;
+  return n_terms();
+}
+
+std::size_t spin_op::addTerm(const std::uint64_t *words,
+                             const std::complex<double> coeff) {
+  auto slot = findTerm(words);
+  if (slot != n_terms()) {
+    coefficients[slot] += coeff;
+    return slot;
+  }
+
+  terms.insert(terms.end(), words, words + 2 * nWords);
+  coefficients.push_back(coeff);
+  termIndex.emplace(hashTerm(words), slot);
+  return slot;
+}
+
+void spin_op::addTerm(const std::vector<bool> &row,
+                      const std::complex<double> coeff) {
+  std::vector<std::uint64_t> words(2 * nWords, 0);
+  for (std::size_t i = 0; i < m_n_qubits; i++) {
+    if (row[i])
+      words[i / 64] |= 1ULL << (i % 64);
+    if (row[i + m_n_qubits])
+      words[nWords + i / 64] |= 1ULL << (i % 64);
+  }
+  terms.insert(terms.end(), words.begin(), words.end());
+  coefficients.push_back(coeff);
+  termIndex.emplace(hashTerm(words.data()), coefficients.size() - 1);
+}
+
+void spin_op::removeZeroTerms() {
+  std::size_t kept = 0;
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    if (std::abs(coefficients[t]) < 1e-12)
+      continue;
+    if (kept != t) {
+      std::copy_n(termWords(t), 2 * nWords, terms.begin() + 2 * nWords * kept);
+      coefficients[kept] = coefficients[t];
+    }
+    kept++;
+  }
+
+  if (kept == n_terms())
+    return;
+  terms.resize(2 * nWords * kept);
+  coefficients.resize(kept);
+  rebuildIndex();
+}
+
+void spin_op::rebuildIndex() {
+  termIndex.clear();
+  termIndex.reserve(n_terms());
+  for (std::size_t t = 0; t < n_terms(); t++)
+    termIndex.emplace(hashTerm(termWords(t)), t);
+}
+
 void spin_op::expandToNQubits(const std::size_t n_q) {
-  for (auto &row : data) {
-    std::vector<bool> tmp(n_q * 2);
-    for (std::size_t k = 0; k < m_n_qubits; k++)
-      if (row[k] && row[k + m_n_qubits]) {
-        tmp[k] = 1;
-        tmp[k + n_q] = 1;
-      } else if (row[k])
-        tmp[k] = row[k];
-      else if (row[k + m_n_qubits])
-        tmp[k + n_q] = true;
-    row = tmp;
+  const std::size_t newWords = (n_q + 63) / 64;
+  if (newWords != nWords) {
+    std::vector<std::uint64_t> expanded(2 * newWords * n_terms(), 0);
+    for (std::size_t t = 0; t < n_terms(); t++) {
+      auto *src = termWords(t);
+      auto *dst = expanded.data() + 2 * newWords * t;
+      std::copy_n(src, nWords, dst);
+      std::copy_n(src + nWords, nWords, dst + newWords);
+    }
+    terms = std::move(expanded);
+    nWords = newWords;
+    rebuildIndex();
   }
   m_n_qubits = n_q;
 }
 
 spin_op::spin_op() {
+  // Should initialize with a 1 qubit Identity.
+  terms.assign(2 * nWords, 0);
   coefficients.push_back(1.0);
-  // Should initialize with 2 elements for a 1 qubit Identity.
-  data.push_back(std::vector<bool>(2));
+  rebuildIndex();
 }
 
 spin_op::spin_op(BinarySymplecticForm d,
-                 std::vector<std::complex<double>> coeffs)
-    : data(d), coefficients(coeffs) {
-  m_n_qubits = data[0].size() / 2.;
+                 std::vector<std::complex<double>> coeffs) {
+  m_n_qubits = d[0].size() / 2.;
+  nWords = (m_n_qubits + 63) / 64;
+  if (nWords == 0)
+    nWords = 1;
+  terms.reserve(2 * nWords * d.size());
+  coefficients.reserve(d.size());
+  for (std::size_t t = 0; t < d.size(); t++)
+    addTerm(d[t], coeffs[t]);
 }
 
 spin_op::spin_op(pauli type, const std::size_t idx,
                  std::complex<double> coeff) {
   m_n_qubits = idx + 1;
-  [[maybe_unused]] int p = 0;
-  data.push_back(std::vector<bool>(2 * m_n_qubits));
-  if (type == pauli::X) {
-    data.back()[idx] = true;
-  } else if (type == pauli::Y) {
-    p++;
-    data.back()[idx] = true;
-    data.back()[idx + m_n_qubits] = true;
-  } else if (type == pauli::Z) {
-    data.back()[idx + m_n_qubits] = true;
-  }
+  nWords = (m_n_qubits + 63) / 64;
+  terms.assign(2 * nWords, 0);
+  const std::uint64_t bit = 1ULL << (idx % 64);
+  if (type == pauli::X || type == pauli::Y)
+    terms[idx / 64] |= bit;
+  if (type == pauli::Z || type == pauli::Y)
+    terms[nWords + idx / 64] |= bit;
 
   coefficients.push_back(coeff);
+  rebuildIndex();
 }
 
 spin_op::spin_op(const spin_op &o)
-    : data(o.data), coefficients(o.coefficients), m_n_qubits(o.m_n_qubits) {}
+    : nWords(o.nWords), terms(o.terms), coefficients(o.coefficients),
+      m_n_qubits(o.m_n_qubits), termIndex(o.termIndex) {}
 
 spin_op &spin_op::operator+=(const spin_op &v) noexcept {
-  spin_op tmpv = v;
-  if (v.m_n_qubits > m_n_qubits) {
+  if (v.m_n_qubits > m_n_qubits)
     // If we are adding a op that has more qubits than we do
     // then we need to resize, making sure to ensure the
     // correct 1/0 positions.
     expandToNQubits(v.m_n_qubits);
-  } else if (v.m_n_qubits < m_n_qubits) {
-    tmpv.expandToNQubits(m_n_qubits);
-  }
 
-  // Add the rows from v to this, if
-  // the row already exists, we should just add the coeffs
-  for (auto [i, row] : enumerate(tmpv.data)) {
-    auto it = std::find(data.begin(), data.end(), row);
-    if (it != data.end()) {
-      auto idx = std::distance(data.begin(), it);
-      coefficients[idx] += tmpv.coefficients[i];
-    } else {
-      data.push_back(row);
-      coefficients.push_back(tmpv.coefficients[i]);
-    }
+  // Add the rows from v to this, if the row already exists, we should just
+  // add the coeffs. The words of v are zero-padded if it is on fewer qubits.
+  const spin_op *other = &v;
+  std::optional<spin_op> tmpv;
+  if (this == &v || v.nWords != nWords) {
+    tmpv.emplace(v);
+    tmpv->expandToNQubits(m_n_qubits);
+    other = &*tmpv;
   }
 
-  // mark any rows for deletion if coeff = (0,0)
-  std::vector<int> marked;
-  for (std::size_t i = 0; i < data.size(); i++)
-    if (std::abs(coefficients[i]) < 1e-12)
-      marked.push_back(i);
-
-  std::sort(marked.begin(), marked.end(), std::greater<int>());
-  for (auto m : marked) {
-    data.erase(data.begin() + m);
-    coefficients.erase(coefficients.begin() + m);
+  bool hasZeros = false;
+  for (std::size_t i = 0; i < other->n_terms(); i++) {
+    auto slot = addTerm(other->termWords(i), other->coefficients[i]);
+    hasZeros |= std::abs(coefficients[slot]) < 1e-12;
   }
 
+  // remove any rows with coeff = (0,0)
+  if (hasZeros)
+    removeZeroTerms();
+
   return *this;
 }
 
@@ -217,11 +361,13 @@ std::vector<std::complex<double>> spin_op::get_coefficients() const {
 }
 
 spin_op spin_op::operator[](const std::size_t term_idx) const {
-  std::vector<bool> term_data = data[term_idx];
-  auto term_coeff = coefficients[term_idx];
-  BinarySymplecticForm f{term_data};
-  std::vector<std::complex<double>> c{term_coeff};
-  return spin_op(f, c);
+  spin_op term;
+  term.m_n_qubits = m_n_qubits;
+  term.nWords = nWords;
+  term.terms.assign(termWords(term_idx), termWords(term_idx) + 2 * nWords);
+  term.coefficients[0] = coefficients[term_idx];
+  term.rebuildIndex();
+  return term;
 }
 
 spin_op &spin_op::operator-=(const spin_op &v) noexcept {
@@ -235,87 +381,64 @@ spin_op &spin_op::operator*=(const spin_op &v) noexcept {
     // then we need to resize, making sure to ensure the
     // correct 1/0 positions.
     expandToNQubits(v.m_n_qubits);
-  } else if (v.m_n_qubits < m_n_qubits) {
-    copy.expandToNQubits(m_n_qubits);
   }
-
-  int counter = 0;
-  for (auto &row : data) {
-    int inner_counter = 0;
-    for (auto &other_row : copy.data) {
-      // This is term * otherTerm
-      std::vector<bool> tmp(2 * m_n_qubits), tmp2(2 * m_n_qubits);
-      for (std::size_t i = 0; i < 2 * m_n_qubits; i++)
-        tmp[i] = row[i] ^ other_row[i];
-
-      for (std::size_t i = 0; i < m_n_qubits; i++)
-        tmp2[i] = row[i] && other_row[m_n_qubits + i];
-
-      int orig_phase = 0, other_phase = 0;
-      for (std::size_t i = 0; i < m_n_qubits; i++) {
-        if (row[i] && row[i + m_n_qubits])
-          orig_phase++;
-
-        if (other_row[i] && other_row[i + m_n_qubits])
-          other_phase++;
+  copy.expandToNQubits(m_n_qubits);
+
+  // The product of two Paulis strings is the XOR of their words, up to a
+  // phase i^k with k = #Y(lhs) + #Y(rhs) + 2 |X(lhs) & Z(rhs)| - #Y(result).
+  const std::complex<double> imaginary(0, 1);
+  const std::complex<double> phaseCoeffs[4] = {1.0, -1. * imaginary, -1.0,
+                                               imaginary};
+  spin_op result;
+  result.m_n_qubits = m_n_qubits;
+  result.nWords = nWords;
+  result.terms.clear();
+  result.coefficients.clear();
+  result.termIndex.clear();
+  result.terms.reserve(2 * nWords * n_terms() * copy.n_terms());
+  result.coefficients.reserve(n_terms() * copy.n_terms());
+
+  std::vector<std::uint64_t> product(2 * nWords);
+  bool hasZeros = false;
+  for (std::size_t i = 0; i < n_terms(); i++) {
+    const auto *row = termWords(i);
+    for (std::size_t j = 0; j < copy.n_terms(); j++) {
+      const auto *otherRow = copy.termWords(j);
+      int phase = 0;
+      for (std::size_t w = 0; w < nWords; w++) {
+        auto x = row[w] ^ otherRow[w];
+        auto z = row[w + nWords] ^ otherRow[w + nWords];
+        product[w] = x;
+        product[w + nWords] = z;
+        phase += std::popcount(row[w] & row[w + nWords]) +
+                 std::popcount(otherRow[w] & otherRow[w + nWords]) +
+                 2 * std::popcount(row[w] & otherRow[w + nWords]) -
+                 std::popcount(x & z);
       }
-
-      auto _phase = orig_phase + other_phase;
-      int sum = 0;
-      for (auto a : tmp2)
-        if (a)
-          sum++;
-
-      _phase += 2 * sum;
-      // Based on the phase, figure out an extra coeff to apply
-      for (std::size_t i = 0; i < m_n_qubits; i++)
-        if (tmp[i] && tmp[i + m_n_qubits])
-          _phase -= 1;
-
-      _phase %= 4;
-      std::complex<double> imaginary(0, 1);
-      std::map<int, std::complex<double>> phase_coeff_map{
-          {0, 1.0}, {1, -1. * imaginary}, {2, -1.0}, {3, imaginary}};
-      auto phase_coeff = phase_coeff_map[_phase];
-      coefficients[counter] *= phase_coeff * copy.coefficients[inner_counter];
-      inner_counter++;
-      row = tmp;
+      auto coeff = phaseCoeffs[((phase % 4) + 4) % 4] * coefficients[i] *
+                   copy.coefficients[j];
+      auto slot = result.addTerm(product.data(), coeff);
+      hasZeros |= std::abs(result.coefficients[slot]) < 1e-12;
     }
-    counter++;
   }
+
+  if (hasZeros)
+    result.removeZeroTerms();
+  *this = std::move(result);
   return *this;
 }
 
 bool spin_op::is_identity() const {
-  for (auto &row : data)
-    for (auto e : row)
-      if (e)
-        return false;
-
-  return true;
+  return std::all_of(terms.begin(), terms.end(),
+                     [](std::uint64_t w) { return w == 0; });
 }
 
 bool spin_op::operator==(const spin_op &v) const noexcept {
   // Could be that the term is identity with all zeros
-  bool isId1 = true, isId2 = true;
-  for (auto &row : data)
-    for (auto e : row)
-      if (e) {
-        isId1 = false;
-        break;
-      }
-
-  for (auto &row : v.data)
-    for (auto e : row)
-      if (e) {
-        isId2 = false;
-        break;
-      }
-
-  if (isId1 && isId2)
+  if (is_identity() && v.is_identity())
     return true;
 
-  return data == v.data;
+  return m_n_qubits == v.m_n_qubits && nWords == v.nWords && terms == v.terms;
 }
 
 spin_op &spin_op::operator*=(const double v) noexcept {
@@ -332,7 +455,7 @@ spin_op &spin_op::operator*=(const std::complex<double> v) noexcept {
 }
 
 std::size_t spin_op::n_qubits() const { return m_n_qubits; }
-std::size_t spin_op::n_terms() const { return data.size(); }
+std::size_t spin_op::n_terms() const { return coefficients.size(); }
 std::complex<double>
 spin_op::get_term_coefficient(const std::size_t idx) const {
   return coefficients[idx];
@@ -345,51 +468,36 @@ spin_op spin_op::slice(const std::size_t startIdx, const std::size_t count) {
                              std::to_string(count) + " terms on spin_op with " +
                              std::to_string(nTerms) + " terms.");
 
-  std::vector<std::complex<double>> newCoeffs;
-  BinarySymplecticForm newData;
+  spin_op newOp;
+  newOp.m_n_qubits = m_n_qubits;
+  newOp.nWords = nWords;
+  newOp.terms.clear();
+  newOp.coefficients.clear();
   for (std::size_t i = startIdx; i < startIdx + count; ++i) {
-    if (i == data.size())
+    if (i == n_terms())
       break;
-    newData.push_back(data[i]);
-    newCoeffs.push_back(coefficients[i]);
+    newOp.terms.insert(newOp.terms.end(), termWords(i),
+                       termWords(i) + 2 * nWords);
+    newOp.coefficients.push_back(coefficients[i]);
   }
-  return spin_op(newData, newCoeffs);
+  newOp.rebuildIndex();
+  return newOp;
 }
 
 std::string spin_op::to_string(bool printCoeffs) const {
-  if (data.empty())
+  if (n_terms() == 0)
     return "";
 
-  auto first = data[0];
+  static constexpr char pauliChars[] = {'I', 'X', 'Y', 'Z'};
   std::stringstream ss;
-  if (printCoeffs)
-    ss << coefficients[0] << " ";
-  for (std::size_t i = 0; i < m_n_qubits; i++) {
-    if (first[i] && first[i + m_n_qubits])
-      ss << "Y" << i;
-    else if (first[i])
-      ss << "X" << i;
-    else if (first[i + m_n_qubits])
-      ss << "Z" << i;
-    else
-      ss << "I" << i;
-  }
-
-  for (std::size_t j = 1; j < data.size(); j++) {
-    ss << " + ";
-    first = data[j];
+  for (std::size_t j = 0; j < n_terms(); j++) {
+    if (j > 0)
+      ss << " + ";
     if (printCoeffs)
       ss << coefficients[j] << " ";
-    for (std::size_t i = 0; i < m_n_qubits; i++) {
-      if (first[i] && first[i + m_n_qubits])
-        ss << "Y" << i;
-      else if (first[i])
-        ss << "X" << i;
-      else if (first[i + m_n_qubits])
-        ss << "Z" << i;
-      else
-        ss << "I" << i;
-    }
+    auto term = get_term_view(j);
+    for (std::size_t i = 0; i < m_n_qubits; i++)
+      ss << pauliChars[static_cast<int>(term.get_pauli(i))] << i;
   }
 
   return ss.str();
@@ -407,6 +515,7 @@ spin_op::spin_op(std::vector<double> &input_vec, std::size_t nQubits) {
                              "spin_op. Number of data elements is incorrect.");
 
   m_n_qubits = nQubits;
+  nWords = std::max<std::size_t>(1, (m_n_qubits + 63) / 64);
   for (std::size_t i = 0; i < input_vec.size() - 1; i += m_n_qubits + 2) {
     std::vector<bool> tmpv(2 * m_n_qubits);
     for (std::size_t j = 0; j < m_n_qubits; j++) {
@@ -425,19 +534,30 @@ spin_op::spin_op(std::vector<double> &input_vec, std::size_t nQubits) {
         tmpv[j] = 1;
       }
     }
-    data.push_back(tmpv);
     auto el_real = input_vec[i + m_n_qubits];
     auto el_imag = input_vec[i + m_n_qubits + 1];
-    coefficients.emplace_back(el_real, el_imag);
+    addTerm(tmpv, {el_real, el_imag});
   }
 }
 
-spin_op::BinarySymplecticForm spin_op::get_bsf() const { return data; }
+spin_op::BinarySymplecticForm spin_op::get_bsf() const {
+  BinarySymplecticForm data(n_terms(), std::vector<bool>(2 * m_n_qubits));
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    const auto *words = termWords(t);
+    for (std::size_t i = 0; i < m_n_qubits; i++) {
+      data[t][i] = (words[i / 64] >> (i % 64)) & 1;
+      data[t][i + m_n_qubits] = (words[nWords + i / 64] >> (i % 64)) & 1;
+    }
+  }
+  return data;
+}
 
 spin_op &spin_op::operator=(const spin_op &other) {
-  data = other.data;
+  nWords = other.nWords;
+  terms = other.terms;
   coefficients = other.coefficients;
   m_n_qubits = other.m_n_qubits;
+  termIndex = other.termIndex;
   return *this;
 }
 
@@ -455,23 +575,24 @@ spin_op z(const std::size_t idx) { return spin_op(pauli::Z, idx); }
 
 std::vector<double> spin_op::getDataRepresentation() {
   std::vector<double> dataVec;
-  int counter = 0;
-  for (auto &term : data) {
-    auto nq = n_qubits();
+  auto nq = n_qubits();
+  dataVec.reserve(n_terms() * (nq + 2) + 1);
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    auto term = get_term_view(t);
     for (std::size_t i = 0; i < nq; i++) {
-      if (term[i] && term[i + nq]) {
+      auto p = term.get_pauli(i);
+      if (p == pauli::Y) {
         dataVec.push_back(3.);
-      } else if (term[i]) {
+      } else if (p == pauli::X) {
         dataVec.push_back(1.);
-      } else if (term[i + nq]) {
+      } else if (p == pauli::Z) {
         dataVec.push_back(2.);
       } else {
         dataVec.push_back(0.);
       }
     }
-    dataVec.push_back(coefficients[counter].real());
-    dataVec.push_back(coefficients[counter].imag());
-    counter++;
+    dataVec.push_back(coefficients[t].real());
+    dataVec.push_back(coefficients[t].imag());
   }
   dataVec.push_back(n_terms());
   return dataVec;
@@ -11,8 +11,11 @@
 
 #include "matrix.h"
 #include "utils/cudaq_utils.h"
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <tuple>
+#include <unordered_map>
 
 // Define friend functions for operations between spin_op and scalars.
 #define CUDAQ_SPIN_SCALAR_OPERATIONS(op, U)                                    \
@@ -98,6 +101,13 @@ spin_op y(const std::size_t idx);
 spin_op z(const std::size_t idx);
 } // namespace spin
 
+/// @brief A sparse matrix in compressed sparse row format: the nonzero
+/// values, their column indices, and the offset of each row's first nonzero
+/// (with a final entry holding the number of nonzeros).
+using csr_spmatrix = std::tuple<std::vector<std::complex<double>>,
+                                std::vector<std::size_t>,
+                                std::vector<std::size_t>>;
+
 /// @brief The spin_op represents a general sum of pauli tensor products.
 /// It exposes the typical algebraic operations that allow programmers to
 /// define primitive pauli operators and use them to compose larger, more
@@ -118,8 +128,14 @@ private:
   /// and X=0, Z=1 -> Z on site i.
   using BinarySymplecticForm = std::vector<std::vector<bool>>;
 
-  /// @brief The spin_op representation
-  BinarySymplecticForm data;
+  /// @brief The number of 64-bit words holding the X (or the Z) bits of a
+  /// term.
+  std::size_t nWords = 1;
+
+  /// @brief The packed binary symplectic terms. Term t is stored as nWords X
+  /// words followed by nWords Z words, starting at 2 * nWords * t. Qubit i is
+  /// bit i % 64 of word i / 64.
+  std::vector<std::uint64_t> terms;
 
   /// @brief The coefficients for each term in the spin_op
   std::vector<std::complex<double>> coefficients;
@@ -127,9 +143,36 @@ private:
   /// @brief The number of qubits this spin_op is on
   std::size_t m_n_qubits = 1;
 
-  /// @brief Utility map that takes the pauli enum to a string representation
-  std::map<pauli, std::string> pauli_to_str{
-      {pauli::I, "I"}, {pauli::X, "X"}, {pauli::Y, "Y"}, {pauli::Z, "Z"}};
+  /// @brief Index from the hash of a term's words to its slot, used to merge
+  /// equal terms in constant time.
+  std::unordered_multimap<std::size_t, std::size_t> termIndex;
+
+  /// @brief Return a pointer to the 2 * nWords words of the given term.
+  const std::uint64_t *termWords(const std::size_t termIdx) const {
+    return terms.data() + 2 * nWords * termIdx;
+  }
+
+  /// @brief Return the hash of the given term words.
+  std::size_t hashTerm(const std::uint64_t *words) const;
+
+  /// @brief Return the slot of the term with the given words, or n_terms()
+  /// if there is no such term.
+  std::size_t findTerm(const std::uint64_t *words) const;
+
+  /// @brief Add coeff to the term with the given words, appending the term if
+  /// it is not present yet. Return the term slot.
+  std::size_t addTerm(const std::uint64_t *words,
+                      const std::complex<double> coeff);
+
+  /// @brief Append a term given as a binary symplectic row.
+  void addTerm(const std::vector<bool> &row, const std::complex<double> coeff);
+
+  /// @brief Remove the terms with a zero coefficient, keeping the order of
+  /// the remaining terms.
+  void removeZeroTerms();
+
+  /// @brief Recompute the term index from the packed terms.
+  void rebuildIndex();
 
   /// @brief Expand this spin_op binary symplectic representation to
   /// a larger number of qubits.
@@ -144,6 +187,51 @@ private:
   spin_op(BinarySymplecticForm bsf, std::vector<std::complex<double>> coeffs);
 
 public:
+  /// @brief A non-owning view of a single term of a spin_op. It stays valid
+  /// until the spin_op it was taken from is modified.
+  class term_view {
+  private:
+    const std::uint64_t *words;
+    std::size_t nWords;
+    std::size_t nQubits;
+    std::complex<double> coefficient;
+
+  public:
+    term_view(const std::uint64_t *w, std::size_t nW, std::size_t nQ,
+              std::complex<double> c)
+        : words(w), nWords(nW), nQubits(nQ), coefficient(c) {}
+
+    /// @brief Return the X bits of qubits [64 * w, 64 * w + 64).
+    std::uint64_t x_word(std::size_t w) const { return words[w]; }
+
+    /// @brief Return the Z bits of qubits [64 * w, 64 * w + 64).
+    std::uint64_t z_word(std::size_t w) const { return words[nWords + w]; }
+
+    /// @brief Return the number of X (or Z) words.
+    std::size_t n_words() const { return nWords; }
+
+    /// @brief Return the number of qubits of the spin_op.
+    std::size_t n_qubits() const { return nQubits; }
+
+    /// @brief Return the term coefficient.
+    std::complex<double> get_coefficient() const { return coefficient; }
+
+    /// @brief Return the Pauli acting on the given qubit.
+    pauli get_pauli(std::size_t qubit) const {
+      bool x = (x_word(qubit / 64) >> (qubit % 64)) & 1;
+      bool z = (z_word(qubit / 64) >> (qubit % 64)) & 1;
+      return x ? (z ? pauli::Y : pauli::X) : (z ? pauli::Z : pauli::I);
+    }
+
+    /// @brief Return true if this term is the identity.
+    bool is_identity() const {
+      for (std::size_t w = 0; w < 2 * nWords; w++)
+        if (words[w])
+          return false;
+      return true;
+    }
+  };
+
   /// @brief Return a new spin_op from the user-provided binary symplectic data.
   static spin_op
   from_binary_symplectic(BinarySymplecticForm &data,
@@ -160,6 +248,9 @@ public:
   /// @brief Copy constructor
   spin_op(const spin_op &o);
 
+  /// @brief Move constructor
+  spin_op(spin_op &&o) = default;
+
   /// @brief Construct this spin_op from a serialized representation.
   /// Specifically, this encoding is via a vector of doubles. The encoding is
   /// as follows: for each term, a list of doubles where the ith element is
@@ -175,6 +266,9 @@ public:
   /// @brief Set the provided spin_op equal to this one and return *this.
   spin_op &operator=(const spin_op &);
 
+  /// @brief Move the provided spin_op into this one and return *this.
+  spin_op &operator=(spin_op &&) = default;
+
   /// @brief Add the given spin_op to this one and return *this
   spin_op &operator+=(const spin_op &v) noexcept;
 
@@ -225,6 +319,13 @@ public:
   /// @brief Return the ith term of this spin_op (by value).
   spin_op operator[](const std::size_t termIdx) const;
 
+  /// @brief Return a view of the ith term of this spin_op, without copying
+  /// the term.
+  term_view get_term_view(const std::size_t termIdx) const {
+    return term_view(termWords(termIdx), nWords, m_n_qubits,
+                     coefficients[termIdx]);
+  }
+
   /// @brief Return the number of qubits this spin_op is on
   std::size_t n_qubits() const;
 
@@ -270,6 +371,18 @@ public:
   /// @brief Return a dense matrix representation of this
   /// spin_op.
   complex_matrix to_matrix() const;
+
+  /// @brief Return the sparse (CSR) matrix representation of this spin_op.
+  /// Element (row, col) is <row|H|col>, and qubit 0 is the most significant
+  /// bit of the index. Each Pauli term contributes a single nonzero per row.
+  /// Note that to_matrix()(i, j) is <j|H|i>, the transpose: for Y, the sparse
+  /// element (0, 1) is -i while to_matrix()(0, 1) is i.
+  csr_spmatrix to_sparse_matrix() const;
+
+  /// @brief Return H * vec without forming the matrix of this spin_op. The
+  /// vector uses the to_matrix() basis ordering and has 2^n_qubits elements.
+  std::vector<std::complex<double>>
+  apply(const std::vector<std::complex<double>> &vec) const;
 };
 
 /// @brief Add a double and a spin_op
@@ -9,14 +9,18 @@
 #pragma once
 
 #include "Gates.h"
+#include "InlineVector.h"
 #include "QIRTypes.h"
 #include "common/Logger.h"
 #include "common/MeasureCounts.h"
 #include "common/NoiseModel.h"
+#include "common/ObserveResult.h"
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstddef>
-#include <queue>
+#include <cstdlib>
+#include <span>
 #include <sstream>
 #include <string>
 
@@ -52,8 +56,10 @@ public:
   virtual void setNoiseModel(cudaq::noise_model &noise) = 0;
 
   /// @brief Compute the expected value of the given spin op
-  /// with respect to the current state, <psi | H | psi>.
-  virtual cudaq::ExecutionResult observe(const cudaq::spin_op &term) = 0;
+  /// with respect to the current state, <psi | H | psi>. The result also
+  /// carries the expectation value of each term, registered under the term
+  /// string.
+  virtual cudaq::observe_result observe(const cudaq::spin_op &term) = 0;
 
   /// @brief Allocate a single qubit, return the qubit as a logical index
   virtual std::size_t allocateQubit() = 0;
@@ -238,21 +244,47 @@ protected:
 
   /// @brief A GateApplicationTask consists of a
   /// matrix describing the quantum operation, a set of
-  /// possible control qubit indices, and a set of target indices.
+  /// possible control qubit indices, a set of target indices, and the
+  /// rotation angles of parameterized gates.
+  /// Gates on up to two targets and four controls are stored inline, so
+  /// enqueueing them does not allocate.
   struct GateApplicationTask {
-    const std::string operationName;
-    const std::vector<std::complex<ScalarType>> matrix;
-    const std::vector<std::size_t> controls;
-    const std::vector<std::size_t> targets;
-    GateApplicationTask(const std::string &name,
-                        const std::vector<std::complex<ScalarType>> &m,
-                        const std::vector<std::size_t> &c,
-                        const std::vector<std::size_t> &t)
-        : operationName(name), matrix(m), controls(c), targets(t) {}
+    GateName gate;
+    InlineVector<std::complex<ScalarType>, 16> matrix;
+    InlineVector<std::size_t, 4> controls;
+    InlineVector<std::size_t, 4> targets;
+    InlineVector<ScalarType, 3> parameters;
+    template <typename MatrixRange>
+    GateApplicationTask(GateName g, const MatrixRange &m,
+                        std::span<const std::size_t> c,
+                        std::span<const std::size_t> t,
+                        std::span<const ScalarType> p = {})
+        : gate(g), matrix(m), controls(c), targets(t), parameters(p) {}
+
+    /// @brief The operation name, e.g. for noise model lookups.
+    std::string_view operationName() const { return getGateName(gate); }
   };
 
-  /// @brief The current queue of operations to execute
-  std::queue<GateApplicationTask> gateQueue;
+  /// @brief The current queue of operations to execute. This is a vector
+  /// that is cleared (not deallocated) on flush, so its storage is reused.
+  std::vector<GateApplicationTask> gateQueue;
+
+  /// @brief Every operation enqueued under the "adjoint-gradient" and
+  /// "gate-parameters" contexts, in program order. Unlike the gate queue
+  /// this is not cleared on flush, the adjoint gradient sweeps it backwards.
+  std::vector<GateApplicationTask> gateTape;
+
+  /// @brief True if enqueued operations are to be recorded on the gate tape.
+  bool recordGateTape = false;
+
+  /// @brief True if qubits are allocated without growing the state. Set
+  /// under the "gate-parameters" context if it starts without qubits, only
+  /// the gate tape is recorded then and the state is never simulated.
+  bool skipStateAllocation = false;
+
+  /// @brief The maximum number of qubits a fused gate may act on, 0 disables
+  /// gate fusion. Defaults to the CUDAQ_FUSION_MAX_QUBITS environment variable.
+  std::size_t fusionMaxQubits = 0;
 
   /// @brief Get the name of the current circuit being executed.
   std::string getCircuitName() const { return currentCircuitName; }
@@ -267,6 +299,19 @@ protected:
   /// This is subclass specific.
   virtual void addQubitToState() = 0;
 
+  /// @brief Add `count` new qubits to the state representation, where
+  /// nQubitsAllocated and stateDimension already account for them. By default
+  /// this grows the state one qubit at a time, subtypes should override it to
+  /// grow the state in a single step.
+  virtual void addQubitsToState(const std::size_t count) {
+    nQubitsAllocated -= count;
+    for (std::size_t i = 0; i < count; i++) {
+      nQubitsAllocated++;
+      stateDimension = calculateStateDim(nQubitsAllocated);
+      addQubitToState();
+    }
+  }
+
   /// @brief Subclass specific part of resetQubitState().
   /// It will be invoked by resetQubitState()
   virtual void resetQubitStateImpl() = 0;
@@ -287,10 +332,20 @@ protected:
   /// basis quantum gates to change to the Z basis and sample.
   virtual bool canHandleObserve() { return false; }
 
+  /// @brief Seed the random number generator used for measurements and
+  /// sampling. Simulators without a seedable generator ignore it.
+  virtual void setRandomSeed(std::size_t seed) {}
+
   /// @brief Return the internal state representation. This
   /// is meant for subtypes to override
   virtual cudaq::State getStateData() { return {}; }
 
+  /// @brief Return the internal state representation, handing the state
+  /// buffer over rather than copying it. This is only called when the state
+  /// is reset right after, i.e. all the qubits are released. Subtypes that
+  /// can give up their buffer override this, the default copies it.
+  virtual cudaq::State takeStateData() { return getStateData(); }
+
   /// @brief Handle basic sampling tasks by storing the qubit index for
   /// processing in resetExecutionContext. Return true to indicate this is
   /// sampling and to exit early. False otherwise.
@@ -363,9 +418,9 @@ protected:
   /// @brief Utility function that returns a string-view of the current
   /// quantum instruction, intended for logging purposes.
   std::string gateToString(const std::string_view gateName,
-                           const std::vector<std::size_t> &controls,
-                           const std::vector<ScalarType> &parameters,
-                           const std::vector<std::size_t> &targets) {
+                           std::span<const std::size_t> controls,
+                           std::span<const ScalarType> parameters,
+                           std::span<const std::size_t> targets) {
     std::string angleStr = "";
     if (!parameters.empty()) {
       angleStr = std::to_string(parameters[0]);
@@ -433,11 +488,17 @@ protected:
         }
 
         cudaq::ExecutionResult tmp(regName);
-        for (auto &[bits, count] : execResult.counts) {
-          std::string b = "";
-          for (auto &qb : qubits)
-            b += bits[qubitLocMap[qb]];
-          tmp.appendResult(b, count);
+        auto &counts = execResult.counts;
+        std::vector<std::uint64_t> b((qubits.size() + 63) / 64);
+        for (std::size_t i = 0; i < counts.size(); i++) {
+          const auto *bits = counts.bits(i);
+          std::fill(b.begin(), b.end(), 0);
+          for (std::size_t j = 0; j < qubits.size(); j++) {
+            auto loc = qubitLocMap[qubits[j]];
+            if ((bits[loc / 64] >> (loc % 64)) & 1ULL)
+              b[j / 64] |= 1ULL << (j % 64);
+          }
+          tmp.appendResult(b.data(), qubits.size(), counts.countAt(i));
         }
 
         executionContext->result.append(tmp);
@@ -449,11 +510,14 @@ protected:
   }
 
   /// @brief Enqueue a new gate application task
-  void enqueueGate(const std::string name,
-                   const std::vector<std::complex<ScalarType>> &matrix,
-                   const std::vector<std::size_t> &controls,
-                   const std::vector<std::size_t> &targets) {
-    gateQueue.emplace(name, matrix, controls, targets);
+  template <typename MatrixRange>
+  void enqueueGate(GateName gate, const MatrixRange &matrix,
+                   std::span<const std::size_t> controls,
+                   std::span<const std::size_t> targets,
+                   std::span<const ScalarType> parameters = {}) {
+    gateQueue.emplace_back(gate, matrix, controls, targets, parameters);
+    if (recordGateTape)
+      gateTape.push_back(gateQueue.back());
   }
 
   /// @brief This pure virtual method is meant for subtypes
@@ -470,29 +534,232 @@ protected:
   virtual void applyNoiseChannel(const std::string_view gateName,
                                  const std::vector<std::size_t> &qubits) {}
 
+  /// @brief Compute <psi | H | psi> for the current state and its derivative
+  /// with respect to every parameter on the gate tape, in tape order, with
+  /// the adjoint method: one reverse sweep over the tape that uncomputes the
+  /// state instead of re-simulating the circuit per parameter. Unimplemented
+  /// on the base class, meant for state vector subtypes to override.
+  virtual std::vector<double> computeAdjointGradient(const cudaq::spin_op &H,
+                                                     double &expectation) {
+    throw std::runtime_error(
+        "The current backend does not support adjoint gradients.");
+  }
+
+  /// @brief Return true if the subtype interprets targets[0] of a multi-target
+  /// gate matrix as the least significant bit of the matrix row / column index
+  /// (e.g. cuStateVec), false if it is the most significant bit (e.g. Q++).
+  virtual bool isMatrixLittleEndian() const { return false; }
+
+  /// @brief Whether the noise model has Kraus channels for a gate on a list
+  /// of qubits (controls then targets).
+  struct NoiseInsertionEntry {
+    GateName gate;
+    std::vector<std::size_t> qubits;
+    bool hasChannels;
+  };
+
+  /// @brief The noise insertion cache, keyed by the hash of the gate and its
+  /// qubits.
+  std::unordered_multimap<std::size_t, NoiseInsertionEntry>
+      noiseInsertionCache;
+
+  /// @brief The noise_model version the noise insertion cache was built for.
+  std::size_t noiseInsertionVersion = 0;
+
+  /// @brief Return true if the active noise model has Kraus channels for this
+  /// gate, i.e. the gate is a noise insertion point that fusion must keep.
+  /// The answer is cached until the noise model changes.
+  bool hasNoiseChannels(const GateApplicationTask &task) {
+    if (!executionContext || !executionContext->noiseModel)
+      return false;
+    auto &noiseModel = *executionContext->noiseModel;
+    if (noiseModel.get_version() != noiseInsertionVersion) {
+      noiseInsertionCache.clear();
+      noiseInsertionVersion = noiseModel.get_version();
+    }
+
+    auto hash = std::hash<int>{}(static_cast<int>(task.gate));
+    auto mix = [&](std::size_t q) {
+      hash ^= q + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    std::for_each(task.controls.begin(), task.controls.end(), mix);
+    std::for_each(task.targets.begin(), task.targets.end(), mix);
+    auto isTaskQubits = [&](const std::vector<std::size_t> &qubits) {
+      return qubits.size() == task.controls.size() + task.targets.size() &&
+             std::equal(task.controls.begin(), task.controls.end(),
+                        qubits.begin()) &&
+             std::equal(task.targets.begin(), task.targets.end(),
+                        qubits.begin() + task.controls.size());
+    };
+    auto [begin, end] = noiseInsertionCache.equal_range(hash);
+    for (auto iter = begin; iter != end; ++iter)
+      if (iter->second.gate == task.gate && isTaskQubits(iter->second.qubits))
+        return iter->second.hasChannels;
+
+    std::vector<std::size_t> qubits{task.controls.begin(),
+                                    task.controls.end()};
+    qubits.insert(qubits.end(), task.targets.begin(), task.targets.end());
+    bool hasChannels =
+        !noiseModel.get_channels(std::string(task.operationName()), qubits)
+             .empty();
+    noiseInsertionCache.emplace(
+        hash, NoiseInsertionEntry{task.gate, std::move(qubits), hasChannels});
+    return hasChannels;
+  }
+
+  /// @brief Left-multiply the row-major matrix on the given (ordered) qubits
+  /// by the gate described by the task.
+  void applyTaskToMatrix(const GateApplicationTask &task,
+                         const std::vector<std::size_t> &qubits,
+                         std::vector<std::complex<ScalarType>> &matrix) {
+    const std::size_t nQubits = qubits.size();
+    const std::size_t dim = 1ULL << nQubits;
+    auto localBit = [&](std::size_t qubit) {
+      auto pos = std::distance(qubits.begin(),
+                               std::find(qubits.begin(), qubits.end(), qubit));
+      return nQubits - pos - 1;
+    };
+
+    std::size_t controlMask = 0, targetMask = 0;
+    for (auto c : task.controls)
+      controlMask |= 1ULL << localBit(c);
+
+    // Bit offsets of the gate matrix index bits, least significant first.
+    const std::size_t nTargets = task.targets.size();
+    std::vector<std::size_t> targetBits(nTargets);
+    for (std::size_t j = 0; j < nTargets; j++) {
+      auto t = isMatrixLittleEndian() ? task.targets[j]
+                                      : task.targets[nTargets - j - 1];
+      targetBits[j] = localBit(t);
+      targetMask |= 1ULL << targetBits[j];
+    }
+
+    const std::size_t gateDim = 1ULL << nTargets;
+    std::vector<std::size_t> offsets(gateDim, 0);
+    for (std::size_t s = 0; s < gateDim; s++)
+      for (std::size_t j = 0; j < nTargets; j++)
+        if (s & (1ULL << j))
+          offsets[s] |= 1ULL << targetBits[j];
+
+    std::vector<std::complex<ScalarType>> in(gateDim);
+    for (std::size_t row = 0; row < dim; row++) {
+      if ((row & controlMask) != controlMask || (row & targetMask))
+        continue;
+      for (std::size_t col = 0; col < dim; col++) {
+        for (std::size_t s = 0; s < gateDim; s++)
+          in[s] = matrix[(row | offsets[s]) * dim + col];
+        for (std::size_t r = 0; r < gateDim; r++) {
+          std::complex<ScalarType> sum = 0;
+          for (std::size_t s = 0; s < gateDim; s++)
+            sum += task.matrix[r * gateDim + s] * in[s];
+          matrix[(row | offsets[r]) * dim + col] = sum;
+        }
+      }
+    }
+  }
+
+  /// @brief Fuse runs of queued gates acting on at most fusionMaxQubits
+  /// qubits into a single dense unitary. Gates with noise channels in the
+  /// active noise model are never fused, so noise is inserted where the user
+  /// asked for it.
+  void fuseGateQueue() {
+    std::vector<GateApplicationTask> fusedQueue;
+    std::vector<GateApplicationTask> block;
+    std::vector<std::size_t> blockQubits;
+
+    auto emitBlock = [&]() {
+      if (block.size() == 1) {
+        fusedQueue.push_back(std::move(block.front()));
+      } else if (!block.empty()) {
+        const std::size_t dim = 1ULL << blockQubits.size();
+        std::vector<std::complex<ScalarType>> matrix(dim * dim, 0);
+        for (std::size_t i = 0; i < dim; i++)
+          matrix[i * dim + i] = 1;
+        for (auto &task : block)
+          applyTaskToMatrix(task, blockQubits, matrix);
+        std::vector<std::size_t> targets = blockQubits;
+        if (isMatrixLittleEndian())
+          std::reverse(targets.begin(), targets.end());
+        fusedQueue.emplace_back(GateName::Fused, matrix,
+                                std::span<const std::size_t>{}, targets);
+      }
+      block.clear();
+      blockQubits.clear();
+    };
+
+    for (auto &next : gateQueue) {
+      std::vector<std::size_t> qubits{next.controls.begin(),
+                                      next.controls.end()};
+      qubits.insert(qubits.end(), next.targets.begin(), next.targets.end());
+      std::sort(qubits.begin(), qubits.end());
+
+      if (qubits.size() > fusionMaxQubits || hasNoiseChannels(next)) {
+        emitBlock();
+        fusedQueue.push_back(std::move(next));
+        continue;
+      }
+
+      std::vector<std::size_t> merged;
+      std::set_union(blockQubits.begin(), blockQubits.end(), qubits.begin(),
+                     qubits.end(), std::back_inserter(merged));
+      if (merged.size() > fusionMaxQubits) {
+        emitBlock();
+        merged = qubits;
+      }
+      block.push_back(std::move(next));
+      blockQubits = std::move(merged);
+    }
+
+    emitBlock();
+    gateQueue = std::move(fusedQueue);
+  }
+
   /// @brief Flush the gate queue, run all queued gate
   /// application tasks.
   void flushGateQueueImpl() override {
-    while (!gateQueue.empty()) {
-      auto &next = gateQueue.front();
+    // Only the gate tape is of interest when collecting gate parameters.
+    if (executionContext && executionContext->name == "gate-parameters") {
+      gateQueue.clear();
+      return;
+    }
+
+    if (fusionMaxQubits > 0 && gateQueue.size() > 1)
+      fuseGateQueue();
+
+    for (auto &next : gateQueue) {
       applyGate(next);
       if (executionContext && executionContext->noiseModel) {
         std::vector<std::size_t> noiseQubits{next.controls.begin(),
                                              next.controls.end()};
         noiseQubits.insert(noiseQubits.end(), next.targets.begin(),
                            next.targets.end());
-        applyNoiseChannel(next.operationName, noiseQubits);
+        applyNoiseChannel(next.operationName(), noiseQubits);
       }
-      gateQueue.pop();
     }
+    gateQueue.clear();
   }
 
 public:
   /// @brief The constructor
-  CircuitSimulatorBase() = default;
+  CircuitSimulatorBase() {
+    if (auto *envVal = std::getenv("CUDAQ_FUSION_MAX_QUBITS")) {
+      try {
+        fusionMaxQubits = std::stoul(envVal);
+      } catch (...) {
+        throw std::runtime_error("Invalid CUDAQ_FUSION_MAX_QUBITS environment "
+                                 "variable, must be a non-negative integer.");
+      }
+    }
+  }
   /// @brief The destructor
   virtual ~CircuitSimulatorBase() = default;
 
+  /// @brief Set the maximum number of qubits a fused gate may act on,
+  /// 0 disables gate fusion.
+  void setFusionMaxQubits(std::size_t maxQubits) {
+    fusionMaxQubits = maxQubits;
+  }
+
   /// @brief Set the current noise model to consider when
   /// simulating the state. This should be overridden by
   /// simulation strategies that support noise modeling.
@@ -504,7 +771,7 @@ public:
 
   /// @brief Compute the expected value of the given spin op
   /// with respect to the current state, <psi | H | psi>.
-  cudaq::ExecutionResult observe(const cudaq::spin_op &term) override {
+  cudaq::observe_result observe(const cudaq::spin_op &term) override {
     throw std::runtime_error("This CircuitSimulator does not implement "
                              "observe(const cudaq::spin_op &).");
   }
@@ -523,7 +790,8 @@ public:
     stateDimension = calculateStateDim(nQubitsAllocated);
 
     // Tell the subtype to grow the state representation
-    addQubitToState();
+    if (!skipStateAllocation)
+      addQubitToState();
 
     // return the new qubit index
     return newIdx;
@@ -532,9 +800,17 @@ public:
   /// @brief Allocate `count` qubits.
   std::vector<std::size_t> allocateQubits(const std::size_t count) override {
     std::vector<std::size_t> qubits;
-    for (std::size_t i = 0; i < count; i++) {
-      qubits.push_back(allocateQubit());
-    }
+    for (std::size_t i = 0; i < count; i++)
+      qubits.push_back(tracker.getNextIndex());
+
+    cudaq::info("Allocating {} new qubits with idxs {} (nQ={}, dim={})", count,
+                qubits, nQubitsAllocated, stateDimension);
+
+    // Grow the state once, for all the new qubits
+    nQubitsAllocated += count;
+    stateDimension = calculateStateDim(nQubitsAllocated);
+    if (!skipStateAllocation)
+      addQubitsToState(count);
     return qubits;
   }
 
@@ -556,12 +832,11 @@ public:
     --nQubitsAllocated;
 
     // Reset the state if we've deallocated all qubits.
-    if (tracker.numAvailable() == tracker.totalNumQubits()) {
+    if (tracker.numAllocated() == 0) {
       cudaq::info("Deallocated all qubits, reseting state vector.");
       // all qubits deallocated,
       resetQubitState();
-      while (!gateQueue.empty())
-        gateQueue.pop();
+      gateQueue.clear();
     }
   }
 
@@ -623,7 +898,35 @@ public:
     // Set the state data if requested.
     if (executionContext->name == "extract-state") {
       flushGateQueue();
-      executionContext->simulationData = getStateData();
+      // If the deferred deallocations below release all the qubits, the
+      // state is reset anyway, so take its buffer.
+      executionContext->simulationData =
+          deferredDeallocation.size() == tracker.numAllocated()
+              ? takeStateData()
+              : getStateData();
+    }
+
+    if (recordGateTape) {
+      flushGateQueue();
+      executionContext->gateParameters.clear();
+      for (auto &task : gateTape)
+        executionContext->gateParameters.insert(
+            executionContext->gateParameters.end(), task.parameters.begin(),
+            task.parameters.end());
+
+      if (executionContext->name == "adjoint-gradient") {
+        if (!executionContext->spin.has_value())
+          throw std::runtime_error("Adjoint gradient ExecutionContext "
+                                   "specified without a cudaq::spin_op.");
+        double expectation = 0.0;
+        executionContext->gateParameterGradients =
+            computeAdjointGradient(*executionContext->spin.value(),
+                                   expectation);
+        executionContext->expectationValue = expectation;
+      }
+      gateTape.clear();
+      recordGateTape = false;
+      skipStateAllocation = false;
     }
 
     executionContext = nullptr;
@@ -634,7 +937,7 @@ public:
       tracker.returnIndex(deferred);
 
     // Reset the state if we've deallocated all qubits.
-    if (tracker.numAvailable() == tracker.totalNumQubits()) {
+    if (tracker.numAllocated() == 0) {
       cudaq::info("Deallocated all qubits, reseting state vector.");
       // all qubits deallocated,
       resetQubitState();
@@ -647,6 +950,13 @@ public:
   void setExecutionContext(cudaq::ExecutionContext *context) override {
     executionContext = context;
     executionContext->canHandleObserve = canHandleObserve();
+    if (context->randomSeed.has_value())
+      setRandomSeed(*context->randomSeed);
+    recordGateTape = context->name == "adjoint-gradient" ||
+                     context->name == "gate-parameters";
+    skipStateAllocation =
+        context->name == "gate-parameters" && nQubitsAllocated == 0;
+    gateTape.clear();
     currentCircuitName = context->kernelName;
     cudaq::info("Setting current circuit name to {}", currentCircuitName);
   }
@@ -671,39 +981,40 @@ public:
                                                        element.imag());
                      }
                    });
-    enqueueGate("custom", actual, controls, targets);
+    enqueueGate(GateName::Custom, actual, controls, targets);
   }
 
+  /// @brief Enqueue the one-qubit QuantumOperation. The matrix is built in
+  /// place (fixed gates are copied from a cached constant) and the gate is
+  /// only formatted for logging if info logging is enabled.
   template <typename QuantumOperation>
-  void enqueueQuantumOperation(const std::vector<ScalarType> &angles,
-                               const std::vector<std::size_t> &controls,
-                               const std::vector<std::size_t> &targets) {
+  void enqueueQuantumOperation(std::span<const ScalarType> angles,
+                               std::span<const std::size_t> controls,
+                               std::span<const std::size_t> targets) {
     flushAnySamplingTasks();
-    QuantumOperation gate;
-    cudaq::info(gateToString(gate.name(), controls, angles, targets));
-    enqueueGate(gate.name(), gate.getGate(angles), controls, targets);
-    if (executionContext && executionContext->noiseModel) {
-      std::vector<std::size_t> noiseQubits{controls.begin(), controls.end()};
-      noiseQubits.insert(noiseQubits.end(), targets.begin(), targets.end());
-      applyNoiseChannel(gate.name(), noiseQubits);
-    }
+    constexpr GateName gate = QuantumOperation::kind;
+    if (cudaq::details::should_log(cudaq::details::LogLevel::info))
+      cudaq::info(gateToString(getGateName(gate), controls, angles, targets));
+    // Noise channels are applied when the gate is flushed from the queue.
+    enqueueGate(gate, getOneQubitGate<ScalarType>(gate, angles), controls,
+                targets, angles);
   }
 
 #define CIRCUIT_SIMULATOR_ONE_QUBIT(NAME)                                      \
   using CircuitSimulator::NAME;                                                \
   void NAME(const std::vector<std::size_t> &controls,                          \
             const std::size_t qubitIdx) override {                             \
-    enqueueQuantumOperation<nvqir::NAME<ScalarType>>(                          \
-        {}, controls, std::vector<std::size_t>{qubitIdx});                     \
+    enqueueQuantumOperation<nvqir::NAME<ScalarType>>({}, controls,             \
+                                                     {&qubitIdx, 1});          \
   }
 
 #define CIRCUIT_SIMULATOR_ONE_QUBIT_ONE_PARAM(NAME)                            \
   using CircuitSimulator::NAME;                                                \
   void NAME(const double angle, const std::vector<std::size_t> &controls,      \
             const std::size_t qubitIdx) override {                             \
+    const ScalarType scalarAngle = angle;                                      \
     enqueueQuantumOperation<nvqir::NAME<ScalarType>>(                          \
-        {static_cast<ScalarType>(angle)}, controls,                            \
-        std::vector<std::size_t>{qubitIdx});                                   \
+        {&scalarAngle, 1}, controls, {&qubitIdx, 1});                          \
   }
 
   /// @brief The X gate
@@ -741,22 +1052,21 @@ public:
   void u2(const double phi, const double lambda,
           const std::vector<std::size_t> &controls,
           const std::size_t qubitIdx) override {
-    std::vector<ScalarType> tmp{static_cast<ScalarType>(phi),
-                                static_cast<ScalarType>(lambda)};
-
-    enqueueQuantumOperation<nvqir::u2<ScalarType>>(
-        tmp, controls, std::vector<std::size_t>{qubitIdx});
+    const ScalarType tmp[] = {static_cast<ScalarType>(phi),
+                              static_cast<ScalarType>(lambda)};
+    enqueueQuantumOperation<nvqir::u2<ScalarType>>(tmp, controls,
+                                                   {&qubitIdx, 1});
   }
 
   using CircuitSimulator::u3;
   void u3(const double theta, const double phi, const double lambda,
           const std::vector<std::size_t> &controls,
           const std::size_t qubitIdx) override {
-    std::vector<ScalarType> tmp{static_cast<ScalarType>(theta),
-                                static_cast<ScalarType>(phi),
-                                static_cast<ScalarType>(lambda)};
-    enqueueQuantumOperation<nvqir::u3<ScalarType>>(
-        tmp, controls, std::vector<std::size_t>{qubitIdx});
+    const ScalarType tmp[] = {static_cast<ScalarType>(theta),
+                              static_cast<ScalarType>(phi),
+                              static_cast<ScalarType>(lambda)};
+    enqueueQuantumOperation<nvqir::u3<ScalarType>>(tmp, controls,
+                                                   {&qubitIdx, 1});
   }
 
   using CircuitSimulator::swap;
@@ -764,13 +1074,14 @@ public:
   void swap(const std::vector<std::size_t> &ctrlBits, const std::size_t srcIdx,
             const std::size_t tgtIdx) override {
     flushAnySamplingTasks();
-    cudaq::info(gateToString("swap", ctrlBits, {}, {srcIdx, tgtIdx}));
-    std::vector<std::complex<ScalarType>> matrix{
-        {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
-        {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
-        {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}};
-    enqueueGate("swap", matrix, ctrlBits,
-                std::vector<std::size_t>{srcIdx, tgtIdx});
+    const std::size_t targets[] = {srcIdx, tgtIdx};
+    if (cudaq::details::should_log(cudaq::details::LogLevel::info))
+      cudaq::info(gateToString("swap", ctrlBits, {}, targets));
+    static const std::array<std::complex<ScalarType>, 16> matrix{
+        {{1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
+         {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
+         {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}}};
+    enqueueGate(GateName::Swap, matrix, ctrlBits, targets);
   }
 
   bool mz(const std::size_t qubitIdx) override { return mz(qubitIdx, ""); }
@@ -788,6 +1099,10 @@ public:
     // Flush the Gate Queue
     flushGateQueue();
 
+    if (recordGateTape)
+      throw std::runtime_error(
+          "The adjoint gradient does not support measurements in the kernel.");
+
     // If sampling, just store the bit, do nothing else.
     if (handleBasicSampling(qubitIdx, registerName))
       return true;
@@ -804,6 +1119,14 @@ public:
     return measureResult;
   }
 }; // namespace nvqir
+
+/// @brief Return the simulator of the calling thread, creating it on first
+/// use.
+CircuitSimulator *getCircuitSimulatorInternal();
+
+/// @brief Measure the current state in the basis of the given Pauli term,
+/// storing the expectation value and counts in the execution context.
+void measurePauliTerm(const std::vector<Pauli> &paulis);
 } // namespace nvqir
 
 #define CONCAT(a, b) CONCAT_INNER(a, b)
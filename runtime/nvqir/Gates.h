@@ -8,7 +8,13 @@
 
 #pragma once
 
+#include <array>
+#include <cmath>
 #include <complex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace nvqir {
@@ -21,88 +27,214 @@ static constexpr std::complex<Scalar> im = std::complex<Scalar>(0, 1.);
 template <typename ScalarType = double>
 using ComplexT = std::complex<ScalarType>;
 
-/// @brief Enumeration of supported CUDA Quantum operations
-enum class GateName { X, Y, Z, H, S, Sdg, Tdg, T, Rx, Ry, Rz, R1, U1, U2, U3 };
+/// @brief Enumeration of supported CUDA Quantum operations. The fixed
+/// (non-parameterized) one-qubit gates come first, see getFixedGate().
+enum class GateName {
+  X,
+  Y,
+  Z,
+  H,
+  S,
+  Sdg,
+  Tdg,
+  T,
+  Rx,
+  Ry,
+  Rz,
+  R1,
+  U1,
+  U2,
+  U3,
+  Swap,
+  Custom,
+  Fused
+};
 
-/// @brief Given the gate name (an element of the GateName enum),
-/// return the matrix data, optionally parameterized by a rotation angle.
+/// @brief Return the lower-case name of the given gate, e.g. "x", "rx".
+constexpr std::string_view getGateName(GateName name) {
+  constexpr std::string_view names[] = {
+      "x",  "y",  "z",  "h",  "s",    "sdg",  "tdg",   "t",   "rx",
+      "ry", "rz", "r1", "u1", "u2", "u3", "swap", "custom", "fused"};
+  return names[static_cast<std::size_t>(name)];
+}
+
+/// @brief Return true if the gate is a one-qubit gate without parameters.
+constexpr bool isFixedGate(GateName name) { return name <= GateName::T; }
+
+/// @brief Return the matrix of a fixed one-qubit gate (x, y, z, h, s, sdg,
+/// tdg, t). These are computed once and cached.
 template <typename Scalar>
-std::vector<std::complex<Scalar>>
-getGateByName(GateName name, const std::vector<Scalar> angles = {}) {
+const std::array<std::complex<Scalar>, 4> &getFixedGate(GateName name) {
+  using C = std::complex<Scalar>;
+  static const std::array<std::array<C, 4>, 8> fixedGates = [] {
+    Scalar oneOverSqrt2 = 1 / std::sqrt(2.);
+    C tPhase = std::exp(im<Scalar> * static_cast<Scalar>(M_PI_4));
+    return std::array<std::array<C, 4>, 8>{
+        {/*X*/ {{{0., 0.}, {1., 0.}, {1., 0.}, {0., 0.}}},
+         /*Y*/ {{{0., 0.}, {0., -1.}, {0., 1.}, {0., 0.}}},
+         /*Z*/ {{{1., 0.}, {0., 0.}, {0., 0.}, {-1., 0.}}},
+         /*H*/
+         {{oneOverSqrt2, oneOverSqrt2, oneOverSqrt2, -oneOverSqrt2}},
+         /*S*/ {{{1., 0.}, {0., 0.}, {0., 0.}, {0., 1.}}},
+         /*Sdg*/ {{{1., 0.}, {0., 0.}, {0., 0.}, {0., -1.}}},
+         /*Tdg*/ {{{1., 0.}, {0., 0.}, {0., 0.}, std::conj(tPhase)}},
+         /*T*/ {{{1., 0.}, {0., 0.}, {0., 0.}, tPhase}}}};
+  }();
+  if (!isFixedGate(name))
+    throw std::runtime_error("Invalid gate provided to getFixedGate.");
+  return fixedGates[static_cast<std::size_t>(name)];
+}
+
+/// @brief Given a one-qubit gate name, return the matrix data, optionally
+/// parameterized by rotation angles. Does not allocate.
+template <typename Scalar>
+std::array<std::complex<Scalar>, 4>
+getOneQubitGate(GateName name, std::span<const Scalar> angles = {}) {
+  if (isFixedGate(name))
+    return getFixedGate<Scalar>(name);
+
   Scalar two = 2.;
   switch (name) {
-  case (GateName::X):
-    return {{0., 0.}, {1.0, 0.}, {1.0, 0.0}, {0., 0.}};
-  case (GateName::Y):
-    return {{0., 0.}, {0.0, -1.0}, {0.0, 1.0}, {0., 0.}};
-  case (GateName::Z):
-    return {{1., 0.}, {0.0, 0.}, {0.0, 0.0}, {-1., 0.}};
-  case (GateName::H): {
-    Scalar oneOverSqrt2 = 1 / std::sqrt(2.);
-    return {oneOverSqrt2, oneOverSqrt2, oneOverSqrt2, -oneOverSqrt2};
-  }
-  case (GateName::S):
-    return {{1., 0.}, {0.0, 0.}, {0.0, 0.0}, {0., 1.}};
-  case (GateName::Sdg):
-    return {{1., 0.}, {0.0, 0.}, {0.0, 0.0}, {0., -1.}};
-  case (GateName::T):
-    return {{1., 0.},
-            {0.0, 0.},
-            {0.0, 0.0},
-            std::exp(im<Scalar> * static_cast<Scalar>(M_PI_4))};
-  case (GateName::Tdg):
-    return {{1., 0.},
-            {0.0, 0.},
-            {0.0, 0.0},
-            std::exp(-im<Scalar> * static_cast<Scalar>(M_PI_4))};
   case (GateName::Rx): {
     auto angle = angles[0];
-    return {{std::cos(angle / two), 0.},
-            {0., -1 * std::sin(angle / two)},
-            {0, -1 * std::sin(angle / two)},
-            {std::cos(angle / two), 0.}};
+    return {{{std::cos(angle / two), 0.},
+             {0., -1 * std::sin(angle / two)},
+             {0, -1 * std::sin(angle / two)},
+             {std::cos(angle / two), 0.}}};
   }
   case (GateName::Ry): {
     auto angle = angles[0];
-    return {std::cos(angle / two), -std::sin(angle / two),
-            std::sin(angle / two), std::cos(angle / two)};
+    return {{std::cos(angle / two), -std::sin(angle / two),
+             std::sin(angle / two), std::cos(angle / two)}};
   }
   case (GateName::Rz): {
     auto angle = angles[0];
-    return {std::exp(-im<Scalar> * angle / two), 0, 0,
-            std::exp(im<Scalar> * angle / two)};
+    return {{std::exp(-im<Scalar> * angle / two), 0, 0,
+             std::exp(im<Scalar> * angle / two)}};
   }
   case (GateName::R1):
-    return {{1., 0.}, {0.0, 0.}, {0.0, 0.0}, std::exp(im<Scalar> * angles[0])};
   case (GateName::U1):
-    return {{1., 0.}, {0.0, 0.}, {0.0, 0.0}, std::exp(im<Scalar> * angles[0])};
+    return {{{1., 0.}, {0.0, 0.}, {0.0, 0.0}, std::exp(im<Scalar> * angles[0])}};
   case (GateName::U2): {
     Scalar oneOverSqrt2 = 1 / std::sqrt(2.);
     auto phi = angles[0];
     auto lambda = angles[1];
-    return {{oneOverSqrt2, 0.},
-            -oneOverSqrt2 * std::exp(lambda * nvqir::im<Scalar>),
-            oneOverSqrt2 * std::exp(nvqir::im<Scalar> * phi),
-            oneOverSqrt2 * std::exp(nvqir::im<Scalar> * (phi + lambda))};
+    return {{{oneOverSqrt2, 0.},
+             -oneOverSqrt2 * std::exp(lambda * nvqir::im<Scalar>),
+             oneOverSqrt2 * std::exp(nvqir::im<Scalar> * phi),
+             oneOverSqrt2 * std::exp(nvqir::im<Scalar> * (phi + lambda))}};
   }
   case (GateName::U3): {
     auto theta = angles[0];
     auto phi = angles[1];
     auto lambda = angles[2];
-    return {{std::cos(theta / 2), 0.},
-            std::exp(nvqir::im<Scalar> * phi) * std::sin(theta / 2),
-            -std::exp(nvqir::im<Scalar> * lambda) * std::sin(theta / 2),
-            std::exp(nvqir::im<Scalar> * (phi + lambda)) * std::cos(theta / 2)};
+    return {{{std::cos(theta / 2), 0.},
+             std::exp(nvqir::im<Scalar> * phi) * std::sin(theta / 2),
+             -std::exp(nvqir::im<Scalar> * lambda) * std::sin(theta / 2),
+             std::exp(nvqir::im<Scalar> * (phi + lambda)) *
+                 std::cos(theta / 2)}};
+  }
+  default:
+    break;
   }
+
+  throw std::runtime_error("Invalid gate provided to getOneQubitGate.");
+}
+
+/// @brief Return the number of rotation angles the gate takes.
+constexpr std::size_t getNumGateParameters(GateName name) {
+  switch (name) {
+  case (GateName::Rx):
+  case (GateName::Ry):
+  case (GateName::Rz):
+  case (GateName::R1):
+  case (GateName::U1):
+    return 1;
+  case (GateName::U2):
+    return 2;
+  case (GateName::U3):
+    return 3;
+  default:
+    return 0;
   }
+}
 
-  throw std::runtime_error("Invalid gate provided to getGateByName.");
+/// @brief Return the element-wise derivative of the one-qubit gate matrix
+/// with respect to its `index`-th rotation angle.
+template <typename Scalar>
+std::array<std::complex<Scalar>, 4>
+getOneQubitGateDerivative(GateName name, std::span<const Scalar> angles,
+                          std::size_t index) {
+  Scalar half = 0.5;
+  switch (name) {
+  case (GateName::Rx): {
+    auto c = half * std::cos(angles[0] / 2), s = half * std::sin(angles[0] / 2);
+    return {{{-s, 0.}, {0., -c}, {0., -c}, {-s, 0.}}};
+  }
+  case (GateName::Ry): {
+    auto c = half * std::cos(angles[0] / 2), s = half * std::sin(angles[0] / 2);
+    return {{-s, -c, c, -s}};
+  }
+  case (GateName::Rz):
+    return {{-half * im<Scalar> * std::exp(-im<Scalar> * angles[0] / Scalar(2)),
+             0, 0,
+             half * im<Scalar> * std::exp(im<Scalar> * angles[0] / Scalar(2))}};
+  case (GateName::R1):
+  case (GateName::U1):
+    return {{0, 0, 0, im<Scalar> * std::exp(im<Scalar> * angles[0])}};
+  case (GateName::U2): {
+    Scalar oneOverSqrt2 = 1 / std::sqrt(2.);
+    auto phi = angles[0];
+    auto lambda = angles[1];
+    auto both =
+        oneOverSqrt2 * im<Scalar> * std::exp(im<Scalar> * (phi + lambda));
+    if (index == 0)
+      return {{0, 0, oneOverSqrt2 * im<Scalar> * std::exp(im<Scalar> * phi),
+               both}};
+    return {{0, -oneOverSqrt2 * im<Scalar> * std::exp(im<Scalar> * lambda), 0,
+             both}};
+  }
+  case (GateName::U3): {
+    auto theta = angles[0];
+    auto phi = angles[1];
+    auto lambda = angles[2];
+    auto c = std::cos(theta / 2), s = std::sin(theta / 2);
+    auto ePhi = std::exp(im<Scalar> * phi);
+    auto eLambda = std::exp(im<Scalar> * lambda);
+    auto eBoth = std::exp(im<Scalar> * (phi + lambda));
+    if (index == 0)
+      return {{-half * s, half * c * ePhi, -half * c * eLambda,
+               -half * s * eBoth}};
+    if (index == 1)
+      return {{0, im<Scalar> * ePhi * s, 0, im<Scalar> * eBoth * c}};
+    return {{0, 0, -im<Scalar> * eLambda * s, im<Scalar> * eBoth * c}};
+  }
+  default:
+    break;
+  }
+
+  throw std::runtime_error(
+      "Invalid gate provided to getOneQubitGateDerivative.");
+}
+
+/// @brief Given the gate name (an element of the GateName enum),
+/// return the matrix data, optionally parameterized by a rotation angle.
+template <typename Scalar>
+std::vector<std::complex<Scalar>>
+getGateByName(GateName name, const std::vector<Scalar> angles = {}) {
+  if (name == GateName::Swap)
+    return {1., 0., 0., 0., 0., 0., 1., 0., 0., 1., 0., 0., 0., 0., 0., 1.};
+  if (name == GateName::Custom || name == GateName::Fused)
+    throw std::runtime_error("Invalid gate provided to getGateByName.");
+  auto matrix = getOneQubitGate<Scalar>(name, angles);
+  return {matrix.begin(), matrix.end()};
 }
 
 /// @brief The X operation as a type. Can instantiate and request
 /// its matrix data.
 template <typename ScalarType = double>
 struct x {
+  static constexpr GateName kind = GateName::X;
   auto getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::X);
   }
@@ -112,6 +244,7 @@ struct x {
 /// The Y Gate
 template <typename ScalarType = double>
 struct y {
+  static constexpr GateName kind = GateName::Y;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::Y);
@@ -122,6 +255,7 @@ struct y {
 /// The Z Gate
 template <typename ScalarType = double>
 struct z {
+  static constexpr GateName kind = GateName::Z;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::Z);
@@ -132,6 +266,7 @@ struct z {
 /// The Hadamard Gate
 template <typename ScalarType = double>
 struct h {
+  static constexpr GateName kind = GateName::H;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::H);
@@ -142,6 +277,7 @@ struct h {
 /// The S Gate
 template <typename ScalarType = double>
 struct s {
+  static constexpr GateName kind = GateName::S;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::S);
@@ -152,6 +288,7 @@ struct s {
 /// The T Gate
 template <typename ScalarType = double>
 struct t {
+  static constexpr GateName kind = GateName::T;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::T);
@@ -162,6 +299,7 @@ struct t {
 /// The Sdg Gate
 template <typename ScalarType = double>
 struct sdg {
+  static constexpr GateName kind = GateName::Sdg;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::Sdg);
@@ -172,6 +310,7 @@ struct sdg {
 /// The Tdg Gate
 template <typename ScalarType = double>
 struct tdg {
+  static constexpr GateName kind = GateName::Tdg;
   std::vector<ComplexT<ScalarType>>
   getGate(std::vector<ScalarType> angles = {}) {
     return getGateByName<ScalarType>(GateName::Tdg);
@@ -182,6 +321,7 @@ struct tdg {
 /// The RX Rotation Gate
 template <typename ScalarType = double>
 struct rx {
+  static constexpr GateName kind = GateName::Rx;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::Rx, {angles[0]});
   }
@@ -191,6 +331,7 @@ struct rx {
 /// The RY Rotation Gate
 template <typename ScalarType = double>
 struct ry {
+  static constexpr GateName kind = GateName::Ry;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::Ry, {angles[0]});
   }
@@ -200,6 +341,7 @@ struct ry {
 /// The RZ Rotation Gate
 template <typename ScalarType = double>
 struct rz {
+  static constexpr GateName kind = GateName::Rz;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::Rz, {angles[0]});
   }
@@ -209,6 +351,7 @@ struct rz {
 /// @brief The R1 operation as a type. Arbitrary rotation about |1>
 template <typename ScalarType = double>
 struct r1 {
+  static constexpr GateName kind = GateName::R1;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::R1, {angles[0]});
   }
@@ -219,6 +362,7 @@ struct r1 {
 /// (IBMs version)
 template <typename ScalarType = double>
 struct u1 {
+  static constexpr GateName kind = GateName::U1;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::U1, {angles[0]});
   }
@@ -227,6 +371,7 @@ struct u1 {
 
 template <typename ScalarType = double>
 struct u2 {
+  static constexpr GateName kind = GateName::U2;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::U2, {angles[0], angles[1]});
   }
@@ -235,6 +380,7 @@ struct u2 {
 
 template <typename ScalarType = double>
 struct u3 {
+  static constexpr GateName kind = GateName::U3;
   std::vector<ComplexT<ScalarType>> getGate(std::vector<ScalarType> angles) {
     return getGateByName<ScalarType>(GateName::U3,
                                      {angles[0], angles[1], angles[2]});
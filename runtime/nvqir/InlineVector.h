@@ -0,0 +1,105 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+namespace nvqir {
+
+/// @brief The InlineVector is a minimal, copyable sequence container that
+/// stores up to N elements inline and only falls back to the heap for larger
+/// sizes. It is used to describe queued gates (matrix data, controls, and
+/// targets) without per-gate heap allocations.
+template <typename T, std::size_t N>
+class InlineVector {
+private:
+  /// @brief Inline storage, used if the size is at most N.
+  std::array<T, N> inlineData;
+
+  /// @brief Heap storage, used if the size exceeds N.
+  std::vector<T> heapData;
+
+  /// @brief The number of elements.
+  std::size_t count = 0;
+
+  bool isInline() const { return count <= N; }
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  InlineVector() = default;
+
+  InlineVector(std::initializer_list<T> list) {
+    assign(list.begin(), list.end());
+  }
+
+  /// @brief Construct from any range with a known size, e.g. a std::vector
+  /// or a std::span.
+  template <typename Range,
+            typename = decltype(std::begin(std::declval<const Range &>()))>
+  explicit InlineVector(const Range &range) {
+    assign(std::begin(range), std::end(range));
+  }
+
+  /// @brief Replace the contents with the elements in [first, last).
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    count = std::distance(first, last);
+    if (isInline()) {
+      std::copy(first, last, inlineData.begin());
+      heapData.clear();
+    } else {
+      heapData.assign(first, last);
+    }
+  }
+
+  /// @brief Resize to n elements, new elements are value-initialized.
+  void resize(std::size_t n) {
+    if (n <= N) {
+      if (!isInline())
+        std::copy_n(heapData.begin(), n, inlineData.begin());
+      else if (n > count)
+        std::fill(inlineData.begin() + count, inlineData.begin() + n, T{});
+      heapData.clear();
+    } else {
+      if (isInline())
+        heapData.assign(inlineData.begin(), inlineData.begin() + count);
+      heapData.resize(n);
+    }
+    count = n;
+  }
+
+  T *data() { return isInline() ? inlineData.data() : heapData.data(); }
+  const T *data() const {
+    return isInline() ? inlineData.data() : heapData.data();
+  }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + count; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + count; }
+
+  T &operator[](std::size_t i) { return data()[i]; }
+  const T &operator[](std::size_t i) const { return data()[i]; }
+  T &front() { return data()[0]; }
+  const T &front() const { return data()[0]; }
+  T &back() { return data()[count - 1]; }
+  const T &back() const { return data()[count - 1]; }
+};
+
+} // namespace nvqir
@@ -114,6 +114,76 @@ std::vector<std::size_t> arrayToVectorSizeT(Array *arr) {
   return ret;
 }
 
+void measurePauliTerm(const std::vector<Pauli> &paulis) {
+  auto *circuitSimulator = nvqir::getCircuitSimulatorInternal();
+  auto currentContext = circuitSimulator->getExecutionContext();
+
+  // Some backends may better handle the observe task.
+  // Let's give them that opportunity.
+  if (currentContext->canHandleObserve) {
+    circuitSimulator->flushGateQueue();
+    auto result = circuitSimulator->observe(*currentContext->spin.value());
+    currentContext->expectationValue = result.exp_val_z();
+    currentContext->result = result.raw_data();
+    return;
+  }
+
+  std::vector<std::size_t> qubits_to_measure;
+  std::vector<std::pair<std::string, std::size_t>> reverser;
+  for (size_t i = 0; i < paulis.size(); ++i) {
+    const auto pauli = paulis[i];
+    switch (pauli) {
+    case Pauli::Pauli_I:
+      break;
+    case Pauli::Pauli_X: {
+
+      circuitSimulator->h(i);
+      qubits_to_measure.push_back(i);
+      reverser.push_back({"X", i});
+      break;
+    }
+    case Pauli::Pauli_Y: {
+      double angle = M_PI_2;
+      circuitSimulator->rx(angle, i);
+      qubits_to_measure.push_back(i);
+      reverser.push_back({"Y", i});
+
+      break;
+    }
+    case Pauli::Pauli_Z: {
+      qubits_to_measure.push_back(i);
+      break;
+    }
+    }
+  }
+
+  circuitSimulator->flushGateQueue();
+  int shots = 0;
+  if (currentContext->shots > 0) {
+    shots = currentContext->shots;
+  }
+
+  // Sample and give the data to the context
+  cudaq::ExecutionResult result =
+      circuitSimulator->sample(qubits_to_measure, shots);
+  currentContext->expectationValue = result.expectationValue;
+  currentContext->result = cudaq::sample_result(result);
+
+  // Reverse the measurements bases change.
+  if (!reverser.empty()) {
+    cudaq::info("NVQIR reverse pauli bases change for measurement.");
+    for (auto it = reverser.rbegin(); it != reverser.rend(); ++it) {
+      if (it->first == "X") {
+        circuitSimulator->h(it->second);
+      } else if (it->first == "Y") {
+        double angle = -M_PI_2;
+        circuitSimulator->rx(angle, it->second);
+      }
+    }
+    circuitSimulator->flushGateQueue();
+  }
+}
+
 /// @brief Utility function mapping a QIR Qubit pointer to its id
 /// @param q
 /// @return
@@ -146,7 +216,7 @@ void __quantum__rt__setExecutionContext(cudaq::ExecutionContext *ctx) {
   __quantum__rt__initialize(0, nullptr);
 
   if (ctx) {
-    cudaq::ScopedTrace trace("NVQIR::setExecutionContext", ctx->name);
+    CUDAQ_TRACE_SCOPE("NVQIR::setExecutionContext", ctx->name);
     cudaq::info("Setting execution context: {}{}", ctx ? ctx->name : "basic",
                 ctx->hasConditionalsOnMeasureResults ? " with conditionals"
                                                      : "");
@@ -156,7 +226,7 @@ void __quantum__rt__setExecutionContext(cudaq::ExecutionContext *ctx) {
 
 /// @brief Reset the Execution Context
 void __quantum__rt__resetExecutionContext() {
-  cudaq::ScopedTrace trace("NVQIR::resetExecutionContext");
+  CUDAQ_TRACE_SCOPE("NVQIR::resetExecutionContext");
   cudaq::info("Resetting execution context.");
   nvqir::getCircuitSimulatorInternal()->resetExecutionContext();
 }
@@ -165,7 +235,7 @@ void __quantum__rt__resetExecutionContext() {
 /// @param size number of qubits to allocate
 /// @return
 Array *__quantum__rt__qubit_allocate_array(uint64_t size) {
-  cudaq::ScopedTrace trace("NVQIR::qubit_allocate_array", size);
+  CUDAQ_TRACE_SCOPE("NVQIR::qubit_allocate_array", size);
   __quantum__rt__initialize(0, nullptr);
   auto qubitIdxs = nvqir::getCircuitSimulatorInternal()->allocateQubits(size);
   return vectorSizetToArray(qubitIdxs);
@@ -174,7 +244,7 @@ Array *__quantum__rt__qubit_allocate_array(uint64_t size) {
 /// @brief Once done, release the QIR qubit array
 /// @param arr
 void __quantum__rt__qubit_release_array(Array *arr) {
-  cudaq::ScopedTrace trace("NVQIR::qubit_release_array", arr->size());
+  CUDAQ_TRACE_SCOPE("NVQIR::qubit_release_array", arr->size());
   for (std::size_t i = 0; i < arr->size(); i++) {
     auto arrayPtr = (*arr)[i];
     Qubit *idxVal = *reinterpret_cast<Qubit **>(arrayPtr);
@@ -194,7 +264,7 @@ void __quantum__rt__qubit_release_array(Array *arr) {
 /// @brief Allocate a single QIR Qubit
 /// @return
 Qubit *__quantum__rt__qubit_allocate() {
-  cudaq::ScopedTrace trace("NVQIR::allocate_qubit");
+  CUDAQ_TRACE_SCOPE("NVQIR::allocate_qubit");
   __quantum__rt__initialize(0, nullptr);
   auto qubitIdx = nvqir::getCircuitSimulatorInternal()->allocateQubit();
   auto qubit = std::make_unique<Qubit>(qubitIdx);
@@ -205,7 +275,7 @@ Qubit *__quantum__rt__qubit_allocate() {
 /// @brief Once done, release that qubit
 /// @param q
 void __quantum__rt__qubit_release(Qubit *q) {
-  cudaq::ScopedTrace trace("NVQIR::release_qubit");
+  CUDAQ_TRACE_SCOPE("NVQIR::release_qubit");
   nvqir::getCircuitSimulatorInternal()->deallocate(q->idx);
   auto begin = nvqir::allocatedSingleQubits.begin();
   auto end = nvqir::allocatedSingleQubits.end();
@@ -218,14 +288,13 @@ void __quantum__rt__qubit_release(Qubit *q) {
 #define ONE_QUBIT_QIS_FUNCTION(GATENAME)                                       \
   void QIS_FUNCTION_NAME(GATENAME)(Qubit * qubit) {                            \
     auto targetIdx = qubitToSizeT(qubit);                                      \
-    cudaq::ScopedTrace trace("NVQIR::" + std::string(#GATENAME), targetIdx);   \
+    CUDAQ_TRACE_SCOPE("NVQIR::" #GATENAME, targetIdx);                         \
     nvqir::getCircuitSimulatorInternal()->GATENAME(targetIdx);                 \
   }                                                                            \
   void QIS_FUNCTION_CTRL_NAME(GATENAME)(Array * ctrlQubits, Qubit * qubit) {   \
     auto ctrlIdxs = arrayToVectorSizeT(ctrlQubits);                            \
     auto targetIdx = qubitToSizeT(qubit);                                      \
-    cudaq::ScopedTrace trace("NVQIR::ctrl-" + std::string(#GATENAME),          \
-                             ctrlIdxs, targetIdx);                             \
+    CUDAQ_TRACE_SCOPE("NVQIR::ctrl-" #GATENAME, ctrlIdxs, targetIdx);          \
     nvqir::getCircuitSimulatorInternal()->GATENAME(ctrlIdxs, targetIdx);       \
   }                                                                            \
   void QIS_FUNCTION_BODY_NAME(GATENAME)(Qubit * qubit) {                       \
@@ -244,8 +313,7 @@ ONE_QUBIT_QIS_FUNCTION(sdg);
 #define ONE_QUBIT_PARAM_QIS_FUNCTION(GATENAME)                                 \
   void QIS_FUNCTION_NAME(GATENAME)(double param, Qubit *qubit) {               \
     auto targetIdx = qubitToSizeT(qubit);                                      \
-    cudaq::ScopedTrace trace("NVQIR::" + std::string(#GATENAME), param,        \
-                             targetIdx);                                       \
+    CUDAQ_TRACE_SCOPE("NVQIR::" #GATENAME, param, targetIdx);                  \
     nvqir::getCircuitSimulatorInternal()->GATENAME(param, targetIdx);          \
   }                                                                            \
   void QIS_FUNCTION_BODY_NAME(GATENAME)(double param, Qubit *qubit) {          \
@@ -255,8 +323,7 @@ ONE_QUBIT_QIS_FUNCTION(sdg);
                                         Qubit *qubit) {                        \
     auto ctrlIdxs = arrayToVectorSizeT(ctrlQubits);                            \
     auto targetIdx = qubitToSizeT(qubit);                                      \
-    cudaq::ScopedTrace trace("NVQIR::" + std::string(#GATENAME), param,        \
-                             ctrlIdxs, targetIdx);                             \
+    CUDAQ_TRACE_SCOPE("NVQIR::" #GATENAME, param, ctrlIdxs, targetIdx);        \
     nvqir::getCircuitSimulatorInternal()->GATENAME(param, ctrlIdxs,            \
                                                    targetIdx);                 \
   }
@@ -269,7 +336,7 @@ ONE_QUBIT_PARAM_QIS_FUNCTION(r1);
 void __quantum__qis__swap(Qubit *q, Qubit *r) {
   auto qI = qubitToSizeT(q);
   auto rI = qubitToSizeT(r);
-  cudaq::ScopedTrace trace("NVQIR::swap", qI, rI);
+  CUDAQ_TRACE_SCOPE("NVQIR::swap", qI, rI);
   nvqir::getCircuitSimulatorInternal()->swap(qI, rI);
 }
 void __quantum__qis__swap__body(Qubit *q, Qubit *r) {
@@ -286,20 +353,20 @@ void __quantum__qis__cphase(double d, Qubit *q, Qubit *r) {
 void __quantum__qis__cnot(Qubit *q, Qubit *r) {
   auto qI = qubitToSizeT(q);
   auto rI = qubitToSizeT(r);
-  cudaq::ScopedTrace trace("NVQIR::cnot", qI, rI);
+  CUDAQ_TRACE_SCOPE("NVQIR::cnot", qI, rI);
   std::vector<std::size_t> controls{qI};
   nvqir::getCircuitSimulatorInternal()->x(controls, rI);
 }
 
 void __quantum__qis__reset(Qubit *q) {
   auto qI = qubitToSizeT(q);
-  cudaq::ScopedTrace trace("NVQIR::reset", qI);
+  CUDAQ_TRACE_SCOPE("NVQIR::reset", qI);
   nvqir::getCircuitSimulatorInternal()->resetQubit(qI);
 }
 
 Result *__quantum__qis__mz(Qubit *q) {
   auto qI = qubitToSizeT(q);
-  cudaq::ScopedTrace trace("NVQIR::mz", qI);
+  CUDAQ_TRACE_SCOPE("NVQIR::mz", qI);
   auto b = nvqir::getCircuitSimulatorInternal()->mz(qI, "");
   return b ? ResultOne : ResultZero;
 }
@@ -307,7 +374,7 @@ Result *__quantum__qis__mz(Qubit *q) {
 Result *__quantum__qis__mz__to__register(Qubit *q, const char *name) {
   std::string regName(name);
   auto qI = qubitToSizeT(q);
-  cudaq::ScopedTrace trace("NVQIR::mz", qI, regName);
+  CUDAQ_TRACE_SCOPE("NVQIR::mz", qI, regName);
   auto b = nvqir::getCircuitSimulatorInternal()->mz(qI, regName);
   return b ? ResultOne : ResultZero;
 }
@@ -333,77 +400,8 @@ static std::vector<Pauli> extractPauliTermIds(Array *paulis) {
 /// @return
 Result *__quantum__qis__measure__body(Array *pauli_arr, Array *qubits) {
   cudaq::info("NVQIR measuring in pauli basis");
-  cudaq::ScopedTrace trace("NVQIR::observe_measure_body");
-
-  auto *circuitSimulator = nvqir::getCircuitSimulatorInternal();
-  auto currentContext = circuitSimulator->getExecutionContext();
-
-  // Some backends may better handle the observe task.
-  // Let's give them that opportunity.
-  if (currentContext->canHandleObserve) {
-    circuitSimulator->flushGateQueue();
-    auto result = circuitSimulator->observe(*currentContext->spin.value());
-    currentContext->expectationValue = result.expectationValue;
-    currentContext->result = cudaq::sample_result(result);
-    return ResultZero;
-  }
-
-  const auto paulis = extractPauliTermIds(pauli_arr);
-  std::vector<std::size_t> qubits_to_measure;
-  std::vector<std::pair<std::string, std::size_t>> reverser;
-  for (size_t i = 0; i < paulis.size(); ++i) {
-    const auto pauli = paulis[i];
-    switch (pauli) {
-    case Pauli::Pauli_I:
-      break;
-    case Pauli::Pauli_X: {
-
-      circuitSimulator->h(i);
-      qubits_to_measure.push_back(i);
-      reverser.push_back({"X", i});
-      break;
-    }
-    case Pauli::Pauli_Y: {
-      double angle = M_PI_2;
-      circuitSimulator->rx(angle, i);
-      qubits_to_measure.push_back(i);
-      reverser.push_back({"Y", i});
-
-      break;
-    }
-    case Pauli::Pauli_Z: {
-      qubits_to_measure.push_back(i);
-      break;
-    }
-    }
-  }
-
-  circuitSimulator->flushGateQueue();
-  int shots = 0;
-  if (currentContext->shots > 0) {
-    shots = currentContext->shots;
-  }
-
-  // Sample and give the data to the context
-  cudaq::ExecutionResult result =
-      circuitSimulator->sample(qubits_to_measure, shots);
-  currentContext->expectationValue = result.expectationValue;
-  currentContext->result = cudaq::sample_result(result);
-
-  // Reverse the measurements bases change.
-  if (!reverser.empty()) {
-    cudaq::info("NVQIR reverse pauli bases change for measurement.");
-    for (auto it = reverser.rbegin(); it != reverser.rend(); ++it) {
-      if (it->first == "X") {
-        circuitSimulator->h(it->second);
-      } else if (it->first == "Y") {
-        double angle = -M_PI_2;
-        circuitSimulator->rx(angle, it->second);
-      }
-    }
-    circuitSimulator->flushGateQueue();
-  }
-
+  CUDAQ_TRACE_SCOPE("NVQIR::observe_measure_body");
+  nvqir::measurePauliTerm(extractPauliTermIds(pauli_arr));
   return ResultZero;
 }
 
@@ -414,7 +412,7 @@ Result *__quantum__qis__measure__body(Array *pauli_arr, Array *qubits) {
 /// @param qubits
 void __quantum__qis__exp__body(Array *paulis, double angle, Array *qubits) {
   auto n_qubits = qubits->size();
-  cudaq::ScopedTrace trace("NVQIR::exp_body");
+  CUDAQ_TRACE_SCOPE("NVQIR::exp_body");
 
   // if identity, do nothing
   std::vector<int> test;
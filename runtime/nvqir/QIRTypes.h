@@ -9,10 +9,10 @@
 #pragma once
 
 #include "common/ExecutionContext.h"
+#include "common/IndexPool.h"
 #include <algorithm>
 #include <atomic>
 #include <cassert>
-#include <deque>
 #include <map>
 #include <memory>
 #include <numeric>
@@ -103,46 +103,7 @@ enum Pauli : int8_t {
 
 namespace nvqir {
 
-/// The QubitIdTracker is a utility class that keeps
-/// track of available qubit ids and provides and API to
-/// get new qubit ids from the available set and return them
-/// for future use.
-class QubitIdTracker {
-
-  /// Available qubit indices
-  std::deque<std::size_t> availableIndices;
-
-  /// Total qubits available
-  std::size_t totalQubits;
-
-public:
-  /// The Constructor
-  QubitIdTracker() {
-    // FIXME calculate the memory available
-    totalQubits = 30;
-    for (std::size_t i = 0; i < totalQubits; i++) {
-      availableIndices.push_back(i);
-    }
-  }
-
-  /// Get the next available qubit index
-  std::size_t getNextIndex() {
-    assert(!availableIndices.empty() && "No more qubits available.");
-    auto next = availableIndices.front();
-    availableIndices.pop_front();
-    return next;
-  }
-
-  /// At qubit deallocation, return the qubit index
-  void returnIndex(std::size_t idx) {
-    availableIndices.push_front(idx);
-    std::sort(availableIndices.begin(), availableIndices.end());
-  }
-
-  /// Get the number of remaining available qubit ids
-  std::size_t numAvailable() { return availableIndices.size(); }
-
-  /// Get the total number of qubit ids available
-  std::size_t totalNumQubits() { return totalQubits; }
-};
+/// The QubitIdTracker keeps track of available qubit ids, it hands out the
+/// lowest available id and grows as more qubits are allocated.
+using QubitIdTracker = cudaq::IndexPool;
 } // namespace nvqir
\ No newline at end of file
@@ -13,7 +13,7 @@
 #include "Gates.h"
 #include "cuComplex.h"
 #include "custatevec.h"
-#include <bitset>
+#include <bit>
 #include <complex>
 #include <iostream>
 #include <random>
@@ -74,26 +74,6 @@ __global__ void initializeDeviceStateVector(CudaDataType *sv, int64_t dim) {
   }
 }
 
-/// @brief Kernel to set the first N elements of the state vector sv equal to
-/// the
-// elements provided by the vector sv2. N is the number of elements to set.
-// Size of sv must be greater than size of sv2.
-/// @param sv
-/// @param sv2
-/// @param N
-/// @return
-template <typename T>
-__global__ void setFirstNElements(T *sv, const T *__restrict__ sv2, int64_t N) {
-  int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
-  if (i < N) {
-    sv[i].x = sv2[i].x;
-    sv[i].y = sv2[i].y;
-  } else {
-    sv[i].x = 0.0;
-    sv[i].y = 0.0;
-  }
-}
-
 /// @brief The CuStateVecCircuitSimulator implements the CircuitSimulator
 /// base class to provide a simulator that delegates to the NVIDIA CuStateVec
 /// GPU-accelerated library.
@@ -121,17 +101,12 @@ protected:
   /// @brief Count the number of resets.
   int nResets = 0;
 
+  /// @brief The number of elements the device state vector can hold.
+  std::size_t deviceStateCapacity = 0;
+
   custatevecComputeType_t cuStateVecComputeType = CUSTATEVEC_COMPUTE_64F;
   cudaDataType_t cuStateVecCudaDataType = CUDA_C_64F;
 
-  /// @brief Return true if the bit string has even parity
-  /// @param x
-  /// @return
-  bool hasEvenParity(const std::string &x) {
-    int c = std::count(x.begin(), x.end(), '1');
-    return c % 2 == 0;
-  }
-
   /// @brief Convert the pauli rotation gate name to a CUSTATEVEC_PAULI Type
   /// @param type
   /// @return
@@ -151,11 +126,11 @@ protected:
   /// @param matrix The matrix data as a 1-d array, row-major
   /// @param controls Possible control qubits, can be empty
   /// @param targets Target qubits
-  void applyGateMatrix(const DataVector &matrix,
+  void applyGateMatrix(const DataType *matrix,
                        const std::vector<int> &controls,
                        const std::vector<int> &targets) {
     HANDLE_ERROR(custatevecApplyMatrixGetWorkspaceSize(
-        handle, cuStateVecCudaDataType, nQubitsAllocated, matrix.data(),
+        handle, cuStateVecCudaDataType, nQubitsAllocated, matrix,
         cuStateVecCudaDataType, CUSTATEVEC_MATRIX_LAYOUT_ROW, 0, targets.size(),
         controls.size(), cuStateVecComputeType, &extraWorkspaceSizeInBytes));
 
@@ -170,7 +145,7 @@ protected:
     // apply gate
     HANDLE_ERROR(custatevecApplyMatrix(
         handle, deviceStateVector, cuStateVecCudaDataType,
-        localNQubitsAllocated, matrix.data(), cuStateVecCudaDataType,
+        localNQubitsAllocated, matrix, cuStateVecCudaDataType,
         CUSTATEVEC_MATRIX_LAYOUT_ROW, 0, targets.data(), targets.size(),
         controls.empty() ? nullptr : controls.data(), nullptr, controls.size(),
         cuStateVecComputeType, extraWorkspace, extraWorkspaceSizeInBytes));
@@ -185,12 +160,13 @@ protected:
   void oneQubitApply(const std::vector<std::size_t> &controls,
                      const std::size_t qubitIdx) {
     GateT gate;
-    cudaq::info(gateToString(gate.name(), controls, {}, {qubitIdx}));
+    if (cudaq::details::should_log(cudaq::details::LogLevel::info))
+      cudaq::info(gateToString(gate.name(), controls, {}, {&qubitIdx, 1}));
     DataVector matrix = gate.getGate();
     std::vector<int> targets{(int)qubitIdx}, ctrls32;
     for (auto &c : controls)
       ctrls32.push_back(c);
-    applyGateMatrix(matrix, ctrls32, targets);
+    applyGateMatrix(matrix.data(), ctrls32, targets);
   }
 
   /// @brief Utility function for applying one-target-qubit rotation operations
@@ -203,7 +179,10 @@ protected:
                              const std::vector<std::size_t> &controls,
                              const std::size_t qubitIdx) {
     RotationGateT gate;
-    cudaq::info(gateToString(gate.name(), controls, {angle}, {qubitIdx}));
+    const ScalarType scalarAngle = angle;
+    if (cudaq::details::should_log(cudaq::details::LogLevel::info))
+      cudaq::info(gateToString(gate.name(), controls, {&scalarAngle, 1},
+                               {&qubitIdx, 1}));
     std::vector<int> controls32;
     for (auto c : controls)
       controls32.push_back((int)c);
@@ -219,6 +198,43 @@ protected:
   using nvqir::CircuitSimulatorBase<ScalarType>::nQubitsAllocated;
   using nvqir::CircuitSimulatorBase<ScalarType>::stateDimension;
   using nvqir::CircuitSimulatorBase<ScalarType>::calculateStateDim;
+  using nvqir::CircuitSimulatorBase<ScalarType>::skipStateAllocation;
+
+  /// @brief Grow the device state vector from oldDimension to stateDimension
+  /// elements, an oldDimension of 0 initializes it to |0...0>. The new qubits
+  /// are the most significant bits, so growing only zero-fills the upper part
+  /// of the state vector. This happens in place unless the capacity is
+  /// exceeded, the device buffer is reused across resets.
+  void growDeviceStateVector(const std::size_t oldDimension) {
+    if (stateDimension > deviceStateCapacity) {
+      void *newDeviceStateVector;
+      HANDLE_CUDA_ERROR(cudaMalloc((void **)&newDeviceStateVector,
+                                   stateDimension * sizeof(CudaDataType)));
+      if (deviceStateVector) {
+        HANDLE_CUDA_ERROR(cudaMemcpy(
+            newDeviceStateVector, deviceStateVector,
+            oldDimension * sizeof(CudaDataType), cudaMemcpyDeviceToDevice));
+        HANDLE_CUDA_ERROR(cudaFree(deviceStateVector));
+      } else {
+        HANDLE_ERROR(custatevecCreate(&handle));
+      }
+      deviceStateVector = newDeviceStateVector;
+      deviceStateCapacity = stateDimension;
+    }
+
+    if (oldDimension == 0) {
+      constexpr int32_t threads_per_block = 256;
+      uint32_t n_blocks =
+          (stateDimension + threads_per_block - 1) / threads_per_block;
+      initializeDeviceStateVector<<<n_blocks, threads_per_block>>>(
+          reinterpret_cast<CudaDataType *>(deviceStateVector), stateDimension);
+      return;
+    }
+
+    HANDLE_CUDA_ERROR(cudaMemset(
+        reinterpret_cast<CudaDataType *>(deviceStateVector) + oldDimension, 0,
+        (stateDimension - oldDimension) * sizeof(CudaDataType)));
+  }
 
   /// @brief It's more efficient for us to allocate the whole state vector
   /// and if we are in sampling or observe contexts, we will likely allocate
@@ -239,70 +255,23 @@ protected:
     auto oldStateDimension = stateDimension;
     stateDimension = calculateStateDim(nQubitsAllocated);
 
-    if (!deviceStateVector) {
-      HANDLE_CUDA_ERROR(cudaMalloc((void **)&deviceStateVector,
-                                   stateDimension * sizeof(CudaDataType)));
-      constexpr int32_t threads_per_block = 256;
-      uint32_t n_blocks =
-          (stateDimension + threads_per_block - 1) / threads_per_block;
-      initializeDeviceStateVector<<<n_blocks, threads_per_block>>>(
-          reinterpret_cast<CudaDataType *>(deviceStateVector), stateDimension);
-      HANDLE_ERROR(custatevecCreate(&handle));
-    } else {
-      // Allocate new state..
-      void *newDeviceStateVector;
-      HANDLE_CUDA_ERROR(cudaMalloc((void **)&newDeviceStateVector,
-                                   stateDimension * sizeof(CudaDataType)));
-      constexpr int32_t threads_per_block = 256;
-      uint32_t n_blocks =
-          (stateDimension + threads_per_block - 1) / threads_per_block;
-      setFirstNElements<<<n_blocks, threads_per_block>>>(
-          reinterpret_cast<CudaDataType *>(newDeviceStateVector),
-          reinterpret_cast<CudaDataType *>(deviceStateVector),
-          oldStateDimension);
-      cudaFree(deviceStateVector);
-      deviceStateVector = newDeviceStateVector;
-    }
-
+    // Only the gate tape is recorded under a state-less "gate-parameters"
+    // context, see CircuitSimulatorBase::skipStateAllocation.
+    if (!skipStateAllocation)
+      growDeviceStateVector(oldStateDimension);
     return qubits;
   }
 
   /// @brief Grow the state vector by one qubit.
   void addQubitToState() override {
-    // Update the state vector
-    if (!deviceStateVector) {
-      HANDLE_CUDA_ERROR(cudaMalloc((void **)&deviceStateVector,
-                                   stateDimension * sizeof(CudaDataType)));
-      constexpr int32_t threads_per_block = 256;
-      uint32_t n_blocks =
-          (stateDimension + threads_per_block - 1) / threads_per_block;
-      initializeDeviceStateVector<<<n_blocks, threads_per_block>>>(
-          reinterpret_cast<CudaDataType *>(deviceStateVector), stateDimension);
-      HANDLE_ERROR(custatevecCreate(&handle));
-    } else {
-      int64_t oldDimension = calculateStateDim(std::log2(stateDimension) - 1);
-      // Allocate new state..
-      void *newDeviceStateVector;
-      HANDLE_CUDA_ERROR(cudaMalloc((void **)&newDeviceStateVector,
-                                   stateDimension * sizeof(CudaDataType)));
-      constexpr int32_t threads_per_block = 256;
-      uint32_t n_blocks =
-          (stateDimension + threads_per_block - 1) / threads_per_block;
-      setFirstNElements<<<n_blocks, threads_per_block>>>(
-          reinterpret_cast<CudaDataType *>(newDeviceStateVector),
-          reinterpret_cast<CudaDataType *>(deviceStateVector), oldDimension);
-      cudaFree(deviceStateVector);
-      deviceStateVector = newDeviceStateVector;
-    }
+    growDeviceStateVector(nQubitsAllocated == 1 ? 0 : stateDimension / 2);
   }
 
-  /// @brief Reset the qubit state.
+  /// @brief Reset the qubit state. The device state vector and the
+  /// cuStateVec handle are kept for the next allocation.
   void resetQubitStateImpl() override {
-    HANDLE_ERROR(custatevecDestroy(handle));
-    HANDLE_CUDA_ERROR(cudaFree(deviceStateVector));
     if (extraWorkspaceSizeInBytes)
       HANDLE_CUDA_ERROR(cudaFree(extraWorkspace));
-    deviceStateVector = nullptr;
     extraWorkspaceSizeInBytes = 0;
     nResets = 0;
   }
@@ -317,9 +286,13 @@ protected:
     std::transform(task.targets.begin(), task.targets.end(),
                    std::back_inserter(targets),
                    [](std::size_t idx) { return static_cast<int>(idx); });
-    applyGateMatrix(task.matrix, controls, targets);
+    applyGateMatrix(task.matrix.data(), controls, targets);
   }
 
+  /// @brief cuStateVec maps targets[0] to the least significant bit of the
+  /// gate matrix index.
+  bool isMatrixLittleEndian() const override { return true; }
+
 public:
   /// @brief The constructor
   CuStateVecCircuitSimulator() {
@@ -332,7 +305,12 @@ public:
   }
 
   /// The destructor
-  virtual ~CuStateVecCircuitSimulator() = default;
+  virtual ~CuStateVecCircuitSimulator() {
+    if (!deviceStateVector)
+      return;
+    custatevecDestroy(handle);
+    cudaFree(deviceStateVector);
+  }
 
   /// @brief Measure operation
   /// @param qubitIdx
@@ -420,27 +398,20 @@ public:
         measuredBits32.size(), randomValues_.data(), shots,
         CUSTATEVEC_SAMPLER_OUTPUT_ASCENDING_ORDER));
 
-    std::vector<std::string> sequentialData;
-
     cudaq::ExecutionResult counts;
 
-    // We've sampled, convert the results to our ExecutionResult counts
+    // We've sampled, convert the results to our ExecutionResult counts. Bit j
+    // of the sampled index is measured qubit j, as in the packed bit strings.
     for (int i = 0; i < shots; ++i) {
-      auto bitstring = std::bitset<64>(bitstrings0[i])
-                           .to_string()
-                           .erase(0, 64 - measuredBits.size());
-      std::reverse(bitstring.begin(), bitstring.end());
-      sequentialData.push_back(bitstring);
-      counts.appendResult(bitstring, 1);
+      std::uint64_t bits = bitstrings0[i];
+      counts.appendResult(&bits, measuredBits.size(), 1);
     }
 
     // Compute the expectation value from the counts
-    for (auto &kv : counts.counts) {
-      auto par = hasEvenParity(kv.first);
-      auto p = kv.second / (double)shots;
-      if (!par) {
+    for (std::size_t i = 0; i < counts.counts.size(); i++) {
+      auto p = counts.counts.countAt(i) / (double)shots;
+      if (std::popcount(counts.counts.bits(i)[0]) % 2)
         p = -p;
-      }
       expVal += p;
     }
 
@@ -456,7 +427,7 @@ public:
       std::vector<std::complex<ScalarType>> data(stateDimension);
       cudaMemcpy(data.data(), deviceStateVector,
                  stateDimension * sizeof(CudaDataType), cudaMemcpyDeviceToHost);
-      return cudaq::State{{stateDimension}, data};
+      return cudaq::State{{stateDimension}, std::move(data)};
     }
   }
 
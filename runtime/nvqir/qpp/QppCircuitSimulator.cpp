@@ -8,7 +8,10 @@
 
 #include "CircuitSimulator.h"
 #include "Gates.h"
+#include "StateSampler.h"
+#include "StateVectorKernels.h"
 #include "qpp.h"
+#include <bit>
 #include <iostream>
 
 namespace nvqir {
@@ -19,14 +22,83 @@ namespace nvqir {
 template <typename StateType>
 class QppCircuitSimulator : public nvqir::CircuitSimulatorBase<double> {
 protected:
-  /// The QPP state representation (qpp::ket or qpp::cmat)
-  StateType state;
+  static constexpr bool isStateVector = std::is_same_v<StateType, qpp::ket>;
+
+  /// The QPP state representation (qpp::ket or qpp::cmat). The state vector
+  /// is a view of stateBuffer, see growStateVector().
+  std::conditional_t<isStateVector, Eigen::Map<qpp::ket>, StateType> state =
+      makeEmptyState();
+
+  /// @brief Storage backing the state vector. It grows in place and keeps its
+  /// capacity across resets, so repeated sample / observe invocations do not
+  /// reallocate.
+  std::vector<std::complex<double>> stateBuffer;
+
+  static auto makeEmptyState() {
+    if constexpr (isStateVector)
+      return Eigen::Map<qpp::ket>(nullptr, 0);
+    else
+      return StateType();
+  }
+
+  /// @brief Grow the state vector by `count` qubits, in place. qpp is big
+  /// endian, so the new |0> qubits are the least significant bits: amplitude
+  /// i moves to i << count and the remaining amplitudes are zero.
+  void growStateVector(const std::size_t count) {
+    const std::size_t oldDim = state.size();
+    const std::size_t newDim = (oldDim == 0 ? 1ULL : oldDim) << count;
+    // Zero-extend, this only reallocates if the capacity is exceeded.
+    stateBuffer.resize(newDim);
+    if (oldDim == 0) {
+      stateBuffer[0] = 1.0;
+    } else {
+      for (std::size_t i = oldDim - 1; i > 0; i--) {
+        stateBuffer[i << count] = stateBuffer[i];
+        stateBuffer[i] = 0.0;
+      }
+    }
+    new (&state) Eigen::Map<qpp::ket>(stateBuffer.data(), newDim);
+  }
 
   /// Convert from little endian to big endian.
   std::size_t bigEndian(const int n_qubits, const int bit) {
     return n_qubits - bit - 1;
   }
 
+  /// @brief Convert the non-identity terms of `op` to X and Z masks over the
+  /// state index bits of an `nQubits` qubit state vector, along with their
+  /// real coefficients. Return the sum of the identity term coefficients.
+  double getPauliMasks(const cudaq::spin_op &op, const std::size_t nQubits,
+                       std::vector<std::uint64_t> &xMasks,
+                       std::vector<std::uint64_t> &zMasks,
+                       std::vector<double> &termCoefficients) {
+    const std::size_t nSpinQubits = op.n_qubits();
+    if (nSpinQubits > nQubits)
+      throw std::runtime_error(
+          "The spin_op acts on more qubits than are allocated.");
+
+    double identitySum = 0.0;
+    for (std::size_t t = 0; t < op.n_terms(); t++) {
+      auto term = op.get_term_view(t);
+      if (term.is_identity()) {
+        identitySum += term.get_coefficient().real();
+        continue;
+      }
+      std::uint64_t x = 0, z = 0;
+      for (std::size_t i = 0; i < nSpinQubits; i++) {
+        auto pauli = term.get_pauli(i);
+        if (pauli == cudaq::pauli::X || pauli == cudaq::pauli::Y)
+          x |= 1ULL << bigEndian(nQubits, i);
+        if (pauli == cudaq::pauli::Z || pauli == cudaq::pauli::Y)
+          z |= 1ULL << bigEndian(nQubits, i);
+      }
+      xMasks.push_back(x);
+      zMasks.push_back(z);
+      termCoefficients.push_back(term.get_coefficient().real());
+    }
+    return identitySum;
+  }
+
   /// @brief Compute the expectation value <Z...Z> over the given qubit indices.
   /// @param qubit_indices
   /// @return expectation
@@ -71,79 +143,171 @@ protected:
     return result;
   }
 
-  qpp::cmat toQppMatrix(const std::vector<std::complex<double>> &data,
+  qpp::cmat toQppMatrix(const std::complex<double> *data,
                         std::size_t nTargets) {
     auto nRows = (1UL << nTargets);
-    assert(data.size() == nRows * nRows &&
-           "Invalid number of gate matrix elements passed to toQppMatrix");
 
     // we represent row major, they represent column major
     return Eigen::Map<Eigen::Matrix<std::complex<double>, Eigen::Dynamic,
                                     Eigen::Dynamic, Eigen::RowMajor>>(
-        const_cast<std::complex<double> *>(data.data()), nRows, nRows);
+        const_cast<std::complex<double> *>(data), nRows, nRows);
   }
 
   /// @brief Grow the state vector by one qubit.
   void addQubitToState() override {
-    // Update the state vector
-    if (state.size() == 0) {
-      // If this is the first time, allocate the state
-      state = qpp::ket::Zero(stateDimension);
-      state(0) = 1.0;
+    if constexpr (isStateVector)
+      growStateVector(1);
+  }
+
+  /// @brief Grow the state vector by `count` qubits at once.
+  void addQubitsToState(const std::size_t count) override {
+    if constexpr (isStateVector)
+      growStateVector(count);
+    else
+      CircuitSimulatorBase<double>::addQubitsToState(count);
+  }
+
+  /// @brief Reset the qubit state. The state vector buffer keeps its
+  /// capacity for the next allocation.
+  void resetQubitStateImpl() override {
+    if constexpr (isStateVector) {
+      stateBuffer.clear();
+      new (&state) Eigen::Map<qpp::ket>(nullptr, 0);
     } else {
-      // If we are resizing an existing, allocate
-      // a zero state on a single qubit, and Kron-prod
-      // that with the existing state.
-      qpp::ket zero_state = qpp::ket::Zero(2);
-      zero_state(0) = 1.0;
-      state = qpp::kron(state, zero_state);
+      StateType tmp;
+      state = tmp;
     }
   }
 
-  /// @brief Reset the qubit state.
-  void resetQubitStateImpl() override {
-    StateType tmp;
-    state = tmp;
+  /// @brief The state vector backend computes <psi | H | psi> directly
+  /// for observe without shots. Shot-based observe needs the sampled counts,
+  /// so it still goes through the basis change and sampling path. As in
+  /// NVQIR, a shot count of -1 (stored in the size_t field) means no shots.
+  bool canHandleObserve() override {
+    if constexpr (!isStateVector)
+      return false;
+    return executionContext && static_cast<int>(executionContext->shots) < 1;
   }
 
-  void applyGate(const GateApplicationTask &task) override {
-    auto matrix = toQppMatrix(task.matrix, task.targets.size());
-    state = qpp::applyCTRL(state, matrix, task.controls, task.targets);
+  /// @brief Seed the qpp (thread local) generator, it drives measurements,
+  /// sampling and the noise trajectories.
+  void setRandomSeed(std::size_t seed) override {
+    std::seed_seq seedSeq{static_cast<std::uint32_t>(seed),
+                          static_cast<std::uint32_t>(seed >> 32)};
+    qpp::RandomDevices::get_instance().get_prng().seed(seedSeq);
   }
 
-public:
-  QppCircuitSimulator() = default;
-  virtual ~QppCircuitSimulator() = default;
+  /// @brief Apply the gate in place to the state vector `data` of `nQubits`
+  /// qubits, with the native kernels rather than qpp::applyCTRL, which
+  /// returns a full copy of the state.
+  void applyGateToStateVector(std::complex<double> *data,
+                              const std::size_t nQubits,
+                              const GateApplicationTask &task) {
+    std::vector<std::size_t> controlBits, targetBits;
+    controlBits.reserve(task.controls.size());
+    targetBits.reserve(task.targets.size());
+    for (auto c : task.controls)
+      controlBits.push_back(bigEndian(nQubits, c));
+    for (auto t : task.targets)
+      targetBits.push_back(bigEndian(nQubits, t));
+    kernels::applyMatrix(data, nQubits, task.matrix.data(), controlBits,
+                         targetBits);
+  }
 
-  /// @brief Override the default sized allocation of qubits
-  /// here to be a bit more efficient than the default implementation
-  std::vector<std::size_t> allocateQubits(const std::size_t count) override {
-    std::vector<std::size_t> qubits;
-    for (std::size_t i = 0; i < count; i++)
-      qubits.emplace_back(tracker.getNextIndex());
-
-    if (state.size() == 0) {
-      // If this is the first time, allocate the state
-      nQubitsAllocated += count;
-      stateDimension = calculateStateDim(nQubitsAllocated);
-      state = qpp::ket::Zero(stateDimension);
-      state(0) = 1.0;
-      return qubits;
-    }
+  /// @brief Compute <psi | H | psi> and its gradient with respect to the gate
+  /// tape parameters. With |psi> = U_L ... U_1 |0>, the sweep keeps
+  /// |phi> = U_l ... U_1 |0> and |lambda> = U_(l+1)^dag ... U_L^dag H |psi>,
+  /// and dE / dtheta_l = 2 Re <lambda | dU_l / dtheta_l | phi_(l-1)>. This
+  /// costs about two circuit evaluations and three state vectors, whatever
+  /// the number of parameters.
+  std::vector<double> computeAdjointGradient(const cudaq::spin_op &op,
+                                             double &expectation) override {
+    if constexpr (!isStateVector) {
+      return CircuitSimulatorBase<double>::computeAdjointGradient(op,
+                                                                  expectation);
+    } else {
+      if (executionContext && executionContext->noiseModel)
+        throw std::runtime_error(
+            "The adjoint gradient does not support noise models.");
+
+      const std::size_t dim = state.size();
+      const std::size_t nQubits = std::countr_zero(dim);
+      std::vector<std::uint64_t> xMasks, zMasks;
+      std::vector<double> termCoefficients;
+      double identitySum =
+          getPauliMasks(op, nQubits, xMasks, zMasks, termCoefficients);
+
+      std::vector<std::complex<double>> phi(state.data(), state.data() + dim);
+      std::vector<std::complex<double>> lambda(dim), mu(dim);
+      kernels::applyPauliSum(phi.data(), dim, xMasks, zMasks, termCoefficients,
+                             identitySum, lambda.data());
+      expectation =
+          kernels::innerProduct(phi.data(), lambda.data(), dim).real();
 
-    nQubitsAllocated += count;
-    stateDimension = calculateStateDim(nQubitsAllocated);
+      std::size_t nParameters = 0;
+      for (auto &task : gateTape)
+        nParameters += task.parameters.size();
+      std::vector<double> gradient(nParameters, 0.0);
 
-    // If we are resizing an existing, allocate
-    // a zero state on a n qubit, and Kron-prod
-    // that with the existing state.
-    qpp::ket zero_state = qpp::ket::Zero((1UL << count));
-    zero_state(0) = 1.0;
-    state = qpp::kron(state, zero_state);
+      for (auto iter = gateTape.rbegin(); iter != gateTape.rend(); ++iter) {
+        const auto &task = *iter;
+        // Build U^dag from the row-major gate matrix.
+        auto inverse = task;
+        const std::size_t gateDim = 1ULL << task.targets.size();
+        for (std::size_t r = 0; r < gateDim; r++)
+          for (std::size_t c = 0; c < gateDim; c++)
+            inverse.matrix[r * gateDim + c] =
+                std::conj(task.matrix[c * gateDim + r]);
+        applyGateToStateVector(phi.data(), nQubits, inverse);
 
-    return qubits;
+        // The derivative of a controlled gate vanishes unless all the
+        // controls are set, so project onto that subspace first.
+        std::size_t ctrlMask = 0;
+        for (auto c : task.controls)
+          ctrlMask |= 1ULL << bigEndian(nQubits, c);
+        const std::span<const double> angles(task.parameters.data(),
+                                             task.parameters.size());
+        for (std::size_t p = angles.size(); p-- > 0;) {
+#pragma omp parallel for if (dim >= kernels::ParallelThreshold)
+          for (std::size_t i = 0; i < dim; i++)
+            mu[i] = (i & ctrlMask) == ctrlMask ? phi[i] : 0.0;
+
+          auto derivative = task;
+          auto dU = getOneQubitGateDerivative<double>(task.gate, angles, p);
+          derivative.matrix.assign(dU.begin(), dU.end());
+          applyGateToStateVector(mu.data(), nQubits, derivative);
+          gradient[--nParameters] =
+              2. * kernels::innerProduct(lambda.data(), mu.data(), dim).real();
+        }
+
+        applyGateToStateVector(lambda.data(), nQubits, inverse);
+      }
+
+      cudaq::info("Computed expectation value = {} and {} adjoint gradients",
+                  expectation, gradient.size());
+      return gradient;
+    }
   }
 
+  void applyGate(const GateApplicationTask &task) override {
+    if constexpr (std::is_same_v<StateType, qpp::ket>) {
+      // Note the state may be larger than nQubitsAllocated after
+      // deallocations, so derive the qubit count from the state.
+      applyGateToStateVector(state.data(),
+                             std::countr_zero<std::size_t>(state.size()), task);
+    } else {
+      auto matrix = toQppMatrix(task.matrix.data(), task.targets.size());
+      state = qpp::applyCTRL(
+          state, matrix,
+          std::vector<qpp::idx>(task.controls.begin(), task.controls.end()),
+          std::vector<qpp::idx>(task.targets.begin(), task.targets.end()));
+    }
+  }
+
+public:
+  QppCircuitSimulator() = default;
+  virtual ~QppCircuitSimulator() = default;
+
   /// @brief Measure the qubit and return the result. Collapse the
   /// state vector.
   bool measureQubit(const std::size_t qubitIdx) override {
@@ -176,33 +340,88 @@ public:
   /// @brief Sample the multi-qubit state.
   cudaq::ExecutionResult sample(const std::vector<std::size_t> &measuredBits,
                                 const int shots) override {
-    double expectationValue = calculateExpectationValue(measuredBits);
     if (shots < 1) {
+      double expectationValue = calculateExpectationValue(measuredBits);
       cudaq::info("Computed expectation value = {}", expectationValue);
       return cudaq::ExecutionResult{{}, expectationValue};
     }
 
-    auto sampleResult = qpp::sample(shots, state, measuredBits, 2);
-    // Convert to what we expect
-    std::stringstream bitstring;
-    cudaq::ExecutionResult counts(expectationValue);
+    // Draw all shots in a single sweep over the basis state probabilities,
+    // which also yields <Z...Z>. Outcomes are kept as integer keys and only
+    // converted to bit strings for the ExecutionResult.
+    std::size_t dim;
+    if constexpr (isStateVector)
+      dim = state.size();
+    else
+      dim = state.rows();
+    const std::size_t nQubits = std::countr_zero(dim);
+    std::vector<std::size_t> measuredIndexBits;
+    measuredIndexBits.reserve(measuredBits.size());
+    for (auto qubit : measuredBits)
+      measuredIndexBits.push_back(bigEndian(nQubits, qubit));
 
-    for (auto [result, count] : sampleResult) {
-      // Push back each term in the vector of bits to the bitstring.
-      for (const auto &bit : result) {
-        bitstring << bit;
-      }
+    auto probability = [&](std::size_t i) -> double {
+      if constexpr (isStateVector)
+        return std::norm(state[i]);
+      else
+        return state(i, i).real();
+    };
+    auto sampleResult = kernels::sampleBasisStates(
+        dim, probability, measuredIndexBits, shots,
+        qpp::RandomDevices::get_instance().get_prng());
 
-      // Add to the sample result
-      // in mid-circ sampling mode this will append 1 bitstring
-      counts.appendResult(bitstring.str(), count);
+    // in mid-circ sampling mode this will append 1 bitstring
+    cudaq::ExecutionResult counts(sampleResult.expectationValue);
+    for (auto &[key, count] : sampleResult.counts) {
+      auto bits = kernels::keyToPackedBits(key, measuredBits.size());
+      counts.appendResult(&bits, measuredBits.size(), count);
+    }
+    return counts;
+  }
 
-      // Reset the state.
-      bitstring.str("");
-      bitstring.clear();
+  /// @brief Register the expectation value of each non-identity term of `op`
+  /// under the term string, in the order produced by getPauliMasks, and
+  /// return the per-term results along with the total expectation value.
+  cudaq::observe_result
+  makeObserveResult(const cudaq::spin_op &op, double identitySum,
+                    const std::vector<double> &termCoefficients,
+                    const std::vector<double> &expectations) {
+    double sum = identitySum;
+    std::vector<cudaq::ExecutionResult> results;
+    results.reserve(expectations.size());
+    for (std::size_t t = 0, i = 0; t < op.n_terms(); t++) {
+      if (op.get_term_view(t).is_identity())
+        continue;
+      results.emplace_back(cudaq::CountsDictionary{},
+                           op[t].to_string(false), expectations[i]);
+      sum += termCoefficients[i] * expectations[i];
+      i++;
     }
+    return cudaq::observe_result(sum, op, cudaq::sample_result(sum, results));
+  }
 
-    return counts;
+  /// @brief Compute <psi | H | psi> directly from the binary symplectic form
+  /// of the terms, in a single pass over the state vector and without
+  /// applying basis change gates.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    if constexpr (!isStateVector) {
+      return CircuitSimulatorBase<double>::observe(op);
+    } else {
+      flushGateQueue();
+      const std::size_t dim = state.size();
+      const std::size_t nQubits = std::countr_zero(dim);
+      std::vector<std::uint64_t> xMasks, zMasks;
+      std::vector<double> termCoefficients;
+      const double identitySum =
+          getPauliMasks(op, nQubits, xMasks, zMasks, termCoefficients);
+
+      auto expectations =
+          kernels::pauliExpectations(state.data(), dim, xMasks, zMasks);
+      auto result =
+          makeObserveResult(op, identitySum, termCoefficients, expectations);
+      cudaq::info("Computed expectation value = {}", result.exp_val_z());
+      return result;
+    }
   }
 
   cudaq::State getStateData() override {
@@ -212,8 +431,22 @@ public:
                         {state.data(), state.data() + state.size()}};
   }
 
+  /// @brief The state is reset next, so hand the state vector buffer over
+  /// without copying it. The next allocation grows a new buffer.
+  cudaq::State takeStateData() override {
+    if constexpr (isStateVector) {
+      flushGateQueue();
+      new (&state) Eigen::Map<qpp::ket>(nullptr, 0);
+      cudaq::State data{{stateDimension}, std::move(stateBuffer)};
+      stateBuffer = {};
+      return data;
+    } else {
+      return getStateData();
+    }
+  }
+
   /// @brief Primarily used for testing.
-  auto getStateVector() {
+  StateType getStateVector() {
     flushGateQueue();
     return state;
   }
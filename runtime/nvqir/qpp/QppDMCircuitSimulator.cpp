@@ -18,8 +18,120 @@ namespace {
 class QppNoiseCircuitSimulator : public nvqir::QppCircuitSimulator<qpp::cmat> {
 
 protected:
+  /// @brief The superoperators of the kraus_channels the noise model applies
+  /// after a gate on a list of qubits. Each superoperator sum_i K_i x K_i^*
+  /// is stored row-major, acting on the 4^k entries of a 2^k x 2^k block of
+  /// the density matrix indexed by (column, row).
+  struct NoiseCacheEntry {
+    std::string gateName;
+    std::vector<std::size_t> qubits;
+    std::vector<std::vector<std::complex<double>>> superOperators;
+  };
+
+  /// @brief The noise cache, keyed by the hash of the gate name and qubits.
+  /// Gates without noise channels are cached as well, with no superoperator.
+  std::unordered_multimap<std::size_t, NoiseCacheEntry> noiseCache;
+
+  /// @brief The noise_model version the noise cache was built for.
+  std::size_t noiseCacheVersion = 0;
+
+  static std::size_t hashNoiseKey(const std::string_view gateName,
+                                  const std::vector<std::size_t> &qubits) {
+    auto hash = std::hash<std::string_view>{}(gateName);
+    for (auto q : qubits)
+      hash ^= q + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+
+  /// @brief Return the superoperator sum_i K_i x K_i^* of the channel, for
+  /// the column-major kraus_ops K_i.
+  static std::vector<std::complex<double>>
+  makeSuperOperator(cudaq::kraus_channel &channel) {
+    const std::size_t dim = channel.dimension();
+    const std::size_t superDim = dim * dim;
+    std::vector<std::complex<double>> superOp(superDim * superDim, 0.0);
+    for (auto &op : channel.get_ops()) {
+      auto k = [&](std::size_t r, std::size_t c) {
+        return op.data[c * dim + r];
+      };
+      for (std::size_t c = 0; c < dim; c++)
+        for (std::size_t r = 0; r < dim; r++)
+          for (std::size_t cc = 0; cc < dim; cc++)
+            for (std::size_t rr = 0; rr < dim; rr++)
+              superOp[(c * dim + r) * superDim + cc * dim + rr] +=
+                  std::conj(k(c, cc)) * k(r, rr);
+    }
+    return superOp;
+  }
+
+  /// @brief Return the cached noise of the gate on the given qubits, building
+  /// it on first use. The cache is rebuilt if the noise model changes.
+  const NoiseCacheEntry &getNoise(const std::string_view gateName,
+                                  const std::vector<std::size_t> &qubits) {
+    auto &noiseModel = *executionContext->noiseModel;
+    if (noiseModel.get_version() != noiseCacheVersion) {
+      noiseCache.clear();
+      noiseCacheVersion = noiseModel.get_version();
+    }
+
+    const auto hash = hashNoiseKey(gateName, qubits);
+    auto [begin, end] = noiseCache.equal_range(hash);
+    for (auto iter = begin; iter != end; ++iter)
+      if (iter->second.gateName == gateName && iter->second.qubits == qubits)
+        return iter->second;
+
+    NoiseCacheEntry entry{std::string(gateName), qubits, {}};
+    for (auto &channel : noiseModel.get_channels(entry.gateName, qubits))
+      entry.superOperators.push_back(makeSuperOperator(channel));
+    return noiseCache.emplace(hash, std::move(entry))->second;
+  }
+
+  /// @brief Scratch buffers for the gates and channels, reused so that the
+  /// hot path does not allocate.
+  std::vector<std::complex<double>> conjMatrix;
+  std::vector<std::size_t> controlBits;
+  std::vector<std::size_t> targetBits;
+
+  /// @brief Append the bit positions of the given qubits in the row (or
+  /// column) index of the column-major density matrix, viewed as a state
+  /// vector of 2 * nQubits qubits whose high half indexes the column.
+  void appendDensityBits(const std::size_t nQubits,
+                         std::span<const std::size_t> qubits, const bool column,
+                         std::vector<std::size_t> &bits) {
+    for (auto q : qubits)
+      bits.push_back(bigEndian(nQubits, q) + (column ? nQubits : 0));
+  }
+
+  /// @brief Apply rho -> U rho U^dag in place: U acts on the row index and
+  /// U^* on the column index of the density matrix.
+  void applyGate(const GateApplicationTask &task) override {
+    const auto nQubits = std::countr_zero<std::size_t>(state.rows());
+    std::span<const std::size_t> controls(task.controls.begin(),
+                                          task.controls.end());
+    std::span<const std::size_t> targets(task.targets.begin(),
+                                         task.targets.end());
+    controlBits.clear();
+    targetBits.clear();
+    appendDensityBits(nQubits, controls, false, controlBits);
+    appendDensityBits(nQubits, targets, false, targetBits);
+    nvqir::kernels::applyMatrix(state.data(), 2 * nQubits, task.matrix.data(),
+                                controlBits, targetBits);
+
+    conjMatrix.assign(task.matrix.begin(), task.matrix.end());
+    for (auto &element : conjMatrix)
+      element = std::conj(element);
+    controlBits.clear();
+    targetBits.clear();
+    appendDensityBits(nQubits, controls, true, controlBits);
+    appendDensityBits(nQubits, targets, true, targetBits);
+    nvqir::kernels::applyMatrix(state.data(), 2 * nQubits, conjMatrix.data(),
+                                controlBits, targetBits);
+  }
+
   /// @brief If we have a noise model, apply any user-specified
-  /// kraus_channels for the given gate name on the provided qubits.
+  /// kraus_channels for the given gate name on the provided qubits. The
+  /// channels are applied in place, as cached superoperators on the 4^k
+  /// blocks of the density matrix.
   /// @param gateName
   /// @param qubits
   void applyNoiseChannel(const std::string_view gateName,
@@ -32,32 +144,26 @@ protected:
     if (!executionContext->noiseModel)
       return;
 
-    // Get the name as a string
-    std::string gName(gateName);
-
-    // Get the Kraus channels specified for this gate and qubits
-    auto krausChannels =
-        executionContext->noiseModel->get_channels(gName, qubits);
+    // Get the (cached) channels specified for this gate and qubits
+    auto &noise = getNoise(gateName, qubits);
 
     // If none, do nothing
-    if (krausChannels.empty())
+    if (noise.superOperators.empty())
       return;
 
-    cudaq::info("Applying {} kraus channels to qubits {}", krausChannels.size(),
-                qubits);
-
-    for (auto &channel : krausChannels) {
-      // Map our kraus ops to the qpp::cmat
-      std::vector<qpp::cmat> K;
-      auto ops = channel.get_ops();
-      std::transform(
-          ops.begin(), ops.end(), std::back_inserter(K), [&](auto &el) {
-            return Eigen::Map<qpp::cmat>(el.data.data(), el.nRows, el.nCols);
-          });
-
-      // Apply K rho Kdag
-      state = qpp::apply(state, K, qubits);
-    }
+    cudaq::info("Applying {} kraus channels to qubits {}",
+                noise.superOperators.size(), qubits);
+
+    // The block index is (column, row), the column bits are the most
+    // significant.
+    const auto nQubits = std::countr_zero<std::size_t>(state.rows());
+    controlBits.clear();
+    targetBits.clear();
+    appendDensityBits(nQubits, qubits, true, targetBits);
+    appendDensityBits(nQubits, qubits, false, targetBits);
+    for (auto &superOp : noise.superOperators)
+      nvqir::kernels::applyMatrix(state.data(), 2 * nQubits, superOp.data(),
+                                  controlBits, targetBits);
   }
 
   /// @brief Grow the density matrix by one qubit.
@@ -117,6 +223,14 @@ public:
     return cudaq::State{{stateDimension, stateDimension},
                         {state.data(), state.data() + state.size()}};
   }
+
+  /// @brief The state is reset next, so move the density matrix out rather
+  /// than copying it.
+  cudaq::State takeStateData() override {
+    flushGateQueue();
+    auto owned = std::make_shared<qpp::cmat>(std::move(state));
+    return cudaq::State{{stateDimension, stateDimension}, owned->data(), owned};
+  }
 };
 
 } // namespace
@@ -0,0 +1,422 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+
+#include <variant>
+
+namespace {
+
+/// @brief The QppTrajectoryCircuitSimulator models noise with Monte Carlo
+/// (quantum) trajectories on a 2^n state vector, rather than evolving a 4^n
+/// density matrix. After each gate, one Kraus operator of every matching
+/// kraus_channel is drawn with its probability ||K psi||^2 and applied to the
+/// normalized state.
+///
+/// The simulator records the executed circuit (gates and noise channels).
+/// When the circuit is sampled or observed, it is replayed as independent
+/// trajectories, in parallel across threads, and the results of all
+/// trajectories are aggregated. The number of trajectories trades accuracy
+/// for time, it is set by the CUDAQ_NUM_TRAJECTORIES environment variable
+/// (default 1000, for sampling at most one per shot). Circuits with
+/// mid-circuit measurements or resets are not replayed, each execution
+/// (shot) is then one trajectory.
+class QppTrajectoryCircuitSimulator
+    : public nvqir::QppCircuitSimulator<qpp::ket> {
+public:
+  /// @brief The default number of trajectories per sample / observe task.
+  static constexpr std::size_t DefaultNumTrajectories = 1000;
+
+  /// @brief Trajectories run in parallel, each on a private state vector, up
+  /// to this many qubits. Larger trajectories run one after the other, with
+  /// the parallel gate kernels.
+  static constexpr std::size_t MaxParallelTrajectoryQubits = 20;
+
+protected:
+  using Base = nvqir::QppCircuitSimulator<qpp::ket>;
+
+  /// @brief A kraus_channel applied at a point of the recorded circuit. The
+  /// operators are stored row-major. If the channel is a mixture of unitaries
+  /// (K^dag K is proportional to the identity for each K), the operators are
+  /// normalized to unitaries and `probabilities` holds their state independent
+  /// probabilities. Otherwise `probabilities` is empty and `gramMatrices`
+  /// holds K^dag K for each operator.
+  struct NoiseChannel {
+    std::vector<std::size_t> qubits;
+    std::vector<std::vector<std::complex<double>>> ops;
+    std::vector<std::vector<std::complex<double>>> gramMatrices;
+    std::vector<double> probabilities;
+  };
+
+  /// @brief The recorded circuit, since the state was last reset. The noise
+  /// channels are shared with the noise cache.
+  std::vector<
+      std::variant<GateApplicationTask, std::shared_ptr<const NoiseChannel>>>
+      circuit;
+
+  /// @brief The noise channels the noise model applies after a gate on a
+  /// list of qubits.
+  struct NoiseCacheEntry {
+    std::string gateName;
+    std::vector<std::size_t> qubits;
+    std::vector<std::shared_ptr<const NoiseChannel>> channels;
+  };
+
+  /// @brief The noise cache, keyed by the hash of the gate name and qubits.
+  /// Gates without noise channels are cached as well, with no channel.
+  std::unordered_multimap<std::size_t, NoiseCacheEntry> noiseCache;
+
+  /// @brief The noise_model version the noise cache was built for.
+  std::size_t noiseCacheVersion = 0;
+
+  /// @brief False if the state was collapsed or reset since it was last
+  /// empty, in which case the circuit cannot be replayed.
+  bool circuitIsReplayable = true;
+
+  /// @brief True if the recorded circuit contains noise channels.
+  bool circuitHasNoise = false;
+
+  /// @brief The number of trajectories per sample / observe task. Defaults
+  /// to the CUDAQ_NUM_TRAJECTORIES environment variable.
+  std::size_t numTrajectories = DefaultNumTrajectories;
+
+  /// @brief Scratch buffers of applyNoiseToStateVector, one per thread, so
+  /// that applying a channel does not allocate.
+  struct NoiseScratch {
+    std::vector<std::size_t> targetBits;
+    std::vector<double> probabilities;
+    std::vector<std::complex<double>> op;
+  };
+
+  /// @brief Convert the (column-major) kraus_channel operators on the given
+  /// qubits to a NoiseChannel.
+  static NoiseChannel makeNoiseChannel(cudaq::kraus_channel &channel,
+                                       const std::vector<std::size_t> &qubits) {
+    NoiseChannel noise{qubits, {}, {}, {}};
+    bool isUnitaryMixture = true;
+    std::vector<double> scales;
+    for (auto &op : channel.get_ops()) {
+      const std::size_t dim = op.nRows;
+      std::vector<std::complex<double>> k(dim * dim), gram(dim * dim, 0.0);
+      for (std::size_t r = 0; r < dim; r++)
+        for (std::size_t c = 0; c < dim; c++)
+          k[r * dim + c] = op.data[c * dim + r];
+      for (std::size_t r = 0; r < dim; r++)
+        for (std::size_t c = 0; c < dim; c++)
+          for (std::size_t m = 0; m < dim; m++)
+            gram[r * dim + c] += std::conj(k[m * dim + r]) * k[m * dim + c];
+
+      // A scaled unitary has K^dag K = scale * I.
+      const double scale = gram[0].real();
+      for (std::size_t r = 0; r < dim; r++)
+        for (std::size_t c = 0; c < dim; c++)
+          if (std::abs(gram[r * dim + c] - (r == c ? scale : 0.0)) > 1e-12)
+            isUnitaryMixture = false;
+
+      noise.ops.push_back(std::move(k));
+      noise.gramMatrices.push_back(std::move(gram));
+      scales.push_back(scale);
+    }
+
+    if (isUnitaryMixture) {
+      for (std::size_t i = 0; i < noise.ops.size(); i++)
+        if (scales[i] > 0.0)
+          for (auto &element : noise.ops[i])
+            element /= std::sqrt(scales[i]);
+      noise.probabilities = std::move(scales);
+      noise.gramMatrices.clear();
+    }
+    return noise;
+  }
+
+  static std::size_t hashNoiseKey(const std::string_view gateName,
+                                  const std::vector<std::size_t> &qubits) {
+    auto hash = std::hash<std::string_view>{}(gateName);
+    for (auto q : qubits)
+      hash ^= q + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+
+  /// @brief Return the cached noise of the gate on the given qubits, building
+  /// it on first use. The cache is rebuilt if the noise model changes.
+  const NoiseCacheEntry &getNoise(const std::string_view gateName,
+                                  const std::vector<std::size_t> &qubits) {
+    auto &noiseModel = *executionContext->noiseModel;
+    if (noiseModel.get_version() != noiseCacheVersion) {
+      noiseCache.clear();
+      noiseCacheVersion = noiseModel.get_version();
+    }
+
+    const auto hash = hashNoiseKey(gateName, qubits);
+    auto [begin, end] = noiseCache.equal_range(hash);
+    for (auto iter = begin; iter != end; ++iter)
+      if (iter->second.gateName == gateName && iter->second.qubits == qubits)
+        return iter->second;
+
+    NoiseCacheEntry entry{std::string(gateName), qubits, {}};
+    for (auto &channel : noiseModel.get_channels(entry.gateName, qubits))
+      entry.channels.push_back(std::make_shared<const NoiseChannel>(
+          makeNoiseChannel(channel, qubits)));
+    return noiseCache.emplace(hash, std::move(entry))->second;
+  }
+
+  /// @brief Draw one Kraus operator of the channel with probability
+  /// ||K psi||^2, and apply K / ||K psi|| in place to the state vector `data`
+  /// of `nQubits` qubits.
+  template <typename RandomEngine>
+  void applyNoiseToStateVector(std::complex<double> *data,
+                               const std::size_t nQubits,
+                               const NoiseChannel &noise, RandomEngine &gen) {
+    thread_local NoiseScratch scratch;
+    // The bit positions depend on the number of qubits, which may differ
+    // between the uses of a cached channel.
+    scratch.targetBits.clear();
+    for (auto q : noise.qubits)
+      scratch.targetBits.push_back(bigEndian(nQubits, q));
+
+    const std::vector<double> *probabilities = &noise.probabilities;
+    if (!noise.gramMatrices.empty()) {
+      scratch.probabilities.clear();
+      for (auto &gram : noise.gramMatrices)
+        scratch.probabilities.push_back(nvqir::kernels::localExpectation(
+            data, nQubits, gram.data(), scratch.targetBits));
+      probabilities = &scratch.probabilities;
+    }
+
+    // Draw k with probability (*probabilities)[k] / total, without the
+    // allocations of std::discrete_distribution.
+    double total = 0.0;
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < probabilities->size(); i++)
+      if ((*probabilities)[i] > 0.0) {
+        total += (*probabilities)[i];
+        k = i;
+      }
+    auto draw = total * std::uniform_real_distribution<double>()(gen);
+    for (std::size_t i = 0; i < k; i++) {
+      if (draw < (*probabilities)[i]) {
+        k = i;
+        break;
+      }
+      draw -= (*probabilities)[i];
+    }
+
+    // The operators of unitary mixtures are already normalized.
+    const std::complex<double> *op = noise.ops[k].data();
+    if (!noise.gramMatrices.empty()) {
+      const double norm = std::sqrt((*probabilities)[k]);
+      scratch.op.assign(noise.ops[k].begin(), noise.ops[k].end());
+      for (auto &element : scratch.op)
+        element /= norm;
+      op = scratch.op.data();
+    }
+    nvqir::kernels::applyMatrix(data, nQubits, op, {}, scratch.targetBits);
+  }
+
+  /// @brief Record the gate after applying it.
+  void applyGate(const GateApplicationTask &task) override {
+    Base::applyGate(task);
+    circuit.emplace_back(task);
+  }
+
+  /// @brief Apply one Kraus operator of each matching kraus_channel to the
+  /// current trajectory, and record the channels.
+  void applyNoiseChannel(const std::string_view gateName,
+                         const std::vector<std::size_t> &qubits) override {
+    if (!executionContext || !executionContext->noiseModel)
+      return;
+
+    // Get the (cached) channels specified for this gate and qubits
+    auto &noise = getNoise(gateName, qubits);
+    if (noise.channels.empty())
+      return;
+
+    cudaq::info("Applying {} kraus channels to qubits {}",
+                noise.channels.size(), qubits);
+    const auto nQubits = std::countr_zero<std::size_t>(state.size());
+    for (auto &channel : noise.channels) {
+      applyNoiseToStateVector(state.data(), nQubits, *channel,
+                              qpp::RandomDevices::get_instance().get_prng());
+      circuit.emplace_back(channel);
+      circuitHasNoise = true;
+    }
+  }
+
+  void resetQubitStateImpl() override {
+    Base::resetQubitStateImpl();
+    circuit.clear();
+    circuitIsReplayable = true;
+    circuitHasNoise = false;
+  }
+
+  /// @brief Return true if sample / observe should aggregate many
+  /// trajectories of the recorded circuit.
+  bool shouldRunTrajectories() const {
+    return executionContext && circuitHasNoise && circuitIsReplayable &&
+           !executionContext->hasConditionalsOnMeasureResults &&
+           numTrajectories > 1;
+  }
+
+  /// @brief Run `nTrajectories` trajectories of the recorded circuit, and
+  /// invoke process(t, data, gen) on the final state vector of each
+  /// trajectory t, with its random number engine. The current state is the
+  /// first trajectory, the others are replayed in parallel from |0...0>,
+  /// each with its own state vector and random number engine.
+  template <typename Process>
+  void runTrajectories(const std::size_t nTrajectories,
+                       const Process &process) {
+    auto &prng = qpp::RandomDevices::get_instance().get_prng();
+    process(0, state.data(), prng);
+
+    const std::size_t dim = state.size();
+    const std::size_t nQubits = std::countr_zero(dim);
+    const std::uint64_t seed = prng();
+#pragma omp parallel if (nQubits <= MaxParallelTrajectoryQubits &&           \
+                             nTrajectories > 2)
+    {
+      std::vector<std::complex<double>> buffer(dim);
+#pragma omp for schedule(dynamic)
+      for (std::size_t t = 1; t < nTrajectories; t++) {
+        std::seed_seq seedSeq{static_cast<std::uint32_t>(seed),
+                              static_cast<std::uint32_t>(seed >> 32),
+                              static_cast<std::uint32_t>(t)};
+        std::mt19937_64 gen(seedSeq);
+        std::fill(buffer.begin(), buffer.end(), 0.0);
+        buffer[0] = 1.0;
+        for (auto &op : circuit) {
+          if (auto *task = std::get_if<GateApplicationTask>(&op))
+            applyGateToStateVector(buffer.data(), nQubits, *task);
+          else
+            applyNoiseToStateVector(
+                buffer.data(), nQubits,
+                *std::get<std::shared_ptr<const NoiseChannel>>(op), gen);
+        }
+        process(t, buffer.data(), gen);
+      }
+    }
+  }
+
+  /// @brief Mid-circuit measurements collapse the state, the circuit can no
+  /// longer be replayed.
+  bool measureQubit(const std::size_t qubitIdx) override {
+    circuitIsReplayable = false;
+    return Base::measureQubit(qubitIdx);
+  }
+
+public:
+  QppTrajectoryCircuitSimulator() {
+    if (auto *envVal = std::getenv("CUDAQ_NUM_TRAJECTORIES")) {
+      try {
+        numTrajectories = std::max<std::size_t>(1, std::stoul(envVal));
+      } catch (...) {
+        throw std::runtime_error("Invalid CUDAQ_NUM_TRAJECTORIES environment "
+                                 "variable, must be a positive integer.");
+      }
+    }
+  }
+  virtual ~QppTrajectoryCircuitSimulator() = default;
+
+  void resetQubit(const std::size_t qubitIdx) override {
+    circuitIsReplayable = false;
+    Base::resetQubit(qubitIdx);
+  }
+
+  /// @brief Sample the measured qubits over all trajectories. The shots are
+  /// split evenly between the trajectories.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &measuredBits,
+                                const int shots) override {
+    if (!shouldRunTrajectories())
+      return Base::sample(measuredBits, shots);
+
+    const std::size_t nTrajectories =
+        shots > 0 ? std::min<std::size_t>(numTrajectories, shots)
+                  : numTrajectories;
+    auto trajectoryShots = [&](std::size_t t) -> std::size_t {
+      if (shots < 1)
+        return 0;
+      return shots / nTrajectories + (t < shots % nTrajectories);
+    };
+
+    const std::size_t dim = state.size();
+    const std::size_t nQubits = std::countr_zero(dim);
+    std::vector<std::size_t> measuredIndexBits;
+    measuredIndexBits.reserve(measuredBits.size());
+    for (auto qubit : measuredBits)
+      measuredIndexBits.push_back(bigEndian(nQubits, qubit));
+
+    cudaq::info("Sampling {} shots over {} trajectories.", shots,
+                nTrajectories);
+    std::vector<nvqir::kernels::SampleCounts> results(nTrajectories);
+    runTrajectories(nTrajectories, [&](std::size_t t,
+                                       const std::complex<double> *data,
+                                       auto &gen) {
+      auto probability = [&](std::size_t i) { return std::norm(data[i]); };
+      results[t] = nvqir::kernels::sampleBasisStates(
+          dim, probability, measuredIndexBits, trajectoryShots(t), gen);
+    });
+
+    // Weigh each trajectory by its shots, or equally without shots.
+    std::unordered_map<std::uint64_t, std::size_t> counts;
+    double expectationValue = 0.0;
+    for (std::size_t t = 0; t < nTrajectories; t++) {
+      expectationValue += results[t].expectationValue *
+                          (shots > 0 ? trajectoryShots(t) : 1);
+      for (auto &[key, count] : results[t].counts)
+        counts[key] += count;
+    }
+    expectationValue /= shots > 0 ? shots : nTrajectories;
+
+    cudaq::ExecutionResult result(expectationValue);
+    for (auto &[key, count] : counts) {
+      auto bits = nvqir::kernels::keyToPackedBits(key, measuredBits.size());
+      result.appendResult(&bits, measuredBits.size(), count);
+    }
+    return result;
+  }
+
+  /// @brief Compute <psi | H | psi>, averaged over all trajectories.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    if (!shouldRunTrajectories())
+      return Base::observe(op);
+
+    const std::size_t dim = state.size();
+    std::vector<std::uint64_t> xMasks, zMasks;
+    std::vector<double> termCoefficients;
+    const double identitySum = getPauliMasks(
+        op, std::countr_zero(dim), xMasks, zMasks, termCoefficients);
+
+    std::vector<std::vector<double>> values(numTrajectories);
+    runTrajectories(numTrajectories, [&](std::size_t t,
+                                         const std::complex<double> *data,
+                                         auto &) {
+      values[t] = nvqir::kernels::pauliExpectations(data, dim, xMasks, zMasks);
+    });
+
+    std::vector<double> expectations(termCoefficients.size(), 0.0);
+    for (auto &trajectory : values)
+      for (std::size_t i = 0; i < expectations.size(); i++)
+        expectations[i] += trajectory[i] / numTrajectories;
+
+    auto result =
+        makeObserveResult(op, identitySum, termCoefficients, expectations);
+    cudaq::info("Computed expectation value = {} over {} trajectories",
+                result.exp_val_z(), numTrajectories);
+    return result;
+  }
+
+  std::string name() const override { return "trajectory"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(QppTrajectoryCircuitSimulator)
+};
+
+} // namespace
+
+/// Register this Simulator with NVQIR.
+NVQIR_REGISTER_SIMULATOR(QppTrajectoryCircuitSimulator, trajectory)
+#undef __NVQIR_QPP_TOGGLE_CREATE
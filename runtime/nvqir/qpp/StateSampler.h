@@ -0,0 +1,159 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvqir {
+namespace kernels {
+
+/// @brief Number of basis states handled per sampling chunk (and thread).
+constexpr std::size_t SampleChunkSize = 1ULL << 14;
+
+/// @brief The result of sampling a state: counts keyed by the integer value
+/// of the measured bits (the first measured bit is the most significant bit
+/// of the key), and the <Z...Z> expectation value over the measured bits.
+struct SampleCounts {
+  std::unordered_map<std::uint64_t, std::size_t> counts;
+  double expectationValue = 0.0;
+};
+
+/// @brief Draw `shots` samples from the basis state distribution given by
+/// `probability(i)`, i in [0, dim), and count the outcomes of the measured
+/// bits. This takes a single parallel sweep for the chunk probability sums
+/// (also accumulating the <Z...Z> expectation value) and a single parallel
+/// sweep that walks the sorted uniform draws alongside the running sum, so no
+/// probability or prefix sum array is stored.
+/// @param dim The number of basis states
+/// @param probability Returns the probability of basis state i
+/// @param measuredBits Positions of the measured bits in the basis index
+/// @param shots The number of samples to draw
+/// @param gen The random number engine
+template <typename ProbabilityFunc, typename RandomEngine>
+SampleCounts sampleBasisStates(const std::size_t dim,
+                               const ProbabilityFunc &probability,
+                               const std::vector<std::size_t> &measuredBits,
+                               const std::size_t shots, RandomEngine &gen) {
+  const std::size_t nChunks = (dim + SampleChunkSize - 1) / SampleChunkSize;
+  const std::size_t nBits = measuredBits.size();
+  std::uint64_t parityMask = 0;
+  for (auto bit : measuredBits)
+    parityMask |= 1ULL << bit;
+
+  // Pass 1: per chunk probability sums, and <Z...Z> over the measured bits.
+  std::vector<double> chunkEnds(nChunks);
+  double expectation = 0.0;
+#pragma omp parallel for reduction(+ : expectation) if (nChunks > 1)
+  for (std::size_t c = 0; c < nChunks; c++) {
+    const std::size_t end = std::min(dim, (c + 1) * SampleChunkSize);
+    double total = 0.0, parityTotal = 0.0;
+    for (std::size_t i = c * SampleChunkSize; i < end; i++) {
+      const double p = probability(i);
+      total += p;
+      parityTotal += std::popcount(i & parityMask) % 2 ? -p : p;
+    }
+    chunkEnds[c] = total;
+    expectation += parityTotal;
+  }
+  std::partial_sum(chunkEnds.begin(), chunkEnds.end(), chunkEnds.begin());
+
+  SampleCounts result;
+  result.expectationValue = expectation;
+  if (shots == 0 || nChunks == 0)
+    return result;
+
+  // Sorted uniform draws in [0, norm), from normalized exponential spacings.
+  const double norm = chunkEnds.back();
+  std::vector<double> draws(shots);
+  std::exponential_distribution<double> spacing(1.0);
+  double sum = 0.0;
+  for (auto &draw : draws) {
+    sum += spacing(gen);
+    draw = sum;
+  }
+  const double scale = norm / (sum + spacing(gen));
+  for (auto &draw : draws)
+    draw *= scale;
+
+  // Assign the draws to chunks, both are sorted.
+  std::vector<std::size_t> chunkDrawsEnd(nChunks);
+  std::size_t drawIdx = 0;
+  for (std::size_t c = 0; c < nChunks; c++) {
+    while (drawIdx < shots && draws[drawIdx] < chunkEnds[c])
+      drawIdx++;
+    chunkDrawsEnd[c] = drawIdx;
+  }
+  // Rounding may leave draws past the last chunk end.
+  chunkDrawsEnd[nChunks - 1] = shots;
+
+  auto toKey = [&](std::size_t i) {
+    std::uint64_t key = 0;
+    for (std::size_t j = 0; j < nBits; j++)
+      key |= ((i >> measuredBits[j]) & 1ULL) << (nBits - j - 1);
+    return key;
+  };
+
+  // Pass 2: walk the chunks that received draws alongside the running sum.
+  std::vector<std::unordered_map<std::uint64_t, std::size_t>> chunkCounts(
+      nChunks);
+#pragma omp parallel for schedule(dynamic) if (nChunks > 1)
+  for (std::size_t c = 0; c < nChunks; c++) {
+    std::size_t d = c == 0 ? 0 : chunkDrawsEnd[c - 1];
+    const std::size_t dEnd = chunkDrawsEnd[c];
+    if (d == dEnd)
+      continue;
+
+    auto &localCounts = chunkCounts[c];
+    const std::size_t begin = c * SampleChunkSize;
+    const std::size_t end = std::min(dim, begin + SampleChunkSize);
+    double running = c == 0 ? 0.0 : chunkEnds[c - 1];
+    std::size_t lastNonZero = begin;
+    for (std::size_t i = begin; i < end && d < dEnd; i++) {
+      const double p = probability(i);
+      if (p <= 0.0)
+        continue;
+      lastNonZero = i;
+      running += p;
+      const std::size_t first = d;
+      while (d < dEnd && draws[d] < running)
+        d++;
+      if (d != first)
+        localCounts[toKey(i)] += d - first;
+    }
+    // Draws lost to rounding at the chunk end go to the last outcome.
+    if (d < dEnd)
+      localCounts[toKey(lastNonZero)] += dEnd - d;
+  }
+
+  for (auto &localCounts : chunkCounts)
+    for (auto &[key, count] : localCounts)
+      result.counts[key] += count;
+  return result;
+}
+
+/// @brief Convert a key produced by sampleBasisStates to its packed bit
+/// string (see cudaq::packBitString), the first measured bit is the most
+/// significant bit of the key.
+inline std::uint64_t keyToPackedBits(const std::uint64_t key,
+                                     const std::size_t nBits) {
+  std::uint64_t bits = 0;
+  for (std::size_t j = 0; j < nBits; j++)
+    bits |= ((key >> (nBits - j - 1)) & 1ULL) << j;
+  return bits;
+}
+
+} // namespace kernels
+} // namespace nvqir
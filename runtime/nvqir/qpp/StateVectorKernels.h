@@ -0,0 +1,537 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NVQIR_KERNELS_HAS_X86_SIMD 1
+#endif
+
+/// This file provides in-place, stride-based state vector kernels for
+/// applying (possibly controlled) dense unitaries to a CPU-resident state
+/// vector. All kernels operate on physical bit positions of the amplitude
+/// index, i.e. the caller is responsible for mapping qubit indices onto bits
+/// (which depends on the endianness of the owning simulator).
+///
+/// For a k-target matrix, targetBits[0] is the most significant bit of the
+/// matrix row / column index, matching the qpp::applyCTRL convention.
+
+namespace nvqir {
+namespace kernels {
+
+/// @brief The instruction set the kernels will use.
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+/// @brief Number of loop iterations below which the kernels run serially.
+/// Starting an OpenMP team costs more than sweeping a small state.
+inline constexpr std::size_t ParallelThreshold = 1ULL << 13;
+
+/// @brief Return the best instruction set supported by the host CPU.
+inline SimdLevel detectSimdLevel() {
+#ifdef NVQIR_KERNELS_HAS_X86_SIMD
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return SimdLevel::AVX2;
+    return SimdLevel::Scalar;
+  }();
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+/// @brief Insert a 0 bit into `i` at each of the given bit positions. The
+/// positions must be sorted in ascending order.
+inline std::size_t insertZeroBits(std::size_t i, const std::size_t *sortedBits,
+                                  const std::size_t nBits) {
+  for (std::size_t k = 0; k < nBits; k++) {
+    const auto lowMask = (1ULL << sortedBits[k]) - 1;
+    i = ((i & ~lowMask) << 1) | (i & lowMask);
+  }
+  return i;
+}
+
+/// @brief Multiply two complex numbers without the NaN / Inf recovery that
+/// std::complex::operator* performs (which prevents vectorization).
+template <typename ScalarType>
+inline std::complex<ScalarType> fastMul(const std::complex<ScalarType> &a,
+                                        const std::complex<ScalarType> &b) {
+  return {a.real() * b.real() - a.imag() * b.imag(),
+          a.real() * b.imag() + a.imag() * b.real()};
+}
+
+/// @brief Apply a 2x2 matrix on `target`, for all amplitude indices that have
+/// every bit in `ctrlMask` set. `nIter` is the number of amplitude pairs to
+/// visit, i.e. dim >> sortedBits.size().
+template <typename ScalarType>
+void applyOneQubitScalar(std::complex<ScalarType> *state,
+                         const std::size_t nIter, const std::size_t target,
+                         const std::size_t ctrlMask,
+                         const std::size_t *sortedBits, const std::size_t nBits,
+                         const std::complex<ScalarType> *m) {
+  const auto m00 = m[0], m01 = m[1], m10 = m[2], m11 = m[3];
+  const std::size_t targetMask = 1ULL << target;
+#pragma omp parallel for if (nIter >= ParallelThreshold)
+  for (std::size_t i = 0; i < nIter; i++) {
+    const auto i0 = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+    const auto i1 = i0 | targetMask;
+    const auto a0 = state[i0];
+    const auto a1 = state[i1];
+    state[i0] = fastMul(m00, a0) + fastMul(m01, a1);
+    state[i1] = fastMul(m10, a0) + fastMul(m11, a1);
+  }
+}
+
+/// @brief Apply a 4x4 matrix on (target0, target1), target0 being the most
+/// significant bit of the matrix index.
+template <typename ScalarType>
+void applyTwoQubitScalar(std::complex<ScalarType> *state,
+                         const std::size_t nIter, const std::size_t target0,
+                         const std::size_t target1, const std::size_t ctrlMask,
+                         const std::size_t *sortedBits, const std::size_t nBits,
+                         const std::complex<ScalarType> *m) {
+  const std::size_t mask0 = 1ULL << target0, mask1 = 1ULL << target1;
+#pragma omp parallel for if (nIter >= ParallelThreshold)
+  for (std::size_t i = 0; i < nIter; i++) {
+    const auto base = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+    const std::size_t idx[4] = {base, base | mask1, base | mask0,
+                                base | mask0 | mask1};
+    const std::complex<ScalarType> a[4] = {state[idx[0]], state[idx[1]],
+                                           state[idx[2]], state[idx[3]]};
+    for (std::size_t r = 0; r < 4; r++) {
+      const auto *row = m + 4 * r;
+      state[idx[r]] = fastMul(row[0], a[0]) + fastMul(row[1], a[1]) +
+                      fastMul(row[2], a[2]) + fastMul(row[3], a[3]);
+    }
+  }
+}
+
+/// @brief Apply a general 2^k x 2^k matrix on the given target bits.
+template <typename ScalarType>
+void applyMultiQubitScalar(std::complex<ScalarType> *state,
+                           const std::size_t nIter,
+                           const std::vector<std::size_t> &targetBits,
+                           const std::size_t ctrlMask,
+                           const std::size_t *sortedBits,
+                           const std::size_t nBits,
+                           const std::complex<ScalarType> *m) {
+  const auto nTargets = targetBits.size();
+  const std::size_t blockDim = 1ULL << nTargets;
+
+  // Precompute the offset of each matrix index within a block.
+  std::vector<std::size_t> offsets(blockDim, 0);
+  for (std::size_t r = 0; r < blockDim; r++)
+    for (std::size_t j = 0; j < nTargets; j++)
+      if ((r >> (nTargets - 1 - j)) & 1)
+        offsets[r] |= 1ULL << targetBits[j];
+
+#pragma omp parallel if (nIter >= ParallelThreshold)
+  {
+    std::vector<std::complex<ScalarType>> local(blockDim);
+#pragma omp for
+    for (std::size_t i = 0; i < nIter; i++) {
+      const auto base = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+      for (std::size_t r = 0; r < blockDim; r++)
+        local[r] = state[base | offsets[r]];
+      for (std::size_t r = 0; r < blockDim; r++) {
+        std::complex<ScalarType> sum = 0.;
+        const auto *row = m + blockDim * r;
+        for (std::size_t c = 0; c < blockDim; c++)
+          sum += fastMul(row[c], local[c]);
+        state[base | offsets[r]] = sum;
+      }
+    }
+  }
+}
+
+#ifdef NVQIR_KERNELS_HAS_X86_SIMD
+/// @brief (a * m) for two packed complex<double> a, with m broadcast as its
+/// real (mr) and imaginary (mi) parts. aSwap is a with re / im swapped.
+__attribute__((target("avx2,fma"))) inline __m256d
+cmulAvx2(__m256d a, __m256d aSwap, __m256d mr, __m256d mi) {
+  return _mm256_fmaddsub_pd(a, mr, _mm256_mul_pd(aSwap, mi));
+}
+
+/// @brief AVX2 version of applyOneQubitScalar, processes 2 amplitude pairs
+/// per iteration. Requires that bit 0 is not a target or control bit.
+__attribute__((target("avx2,fma"))) inline void
+applyOneQubitAVX2(std::complex<double> *state, const std::size_t nIter,
+                  const std::size_t target, const std::size_t ctrlMask,
+                  const std::size_t *sortedBits, const std::size_t nBits,
+                  const std::complex<double> *m) {
+  double *data = reinterpret_cast<double *>(state);
+  const std::size_t targetMask = 1ULL << target;
+  __m256d mr[4], mi[4];
+  for (std::size_t k = 0; k < 4; k++) {
+    mr[k] = _mm256_set1_pd(m[k].real());
+    mi[k] = _mm256_set1_pd(m[k].imag());
+  }
+#pragma omp parallel for if (nIter >= ParallelThreshold)
+  for (std::size_t i = 0; i < nIter; i += 2) {
+    const auto i0 = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+    const auto i1 = i0 | targetMask;
+    const __m256d a0 = _mm256_loadu_pd(data + 2 * i0);
+    const __m256d a1 = _mm256_loadu_pd(data + 2 * i1);
+    const __m256d a0s = _mm256_permute_pd(a0, 0x5);
+    const __m256d a1s = _mm256_permute_pd(a1, 0x5);
+    _mm256_storeu_pd(data + 2 * i0,
+                     _mm256_add_pd(cmulAvx2(a0, a0s, mr[0], mi[0]),
+                                   cmulAvx2(a1, a1s, mr[1], mi[1])));
+    _mm256_storeu_pd(data + 2 * i1,
+                     _mm256_add_pd(cmulAvx2(a0, a0s, mr[2], mi[2]),
+                                   cmulAvx2(a1, a1s, mr[3], mi[3])));
+  }
+}
+
+/// @brief AVX2 version of applyTwoQubitScalar, processes 2 amplitude blocks
+/// per iteration. Requires that bit 0 is not a target or control bit.
+__attribute__((target("avx2,fma"))) inline void
+applyTwoQubitAVX2(std::complex<double> *state, const std::size_t nIter,
+                  const std::size_t target0, const std::size_t target1,
+                  const std::size_t ctrlMask, const std::size_t *sortedBits,
+                  const std::size_t nBits, const std::complex<double> *m) {
+  double *data = reinterpret_cast<double *>(state);
+  const std::size_t mask0 = 1ULL << target0, mask1 = 1ULL << target1;
+  __m256d mr[16], mi[16];
+  for (std::size_t k = 0; k < 16; k++) {
+    mr[k] = _mm256_set1_pd(m[k].real());
+    mi[k] = _mm256_set1_pd(m[k].imag());
+  }
+#pragma omp parallel for if (nIter >= ParallelThreshold)
+  for (std::size_t i = 0; i < nIter; i += 2) {
+    const auto base = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+    const std::size_t idx[4] = {base, base | mask1, base | mask0,
+                                base | mask0 | mask1};
+    __m256d a[4], as[4];
+    for (std::size_t c = 0; c < 4; c++) {
+      a[c] = _mm256_loadu_pd(data + 2 * idx[c]);
+      as[c] = _mm256_permute_pd(a[c], 0x5);
+    }
+    for (std::size_t r = 0; r < 4; r++) {
+      __m256d sum = cmulAvx2(a[0], as[0], mr[4 * r], mi[4 * r]);
+      for (std::size_t c = 1; c < 4; c++)
+        sum = _mm256_add_pd(
+            sum, cmulAvx2(a[c], as[c], mr[4 * r + c], mi[4 * r + c]));
+      _mm256_storeu_pd(data + 2 * idx[r], sum);
+    }
+  }
+}
+
+/// @brief AVX-512 flavor of cmulAvx2, 4 packed complex<double>.
+__attribute__((target("avx512f"))) inline __m512d
+cmulAvx512(__m512d a, __m512d aSwap, __m512d mr, __m512d mi) {
+  return _mm512_fmaddsub_pd(a, mr, _mm512_mul_pd(aSwap, mi));
+}
+
+/// @brief AVX-512 version of applyOneQubitScalar, processes 4 amplitude pairs
+/// per iteration. Requires that bits 0 and 1 are not target or control bits.
+__attribute__((target("avx512f"))) inline void
+applyOneQubitAVX512(std::complex<double> *state, const std::size_t nIter,
+                    const std::size_t target, const std::size_t ctrlMask,
+                    const std::size_t *sortedBits, const std::size_t nBits,
+                    const std::complex<double> *m) {
+  double *data = reinterpret_cast<double *>(state);
+  const std::size_t targetMask = 1ULL << target;
+  __m512d mr[4], mi[4];
+  for (std::size_t k = 0; k < 4; k++) {
+    mr[k] = _mm512_set1_pd(m[k].real());
+    mi[k] = _mm512_set1_pd(m[k].imag());
+  }
+#pragma omp parallel for if (nIter >= ParallelThreshold)
+  for (std::size_t i = 0; i < nIter; i += 4) {
+    const auto i0 = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+    const auto i1 = i0 | targetMask;
+    const __m512d a0 = _mm512_loadu_pd(data + 2 * i0);
+    const __m512d a1 = _mm512_loadu_pd(data + 2 * i1);
+    const __m512d a0s = _mm512_permute_pd(a0, 0x55);
+    const __m512d a1s = _mm512_permute_pd(a1, 0x55);
+    _mm512_storeu_pd(data + 2 * i0,
+                     _mm512_add_pd(cmulAvx512(a0, a0s, mr[0], mi[0]),
+                                   cmulAvx512(a1, a1s, mr[1], mi[1])));
+    _mm512_storeu_pd(data + 2 * i1,
+                     _mm512_add_pd(cmulAvx512(a0, a0s, mr[2], mi[2]),
+                                   cmulAvx512(a1, a1s, mr[3], mi[3])));
+  }
+}
+
+/// @brief AVX-512 version of applyTwoQubitScalar, processes 4 amplitude
+/// blocks per iteration. Requires that bits 0 and 1 are not target or control
+/// bits.
+__attribute__((target("avx512f"))) inline void
+applyTwoQubitAVX512(std::complex<double> *state, const std::size_t nIter,
+                    const std::size_t target0, const std::size_t target1,
+                    const std::size_t ctrlMask, const std::size_t *sortedBits,
+                    const std::size_t nBits, const std::complex<double> *m) {
+  double *data = reinterpret_cast<double *>(state);
+  const std::size_t mask0 = 1ULL << target0, mask1 = 1ULL << target1;
+  __m512d mr[16], mi[16];
+  for (std::size_t k = 0; k < 16; k++) {
+    mr[k] = _mm512_set1_pd(m[k].real());
+    mi[k] = _mm512_set1_pd(m[k].imag());
+  }
+#pragma omp parallel for if (nIter >= ParallelThreshold)
+  for (std::size_t i = 0; i < nIter; i += 4) {
+    const auto base = insertZeroBits(i, sortedBits, nBits) | ctrlMask;
+    const std::size_t idx[4] = {base, base | mask1, base | mask0,
+                                base | mask0 | mask1};
+    __m512d a[4], as[4];
+    for (std::size_t c = 0; c < 4; c++) {
+      a[c] = _mm512_loadu_pd(data + 2 * idx[c]);
+      as[c] = _mm512_permute_pd(a[c], 0x55);
+    }
+    for (std::size_t r = 0; r < 4; r++) {
+      __m512d sum = cmulAvx512(a[0], as[0], mr[4 * r], mi[4 * r]);
+      for (std::size_t c = 1; c < 4; c++)
+        sum = _mm512_add_pd(
+            sum, cmulAvx512(a[c], as[c], mr[4 * r + c], mi[4 * r + c]));
+      _mm512_storeu_pd(data + 2 * idx[r], sum);
+    }
+  }
+}
+#endif
+
+/// @brief Apply the (row-major) `matrix` in place to the state vector of
+/// `nQubits` qubits, acting on the given target bits and conditioned on all
+/// control bits being set. Target and control bits must be distinct.
+template <typename ScalarType>
+void applyMatrix(std::complex<ScalarType> *state, const std::size_t nQubits,
+                 const std::complex<ScalarType> *matrix,
+                 const std::vector<std::size_t> &controlBits,
+                 const std::vector<std::size_t> &targetBits,
+                 SimdLevel simd = detectSimdLevel()) {
+  if (targetBits.empty())
+    throw std::runtime_error("applyMatrix requires at least one target.");
+
+  std::vector<std::size_t> sortedBits(targetBits);
+  sortedBits.insert(sortedBits.end(), controlBits.begin(), controlBits.end());
+  std::sort(sortedBits.begin(), sortedBits.end());
+  assert(std::adjacent_find(sortedBits.begin(), sortedBits.end()) ==
+             sortedBits.end() &&
+         "Target and control bits must be unique.");
+  assert(sortedBits.back() < nQubits && "Bit position out of range.");
+
+  std::size_t ctrlMask = 0;
+  for (auto c : controlBits)
+    ctrlMask |= 1ULL << c;
+
+  const auto nBits = sortedBits.size();
+  const std::size_t nIter = (1ULL << nQubits) >> nBits;
+  const auto *bits = sortedBits.data();
+
+  // The vectorized kernels process 2 (AVX2) or 4 (AVX-512) adjacent amplitude
+  // groups at once, which requires the lowest bits to be free.
+  [[maybe_unused]] const auto lowestBit = sortedBits.front();
+  if (targetBits.size() == 1) {
+#ifdef NVQIR_KERNELS_HAS_X86_SIMD
+    if constexpr (std::is_same_v<ScalarType, double>) {
+      if (simd == SimdLevel::AVX512 && lowestBit >= 2)
+        return applyOneQubitAVX512(state, nIter, targetBits[0], ctrlMask, bits,
+                                   nBits, matrix);
+      if (simd != SimdLevel::Scalar && lowestBit >= 1)
+        return applyOneQubitAVX2(state, nIter, targetBits[0], ctrlMask, bits,
+                                 nBits, matrix);
+    }
+#endif
+    return applyOneQubitScalar(state, nIter, targetBits[0], ctrlMask, bits,
+                               nBits, matrix);
+  }
+
+  if (targetBits.size() == 2) {
+#ifdef NVQIR_KERNELS_HAS_X86_SIMD
+    if constexpr (std::is_same_v<ScalarType, double>) {
+      if (simd == SimdLevel::AVX512 && lowestBit >= 2)
+        return applyTwoQubitAVX512(state, nIter, targetBits[0], targetBits[1],
+                                   ctrlMask, bits, nBits, matrix);
+      if (simd != SimdLevel::Scalar && lowestBit >= 1)
+        return applyTwoQubitAVX2(state, nIter, targetBits[0], targetBits[1],
+                                 ctrlMask, bits, nBits, matrix);
+    }
+#endif
+    return applyTwoQubitScalar(state, nIter, targetBits[0], targetBits[1],
+                               ctrlMask, bits, nBits, matrix);
+  }
+
+  applyMultiQubitScalar(state, nIter, targetBits, ctrlMask, bits, nBits,
+                        matrix);
+}
+
+/// @brief Compute the real part of <psi | M | psi> for the (row-major)
+/// matrix `matrix` acting on the given target bits, without modifying the
+/// state. For M = K^dag K this is the probability of the Kraus operator K.
+template <typename ScalarType>
+double localExpectation(const std::complex<ScalarType> *state,
+                        const std::size_t nQubits,
+                        const std::complex<ScalarType> *matrix,
+                        const std::vector<std::size_t> &targetBits) {
+  const auto nTargets = targetBits.size();
+  const std::size_t blockDim = 1ULL << nTargets;
+  std::vector<std::size_t> sortedBits(targetBits);
+  std::sort(sortedBits.begin(), sortedBits.end());
+
+  std::vector<std::size_t> offsets(blockDim, 0);
+  for (std::size_t r = 0; r < blockDim; r++)
+    for (std::size_t j = 0; j < nTargets; j++)
+      if ((r >> (nTargets - 1 - j)) & 1)
+        offsets[r] |= 1ULL << targetBits[j];
+
+  const std::size_t nIter = (1ULL << nQubits) >> nTargets;
+  double result = 0.0;
+#pragma omp parallel reduction(+ : result) if (nIter >= ParallelThreshold)
+  {
+    std::vector<std::complex<ScalarType>> local(blockDim);
+#pragma omp for
+    for (std::size_t i = 0; i < nIter; i++) {
+      const auto base = insertZeroBits(i, sortedBits.data(), nTargets);
+      for (std::size_t c = 0; c < blockDim; c++)
+        local[c] = state[base | offsets[c]];
+      for (std::size_t r = 0; r < blockDim; r++) {
+        std::complex<ScalarType> sum = 0.;
+        const auto *row = matrix + blockDim * r;
+        for (std::size_t c = 0; c < blockDim; c++)
+          sum += fastMul(row[c], local[c]);
+        result += (std::conj(local[r]) * sum).real();
+      }
+    }
+  }
+  return result;
+}
+
+/// @brief Number of amplitudes processed per block in pauliExpectations.
+inline constexpr std::size_t PauliBlockSize = 1ULL << 12;
+
+/// @brief Compute <psi | P_t | psi> for a batch of Pauli strings P_t without
+/// modifying the state. Each P_t is given by its X and Z masks over the state
+/// index bits (binary symplectic form, Y sets both): P |j> = i^nY
+/// (-1)^|j & z| |j ^ x>. The state is traversed once, in blocks that are
+/// reused for all terms while they are in cache.
+template <typename ScalarType>
+std::vector<double>
+pauliExpectations(const std::complex<ScalarType> *state, const std::size_t dim,
+                  const std::vector<std::uint64_t> &xMasks,
+                  const std::vector<std::uint64_t> &zMasks) {
+  const std::size_t nTerms = xMasks.size();
+  std::vector<double> result(nTerms, 0.0);
+  const std::size_t nBlocks = (dim + PauliBlockSize - 1) / PauliBlockSize;
+
+  // i^nY, where nY = |x & z|, selects which part of conj(psi_j^x) psi_j to
+  // keep.
+  std::vector<int> phases(nTerms);
+  for (std::size_t t = 0; t < nTerms; t++)
+    phases[t] = std::popcount(xMasks[t] & zMasks[t]) % 4;
+
+#pragma omp parallel if (nBlocks > 1)
+  {
+    std::vector<double> partial(nTerms, 0.0);
+#pragma omp for schedule(static)
+    for (std::size_t b = 0; b < nBlocks; b++) {
+      const std::size_t begin = b * PauliBlockSize;
+      const std::size_t end = std::min(dim, begin + PauliBlockSize);
+      for (std::size_t t = 0; t < nTerms; t++) {
+        const auto x = xMasks[t], z = zMasks[t];
+        double sum = 0.0;
+        if (x == 0) {
+          for (std::size_t j = begin; j < end; j++) {
+            const double p = std::norm(state[j]);
+            sum += std::popcount(j & z) % 2 ? -p : p;
+          }
+        } else {
+          for (std::size_t j = begin; j < end; j++) {
+            const auto c = std::conj(state[j ^ x]) * state[j];
+            double re;
+            switch (phases[t]) {
+            case 0:
+              re = c.real();
+              break;
+            case 1:
+              re = -c.imag();
+              break;
+            case 2:
+              re = -c.real();
+              break;
+            default:
+              re = c.imag();
+            }
+            sum += std::popcount(j & z) % 2 ? -re : re;
+          }
+        }
+        partial[t] += sum;
+      }
+    }
+#pragma omp critical
+    for (std::size_t t = 0; t < nTerms; t++)
+      result[t] += partial[t];
+  }
+
+  return result;
+}
+
+/// @brief Compute out = (identityCoefficient + sum_t c_t P_t) |psi>, with the
+/// Pauli strings P_t given by their X and Z masks as in pauliExpectations.
+/// Each output amplitude gathers its contribution from every term, so the
+/// output is written exactly once and without synchronization.
+template <typename ScalarType>
+void applyPauliSum(const std::complex<ScalarType> *state, const std::size_t dim,
+                   const std::vector<std::uint64_t> &xMasks,
+                   const std::vector<std::uint64_t> &zMasks,
+                   const std::vector<double> &coefficients,
+                   const double identityCoefficient,
+                   std::complex<ScalarType> *out) {
+  const std::size_t nTerms = xMasks.size();
+  // c_t i^nY, so that (P_t psi)_k = phase_t (-1)^|(k ^ x) & z| psi_(k ^ x).
+  std::vector<std::complex<ScalarType>> phases(nTerms);
+  for (std::size_t t = 0; t < nTerms; t++) {
+    static const std::complex<ScalarType> powersOfI[] = {
+        {1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    phases[t] = static_cast<ScalarType>(coefficients[t]) *
+                powersOfI[std::popcount(xMasks[t] & zMasks[t]) % 4];
+  }
+
+#pragma omp parallel for schedule(static) if (dim >= ParallelThreshold)
+  for (std::size_t k = 0; k < dim; k++) {
+    std::complex<ScalarType> sum =
+        static_cast<ScalarType>(identityCoefficient) * state[k];
+    for (std::size_t t = 0; t < nTerms; t++) {
+      const auto j = k ^ xMasks[t];
+      const auto term = fastMul(phases[t], state[j]);
+      sum += std::popcount(j & zMasks[t]) % 2 ? -term : term;
+    }
+    out[k] = sum;
+  }
+}
+
+/// @brief Return <a | b> for two state vectors of dimension `dim`.
+template <typename ScalarType>
+std::complex<double> innerProduct(const std::complex<ScalarType> *a,
+                                  const std::complex<ScalarType> *b,
+                                  const std::size_t dim) {
+  double re = 0.0, im = 0.0;
+#pragma omp parallel for reduction(+ : re, im) if (dim >= ParallelThreshold)
+  for (std::size_t i = 0; i < dim; i++) {
+    const auto c = fastMul(std::conj(a[i]), b[i]);
+    re += c.real();
+    im += c.imag();
+  }
+  return {re, im};
+}
+
+} // namespace kernels
+} // namespace nvqir
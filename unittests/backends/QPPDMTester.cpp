@@ -0,0 +1,129 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include <complex>
+#include <gtest/gtest.h>
+
+#include "CUDAQTestUtils.h"
+#include "QppDMCircuitSimulator.cpp"
+
+namespace {
+/// @brief Return the density matrix of the simulator.
+qpp::cmat getDensityMatrix(QppNoiseCircuitSimulator &simulator) {
+  auto state = simulator.getStateData();
+  auto dim = state.getShape()[0];
+  return Eigen::Map<qpp::cmat>(state.data(), dim, dim);
+}
+
+/// @brief Apply the channel to rho with qpp::apply, the reference the in
+/// place superoperators are checked against.
+qpp::cmat applyChannel(const qpp::cmat &rho, cudaq::kraus_channel &channel,
+                       const std::vector<qpp::idx> &qubits) {
+  std::vector<qpp::cmat> krausOps;
+  for (auto &op : channel.get_ops())
+    krausOps.push_back(Eigen::Map<qpp::cmat>(op.data.data(), op.nRows,
+                                              op.nCols));
+  return qpp::apply(rho, krausOps, qubits);
+}
+} // namespace
+
+CUDAQ_TEST(QPPDMTester, checkNoiseMatchesQppApply) {
+  cudaq::depolarization_channel depolarization(.1);
+  cudaq::amplitude_damping_channel damping(.2);
+  // A two qubit channel, K0 = sqrt(.7) I and K1 = sqrt(.3) X (x) Y, on the
+  // control and target of the controlled x.
+  auto xy = qpp::kron(qpp::Gates::get_instance().X,
+                      qpp::Gates::get_instance().Y);
+  std::vector<std::complex<double>> k0(16, 0.), k1(16);
+  for (std::size_t i = 0; i < 4; i++)
+    k0[i * 4 + i] = std::sqrt(.7);
+  for (std::size_t c = 0; c < 4; c++)
+    for (std::size_t r = 0; r < 4; r++)
+      k1[c * 4 + r] = std::sqrt(.3) * xy(r, c);
+  cudaq::kraus_channel twoQubit(
+      std::vector<cudaq::kraus_op>{cudaq::kraus_op(k0), cudaq::kraus_op(k1)});
+
+  cudaq::noise_model noise;
+  noise.add_channel("h", {0}, depolarization);
+  noise.add_channel("x", {1}, damping);
+  noise.add_channel("x", {0, 2}, twoQubit);
+
+  QppNoiseCircuitSimulator simulator;
+  cudaq::ExecutionContext ctx("extract-state");
+  ctx.noiseModel = &noise;
+  simulator.setExecutionContext(&ctx);
+  auto qubits = simulator.allocateQubits(3);
+  simulator.h(qubits[0]);
+  simulator.x(qubits[1]);
+  simulator.x({qubits[0]}, qubits[2]);
+  simulator.ry(.3, qubits[2]);
+  auto got = getDensityMatrix(simulator);
+
+  auto &gates = qpp::Gates::get_instance();
+  qpp::cmat want = qpp::cmat::Zero(8, 8);
+  want(0, 0) = 1.;
+  want = applyChannel(qpp::apply(want, gates.H, {0}), depolarization, {0});
+  want = applyChannel(qpp::apply(want, gates.X, {1}), damping, {1});
+  want = applyChannel(qpp::applyCTRL(want, gates.X, {0}, {2}), twoQubit,
+                      {0, 2});
+  want = qpp::apply(want, gates.RY(.3), {2});
+  EXPECT_NEAR((got - want).norm(), 0., 1e-12);
+
+  for (auto qubit : qubits)
+    simulator.deallocate(qubit);
+  simulator.resetExecutionContext();
+}
+
+CUDAQ_TEST(QPPDMTester, checkNoiseCacheInvalidation) {
+  QppNoiseCircuitSimulator simulator;
+  cudaq::noise_model noise;
+  auto run = [&]() {
+    cudaq::ExecutionContext ctx("extract-state");
+    ctx.noiseModel = &noise;
+    simulator.setExecutionContext(&ctx);
+    auto qubit = simulator.allocateQubit();
+    simulator.x(qubit);
+    auto rho = getDensityMatrix(simulator);
+    simulator.deallocate(qubit);
+    simulator.resetExecutionContext();
+    return rho(1, 1).real();
+  };
+
+  // The first run caches the x gate on qubit 0 as noiseless.
+  EXPECT_NEAR(run(), 1., 1e-12);
+  // A channel added between two runs invalidates the cache.
+  noise.add_channel("x", {0}, cudaq::bit_flip_channel(1.));
+  EXPECT_NEAR(run(), 0., 1e-12);
+}
+
+CUDAQ_TEST(QPPDMTester, checkFusionKeepsNoise) {
+  cudaq::noise_model noise;
+  QppNoiseCircuitSimulator fused, unfused;
+  fused.setFusionMaxQubits(2);
+  auto run = [&](QppNoiseCircuitSimulator &simulator) {
+    cudaq::ExecutionContext ctx("extract-state");
+    ctx.noiseModel = &noise;
+    simulator.setExecutionContext(&ctx);
+    auto qubits = simulator.allocateQubits(2);
+    simulator.h(qubits[0]);
+    simulator.x({qubits[0]}, qubits[1]);
+    simulator.ry(.3, qubits[1]);
+    auto rho = getDensityMatrix(simulator);
+    for (auto qubit : qubits)
+      simulator.deallocate(qubit);
+    simulator.resetExecutionContext();
+    return rho;
+  };
+
+  EXPECT_NEAR((run(fused) - run(unfused)).norm(), 0., 1e-12);
+  // The gates with noise channels are not fused, also once the noise model
+  // changes after a run.
+  noise.add_channel("h", {0}, cudaq::depolarization_channel(.1));
+  noise.add_channel("ry", {1}, cudaq::amplitude_damping_channel(.2));
+  EXPECT_NEAR((run(fused) - run(unfused)).norm(), 0., 1e-12);
+}
@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <math.h>
+#include <random>
 
 #include "CUDAQTestUtils.h"
 #include "QppCircuitSimulator.cpp"
@@ -1241,3 +1242,258 @@ CUDAQ_TEST(QPPTester, checkReset) {
     EXPECT_EQ(1, qppBackend.mz(q1));
   }
 }
+
+// Check the in-place state vector kernels against qpp::applyCTRL for random
+// states and matrices, across all available instruction sets.
+CUDAQ_TEST(QPPTester, checkInPlaceKernels) {
+  std::mt19937 gen(13);
+  std::normal_distribution<double> dist;
+  std::vector<kernels::SimdLevel> levels{kernels::SimdLevel::Scalar};
+  if (kernels::detectSimdLevel() != kernels::SimdLevel::Scalar)
+    levels.push_back(kernels::SimdLevel::AVX2);
+  if (kernels::detectSimdLevel() == kernels::SimdLevel::AVX512)
+    levels.push_back(kernels::SimdLevel::AVX512);
+
+  for (std::size_t nQubits : {3, 6, 10})
+    for (std::size_t nTargets : {1, 2, 3})
+      for (std::size_t nControls : {0, 1, 2})
+        for (auto level : levels) {
+          if (nTargets + nControls > nQubits)
+            continue;
+          qpp::ket state(1ULL << nQubits);
+          for (auto &el : state)
+            el = {dist(gen), dist(gen)};
+          state.normalize();
+
+          std::vector<qpp::idx> qubits(nQubits);
+          std::iota(qubits.begin(), qubits.end(), 0);
+          std::shuffle(qubits.begin(), qubits.end(), gen);
+          std::vector<qpp::idx> targets(qubits.begin(),
+                                        qubits.begin() + nTargets);
+          std::vector<qpp::idx> controls(qubits.begin() + nTargets,
+                                         qubits.begin() + nTargets +
+                                             nControls);
+
+          auto dim = 1ULL << nTargets;
+          std::vector<std::complex<double>> matrix(dim * dim);
+          for (auto &el : matrix)
+            el = {dist(gen), dist(gen)};
+          qpp::cmat qppMatrix =
+              Eigen::Map<Eigen::Matrix<std::complex<double>, Eigen::Dynamic,
+                                       Eigen::Dynamic, Eigen::RowMajor>>(
+                  matrix.data(), dim, dim);
+          qpp::ket want_state =
+              qpp::applyCTRL(state, qppMatrix, controls, targets);
+
+          // The kernels take (big endian) bit positions.
+          std::vector<std::size_t> targetBits, controlBits;
+          for (auto t : targets)
+            targetBits.push_back(nQubits - t - 1);
+          for (auto c : controls)
+            controlBits.push_back(nQubits - c - 1);
+          kernels::applyMatrix(state.data(), nQubits, matrix.data(),
+                               controlBits, targetBits, level);
+          EXPECT_NEAR((state - want_state).norm(), 0.0, 1e-9);
+        }
+}
+
+// Checks that fusing queued gates into dense unitaries leaves the final state
+// unchanged, for several fusion widths.
+CUDAQ_TEST(QPPTester, checkGateFusion) {
+  const std::size_t nQubits = 5;
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::uniform_int_distribution<std::size_t> qubit(0, nQubits - 1);
+
+  // A non-symmetric two-qubit custom operation, to check matrix ordering.
+  std::vector<std::complex<double>> cnotMatrix{1., 0., 0., 0., 0., 1., 0., 0.,
+                                               0., 0., 0., 1., 0., 0., 1., 0.};
+
+  auto runCircuit = [&](std::size_t maxFusedQubits) {
+    gen.seed(7);
+    QppCircuitSimulator<qpp::ket> qppBackend;
+    qppBackend.setFusionMaxQubits(maxFusedQubits);
+    qppBackend.allocateQubits(nQubits);
+    for (std::size_t i = 0; i < 200; i++) {
+      auto q0 = qubit(gen), q1 = qubit(gen);
+      while (q1 == q0)
+        q1 = qubit(gen);
+      switch (i % 6) {
+      case 0:
+        qppBackend.rx(angle(gen), q0);
+        break;
+      case 1:
+        qppBackend.ry(angle(gen), q0);
+        break;
+      case 2:
+        qppBackend.h(q0);
+        break;
+      case 3:
+        qppBackend.x({q0}, q1);
+        break;
+      case 4:
+        qppBackend.swap(q0, q1);
+        break;
+      case 5:
+        qppBackend.applyCustomOperation(cnotMatrix, {}, {q0, q1});
+        break;
+      }
+    }
+    return qppBackend.getStateVector();
+  };
+
+  auto want_state = runCircuit(0);
+  for (std::size_t maxFusedQubits : {1, 2, 3, 4})
+    EXPECT_EQ_KETS(want_state, runCircuit(maxFusedQubits));
+}
+
+// Checks gates that do not fit the inline GateApplicationTask storage.
+CUDAQ_TEST(QPPTester, checkLargeCustomOperation) {
+  const int num_qubits = 8;
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  qppBackend.allocateQubits(num_qubits);
+
+  // X on the first five qubits, so the next gate has five active controls.
+  for (std::size_t q = 0; q < 5; q++)
+    qppBackend.x(q);
+
+  // X x X x X as a three-target custom operation (64 matrix elements).
+  std::vector<std::complex<double>> matrix(64, 0.);
+  for (std::size_t i = 0; i < 8; i++)
+    matrix[i * 8 + (7 - i)] = 1.;
+  qppBackend.applyCustomOperation(matrix, {0, 1, 2, 3, 4}, {5, 6, 7});
+
+  auto got_state = qppBackend.getStateVector();
+  EXPECT_EQ_KETS(getOneState(num_qubits), got_state);
+}
+
+// Checks that growing an existing state appends |0> qubits, whether the
+// qubits are allocated one at a time or as a register.
+CUDAQ_TEST(QPPTester, checkStateGrowth) {
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  qppBackend.allocateQubits(2);
+  qppBackend.h(0);
+  qppBackend.ry(0.7, 1);
+  qppBackend.x({0}, 1);
+  auto initial_state = qppBackend.getStateVector();
+
+  qppBackend.allocateQubit();
+  qppBackend.allocateQubits(2);
+  auto got_state = qppBackend.getStateVector();
+  auto want_state = qpp::kron(initial_state, getZeroState(3));
+  EXPECT_EQ_KETS(want_state, got_state);
+
+  // After deallocating everything, a new allocation starts from |0...0>.
+  for (std::size_t q = 0; q < 5; q++)
+    qppBackend.deallocate(q);
+  qppBackend.allocateQubits(3);
+  EXPECT_EQ_KETS(getZeroState(3), qppBackend.getStateVector());
+}
+
+// Checks the sampled distribution of a product state large enough to be
+// split in several sampling chunks, on a subset of the qubits.
+CUDAQ_TEST(QPPTester, checkSampling) {
+  const std::size_t num_qubits = 16;
+  const std::size_t shots = 200000;
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  qppBackend.allocateQubits(num_qubits);
+
+  // P(1) on qubit q is sin^2(theta_q / 2)
+  std::vector<double> theta(num_qubits);
+  for (std::size_t q = 0; q < num_qubits; q++) {
+    theta[q] = 0.2 * (q + 1);
+    qppBackend.ry(theta[q], q);
+  }
+  qppBackend.flushGateQueue();
+
+  std::vector<std::size_t> measured{0, 3, 15};
+  auto result = qppBackend.sample(measured, shots);
+
+  std::size_t total = 0;
+  double expectation = 1.0;
+  for (auto q : measured)
+    expectation *= std::cos(theta[q]);
+  EXPECT_NEAR(result.expectationValue.value(), expectation, 1e-9);
+
+  for (auto &[bits, count] : result.counts) {
+    ASSERT_EQ(bits.size(), measured.size());
+    double want = 1.0;
+    for (std::size_t j = 0; j < measured.size(); j++) {
+      double p1 = std::pow(std::sin(theta[measured[j]] / 2.), 2);
+      want *= bits[j] == '1' ? p1 : 1. - p1;
+    }
+    EXPECT_NEAR(static_cast<double>(count) / shots, want, 0.01);
+    total += count;
+  }
+  EXPECT_EQ(total, shots);
+}
+
+// Checks the direct observe against applying each Pauli term to the state.
+CUDAQ_TEST(QPPTester, checkObserve) {
+  const std::size_t num_qubits = 5;
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  qppBackend.allocateQubits(num_qubits);
+  for (std::size_t q = 0; q < num_qubits; q++) {
+    qppBackend.ry(0.3 * (q + 1), q);
+    qppBackend.rz(0.5 * (q + 1), q);
+  }
+  for (std::size_t q = 0; q + 1 < num_qubits; q++)
+    qppBackend.x({q}, q + 1);
+  auto state = qppBackend.getStateVector();
+
+  auto op = cudaq::spin_op::random(num_qubits, 20);
+  op = op + 1.5;
+  auto result = qppBackend.observe(op);
+  double want = 0.0;
+  op.for_each_term([&](cudaq::spin_op &term) {
+    qpp::ket applied = state;
+    term.for_each_pauli([&](cudaq::pauli p, std::size_t q) {
+      if (p == cudaq::pauli::X)
+        applied = qpp::apply(applied, qpp::Gates::get_instance().X, {q});
+      else if (p == cudaq::pauli::Y)
+        applied = qpp::apply(applied, qpp::Gates::get_instance().Y, {q});
+      else if (p == cudaq::pauli::Z)
+        applied = qpp::apply(applied, qpp::Gates::get_instance().Z, {q});
+    });
+    want += (term.get_coefficients()[0] * state.dot(applied)).real();
+    // Each term is registered with its own expectation value.
+    if (!term.is_identity())
+      EXPECT_NEAR(result.exp_val_z(term), state.dot(applied).real(), 1e-9);
+  });
+
+  EXPECT_NEAR(result.exp_val_z(), want, 1e-9);
+
+  // Only exact observe is handled directly.
+  cudaq::ExecutionContext exactCtx("observe");
+  exactCtx.shots = static_cast<std::size_t>(-1);
+  qppBackend.setExecutionContext(&exactCtx);
+  EXPECT_TRUE(exactCtx.canHandleObserve);
+  qppBackend.resetExecutionContext();
+  cudaq::ExecutionContext shotsCtx("observe", 100);
+  qppBackend.setExecutionContext(&shotsCtx);
+  EXPECT_FALSE(shotsCtx.canHandleObserve);
+  qppBackend.resetExecutionContext();
+}
+
+// Checks that the gate-parameters context records the gate angles without
+// allocating the state, so it works for more qubits than fit in memory.
+CUDAQ_TEST(QPPTester, checkGateParametersWithoutState) {
+  const std::size_t num_qubits = 48;
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  cudaq::ExecutionContext ctx("gate-parameters");
+  qppBackend.setExecutionContext(&ctx);
+  auto qubits = qppBackend.allocateQubits(num_qubits);
+  qppBackend.rx(0.3, qubits[0]);
+  qppBackend.h(qubits[1]);
+  qppBackend.ry(-0.7, qubits[num_qubits - 1]);
+  for (auto q : qubits)
+    qppBackend.deallocate(q);
+  qppBackend.resetExecutionContext();
+  EXPECT_EQ(ctx.gateParameters, (std::vector<double>{0.3, -0.7}));
+
+  // The next kernel simulates as usual.
+  auto q0 = qppBackend.allocateQubit();
+  qppBackend.x(q0);
+  EXPECT_NEAR(qppBackend.getStateVector()(1).real(), 1.0, 1e-12);
+  qppBackend.deallocate(q0);
+}
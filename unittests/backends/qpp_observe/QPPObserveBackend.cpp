@@ -19,7 +19,7 @@ class QppObserveTester : public nvqir::QppCircuitSimulator<qpp::ket> {
 public:
   NVQIR_SIMULATOR_CLONE_IMPL(QppObserveTester)
   bool canHandleObserve() override { return true; }
-  cudaq::ExecutionResult observe(const cudaq::spin_op &op) override {
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
     flushGateQueue();
 
     ::qpp::cmat X = ::qpp::Gates::get_instance().X;
@@ -54,7 +54,7 @@ public:
       }
     }
 
-    return cudaq::ExecutionResult({}, sum);
+    return cudaq::observe_result(sum, op, cudaq::sample_result());
   }
 
   std::string name() const override { return "qpp-test"; }
@@ -10,6 +10,7 @@
 #include "cudaq/algorithm.h"
 #include <fmt/core.h>
 
+#include <chrono>
 #include <fstream>
 #include <gtest/gtest.h>
 
@@ -36,6 +37,29 @@ CUDAQ_TEST(QuantinuumTester, checkSampleSync) {
   EXPECT_EQ(counts.size(), 2);
 }
 
+CUDAQ_TEST(QuantinuumTester, checkSamplePostThenPollOnOneThread) {
+  std::string home = std::getenv("HOME");
+  std::string fileName = home + "/FakeCppQuantinuum.config";
+  auto backendString =
+      fmt::format(fmt::runtime(backendStringTemplate), mockPort, fileName);
+
+  auto &platform = cudaq::get_platform();
+  platform.setTargetBackend(backendString);
+
+  auto kernel = cudaq::make_kernel();
+  auto qubit = kernel.qalloc(2);
+  kernel.h(qubit[0]);
+  kernel.mz(qubit[0]);
+
+  // A single job is posted and then polled on this thread, and the mock
+  // server rejects polls that carry a body. The second run posts after a
+  // poll.
+  for (std::size_t i = 0; i < 2; i++) {
+    auto counts = cudaq::sample(kernel);
+    EXPECT_EQ(counts.size(), 2);
+  }
+}
+
 CUDAQ_TEST(QuantinuumTester, checkSampleAsync) {
   std::string home = std::getenv("HOME");
   std::string fileName = home + "/FakeCppQuantinuum.config";
@@ -183,6 +207,36 @@ CUDAQ_TEST(QuantinuumTester, checkObserveAsyncLoadFromFile) {
   EXPECT_NEAR(result.exp_val_z(), -1.7, 1e-1);
 }
 
+CUDAQ_TEST(QuantinuumTester, checkObserveConcurrentJobs) {
+  std::string home = std::getenv("HOME");
+  std::string fileName = home + "/FakeCppQuantinuum.config";
+  auto backendString =
+      fmt::format(fmt::runtime(backendStringTemplate), mockPort, fileName);
+
+  auto &platform = cudaq::get_platform();
+  platform.setTargetBackend(backendString);
+
+  auto [kernel, theta] = cudaq::make_kernel<double>();
+  auto qubit = kernel.qalloc(2);
+  kernel.x(qubit[0]);
+  kernel.ry(theta, qubit[1]);
+  kernel.x<cudaq::ctrl>(qubit[1], qubit[0]);
+
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  // The mock server takes 0.5 s per job and this posts one job for each of
+  // the 3 measurement groups, which are posted and polled concurrently.
+  auto start = std::chrono::steady_clock::now();
+  auto result = cudaq::observe(kernel, h, .59);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  printf("ENERGY: %lf in %lf s\n", result.exp_val_z(), elapsed.count());
+  EXPECT_NEAR(result.exp_val_z(), -1.7, 1e-1);
+  EXPECT_LT(elapsed.count(), 1.5);
+}
+
 int main(int argc, char **argv) {
   std::string home = std::getenv("HOME");
   std::string fileName = home + "/FakeCppQuantinuum.config";
@@ -0,0 +1,92 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cudaq/builder.h>
+#include <functional>
+#include <string>
+
+/// JIT compile time against run time of builder kernels for each LLVM
+/// optimization level, to tune the level picked for long parameter sweeps.
+///
+/// Usage: builder_jit_opt_level [nCalls = 2000] [nLayers = 200]
+
+namespace {
+
+using Kernel = cudaq::kernel_builder<std::vector<double>>;
+
+/// @brief A parameterized ansatz with a runtime loop over the parameters, the
+/// classical code (loop, indexing, argument marshalling) is not unrolled.
+void addLoopBody(Kernel &kernel, cudaq::QuakeValue &theta, std::size_t) {
+  auto size = theta.size();
+  auto q = kernel.qalloc(size);
+  kernel.for_loop(0, size, [&](auto &i) { kernel.ry(theta[i], q[i]); });
+  kernel.for_loop(0, size - 1, [&](auto &i) {
+    kernel.x<cudaq::ctrl>(q[i], q[i + 1]);
+  });
+}
+
+/// @brief A hardware-efficient ansatz on 4 qubits with nLayers layers, fully
+/// unrolled at construction (a large straight-line kernel).
+void addUnrolledBody(Kernel &kernel, cudaq::QuakeValue &theta,
+                     std::size_t nLayers) {
+  auto q = kernel.qalloc(4);
+  for (std::size_t l = 0; l < nLayers; l++) {
+    for (std::size_t i = 0; i < 4; i++)
+      kernel.ry(theta[i] * static_cast<double>(l + 1), q[i]);
+    for (std::size_t i = 0; i < 3; i++)
+      kernel.x<cudaq::ctrl>(q[i], q[i + 1]);
+  }
+}
+
+double timeIt(const std::function<void()> &func) {
+  auto start = std::chrono::high_resolution_clock::now();
+  func();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nCalls = argc > 1 ? std::stoul(argv[1]) : 2000;
+  std::size_t nLayers = argc > 2 ? std::stoul(argv[2]) : 200;
+
+  // Compile every kernel, do not load it from the on-disk JIT cache.
+  setenv("CUDAQ_JIT_CACHE_MAX_MB", "0", 1);
+
+  using Body = std::function<void(Kernel &, cudaq::QuakeValue &, std::size_t)>;
+  std::vector<std::pair<std::string, Body>> kernels{
+      {"loop", addLoopBody}, {"unrolled", addUnrolledBody}};
+  std::vector<double> x{0.1, 0.2, 0.3, 0.4};
+
+  std::printf("%zu calls per kernel, %zu layers in the unrolled kernel\n",
+              nCalls, nLayers);
+  std::printf("%-10s %-6s %12s %14s %12s\n", "kernel", "level", "compile (s)",
+              "per call (us)", "total (s)");
+  for (auto &[name, addBody] : kernels) {
+    for (int level : {0, 1, 2, 3, -1}) {
+      cudaq::set_jit_opt_level(level);
+      auto builder = cudaq::make_kernel<std::vector<double>>();
+      auto &kernel = builder.get<0>();
+      auto &theta = builder.get<1>();
+      addBody(kernel, theta, nLayers);
+      double compileTime = timeIt([&]() { kernel.jitCode(); });
+      double runTime = timeIt([&]() {
+        for (std::size_t i = 0; i < nCalls; i++)
+          kernel(x);
+      });
+      std::printf("%-10s %-6s %12.4f %14.2f %12.4f\n", name.c_str(),
+                  level < 0 ? "auto" : ("O" + std::to_string(level)).c_str(),
+                  compileTime, 1e6 * runTime / nCalls, compileTime + runTime);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cudaq.h>
+#include <string>
+#include <thread>
+
+/// Per-gate overhead of the library-mode execution managers, the QIR runtime
+/// path against the direct simulator dispatch. The register is small, so the
+/// time is dominated by the instruction handling rather than the simulation.
+///
+/// Usage: execution_manager_gate_overhead [nGates = 200000] [nQubits = 2]
+
+namespace {
+
+struct kernel {
+  void operator()(std::size_t nQubits, std::size_t nLayers) __qpu__ {
+    cudaq::qreg q(nQubits);
+    for (std::size_t l = 0; l < nLayers; l++) {
+      h(q[0]);
+      rx(0.1, q[0]);
+      x<cudaq::ctrl>(q[0], q[nQubits - 1]);
+      rz<cudaq::ctrl>(0.2, q[0], q[nQubits - 1]);
+    }
+    mz(q);
+  }
+};
+
+constexpr std::size_t gatesPerLayer = 4;
+
+/// @brief Return the wall time in seconds of the kernel run on a new thread,
+/// so that it gets its own execution manager (and simulator).
+double timeWith(const char *manager, std::size_t nQubits,
+                std::size_t nLayers) {
+  double seconds = 0.0;
+  std::thread([&]() {
+    cudaq::setExecutionManager(manager);
+    // Warm up, e.g. create the simulator.
+    kernel{}(nQubits, 1);
+    auto start = std::chrono::high_resolution_clock::now();
+    kernel{}(nQubits, nLayers);
+    auto end = std::chrono::high_resolution_clock::now();
+    seconds = std::chrono::duration<double>(end - start).count();
+  }).join();
+  return seconds;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nGates = argc > 1 ? std::stoul(argv[1]) : 200000;
+  std::size_t nQubits = argc > 2 ? std::stoul(argv[2]) : 2;
+  std::size_t nLayers = std::max<std::size_t>(nGates / gatesPerLayer, 1);
+  nGates = nLayers * gatesPerLayer;
+
+  std::printf("%zu gates on %zu qubits\n", nGates, nQubits);
+  std::printf("%-10s %12s %14s\n", "manager", "total (s)", "per gate (ns)");
+  for (const char *manager : {"qir", "simulator"}) {
+    double seconds = timeWith(manager, nQubits, nLayers);
+    std::printf("%-10s %12.4f %14.1f\n", manager, seconds,
+                1e9 * seconds / nGates);
+  }
+
+  return 0;
+}
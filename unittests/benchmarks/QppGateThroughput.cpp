@@ -0,0 +1,121 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "StateVectorKernels.h"
+#include "qpp.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+/// Gate throughput benchmark comparing the qpp::applyCTRL path (copy of the
+/// state per gate) with the in-place state vector kernels.
+///
+/// Usage: qpp_gate_throughput [nQubits = 22] [nLayers = 4]
+
+namespace {
+
+using Matrix = std::vector<std::complex<double>>;
+
+struct Gate {
+  Matrix matrix;
+  std::vector<qpp::idx> controls;
+  std::vector<qpp::idx> targets;
+};
+
+/// @brief Build a hardware-efficient-ansatz-like circuit: per layer, a ry on
+/// every qubit, a cx ladder, and a swap on every other pair.
+std::vector<Gate> buildCircuit(std::size_t nQubits, std::size_t nLayers) {
+  const double c = std::cos(0.3), s = std::sin(0.3);
+  Matrix ry{c, -s, s, c};
+  Matrix x{0., 1., 1., 0.};
+  Matrix swap{1., 0., 0., 0., 0., 0., 1., 0., 0., 1., 0., 0., 0., 0., 0., 1.};
+  std::vector<Gate> gates;
+  for (std::size_t l = 0; l < nLayers; l++) {
+    for (std::size_t q = 0; q < nQubits; q++)
+      gates.push_back({ry, {}, {q}});
+    for (std::size_t q = 0; q + 1 < nQubits; q++)
+      gates.push_back({x, {q}, {q + 1}});
+    for (std::size_t q = 0; q + 1 < nQubits; q += 2)
+      gates.push_back({swap, {}, {q, q + 1}});
+  }
+  return gates;
+}
+
+double timeIt(const std::function<void()> &func) {
+  auto start = std::chrono::high_resolution_clock::now();
+  func();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string &name, std::size_t nGates, double seconds,
+            double reference) {
+  std::printf("%-24s %10.3f s %14.1f gates/s %8.2fx\n", name.c_str(), seconds,
+              nGates / seconds, reference / seconds);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nQubits = argc > 1 ? std::stoul(argv[1]) : 22;
+  std::size_t nLayers = argc > 2 ? std::stoul(argv[2]) : 4;
+  auto gates = buildCircuit(nQubits, nLayers);
+  std::printf("%zu qubits, %zu gates\n", nQubits, gates.size());
+
+  auto initialState = [&]() {
+    qpp::ket state = qpp::ket::Zero(1ULL << nQubits);
+    state(0) = 1.0;
+    return state;
+  };
+
+  // Reference: the qpp::applyCTRL path.
+  qpp::ket reference = initialState();
+  double qppTime = timeIt([&]() {
+    for (auto &gate : gates) {
+      auto dim = 1ULL << gate.targets.size();
+      qpp::cmat matrix =
+          Eigen::Map<Eigen::Matrix<std::complex<double>, Eigen::Dynamic,
+                                   Eigen::Dynamic, Eigen::RowMajor>>(
+              gate.matrix.data(), dim, dim);
+      reference =
+          qpp::applyCTRL(reference, matrix, gate.controls, gate.targets);
+    }
+  });
+  report("qpp::applyCTRL", gates.size(), qppTime, qppTime);
+
+  using nvqir::kernels::SimdLevel;
+  std::vector<std::pair<std::string, SimdLevel>> levels{
+      {"in-place (scalar)", SimdLevel::Scalar}};
+  auto best = nvqir::kernels::detectSimdLevel();
+  if (best != SimdLevel::Scalar)
+    levels.emplace_back("in-place (avx2)", SimdLevel::AVX2);
+  if (best == SimdLevel::AVX512)
+    levels.emplace_back("in-place (avx512)", SimdLevel::AVX512);
+
+  for (auto &[name, level] : levels) {
+    qpp::ket state = initialState();
+    double time = timeIt([&]() {
+      std::vector<std::size_t> controlBits, targetBits;
+      for (auto &gate : gates) {
+        controlBits.clear();
+        targetBits.clear();
+        for (auto c : gate.controls)
+          controlBits.push_back(nQubits - c - 1);
+        for (auto t : gate.targets)
+          targetBits.push_back(nQubits - t - 1);
+        nvqir::kernels::applyMatrix(state.data(), nQubits, gate.matrix.data(),
+                                    controlBits, targetBits, level);
+      }
+    });
+    report(name, gates.size(), time, qppTime);
+    if ((state - reference).norm() > 1e-8)
+      std::printf("  WARNING: state differs from the qpp reference.\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "cudaq/builder/KernelJIT.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/TargetSelect.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+/// @brief Cache tests, each on a fresh cache directory. The object code is a
+/// single function, int answer() { return 42; }.
+class JITObjectCacheTester : public ::testing::Test {
+protected:
+  fs::path directory;
+  std::size_t nCompiles = 0;
+  const std::string key =
+      cudaq::JITObjectCache::computeKey({"int answer() { return 42; }"});
+
+  void SetUp() override {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    directory = fs::temp_directory_path() /
+                ("cudaq-jit-cache-test-" + std::to_string(getpid()));
+    fs::remove_all(directory);
+  }
+
+  void TearDown() override { fs::remove_all(directory); }
+
+  std::string compile(const std::string &name = "answer") {
+    nCompiles++;
+    llvm::LLVMContext context;
+    llvm::Module module(name, context);
+    auto *function = llvm::Function::Create(
+        llvm::FunctionType::get(llvm::Type::getInt32Ty(context), false),
+        llvm::Function::ExternalLinkage, name, module);
+    llvm::IRBuilder<> builder(
+        llvm::BasicBlock::Create(context, "entry", function));
+    builder.CreateRet(builder.getInt32(42));
+    return cudaq::compileToObjectCode(module, 0);
+  }
+
+  /// @brief Link the key through the cache and call answer().
+  int link(cudaq::JITObjectCache &cache) {
+    auto engine =
+        cache.link(key, [&]() { return compile(); }, {}, "answer");
+    auto answer = engine->lookup("answer");
+    EXPECT_TRUE(static_cast<bool>(answer));
+    return reinterpret_cast<int (*)()>(*answer)();
+  }
+};
+} // namespace
+
+TEST_F(JITObjectCacheTester, checkMiss) {
+  cudaq::JITObjectCache cache(directory, 1 << 20);
+  EXPECT_FALSE(cache.lookup(key).has_value());
+  EXPECT_EQ(42, link(cache));
+  EXPECT_EQ(1, nCompiles);
+  EXPECT_TRUE(fs::exists(directory / (key + ".o")));
+}
+
+TEST_F(JITObjectCacheTester, checkHit) {
+  {
+    cudaq::JITObjectCache cache(directory, 1 << 20);
+    EXPECT_EQ(42, link(cache));
+    // In process hit.
+    EXPECT_EQ(42, link(cache));
+    EXPECT_EQ(1, nCompiles);
+  }
+
+  // On disk hit, e.g. from a later process.
+  cudaq::JITObjectCache cache(directory, 1 << 20);
+  EXPECT_EQ(42, link(cache));
+  EXPECT_EQ(1, nCompiles);
+}
+
+TEST_F(JITObjectCacheTester, checkCorruptEntry) {
+  fs::create_directories(directory);
+  auto path = directory / (key + ".o");
+  std::ofstream(path, std::ios::binary) << "not an object file";
+
+  cudaq::JITObjectCache cache(directory, 1 << 20);
+  EXPECT_TRUE(cache.lookup(key).has_value());
+  // The corrupt entry is evicted and replaced by the compiled object.
+  EXPECT_EQ(42, link(cache));
+  EXPECT_EQ(1, nCompiles);
+
+  cudaq::JITObjectCache reopened(directory, 1 << 20);
+  EXPECT_EQ(42, link(reopened));
+  EXPECT_EQ(1, nCompiles);
+}
+
+TEST_F(JITObjectCacheTester, checkRename) {
+  cudaq::JITObjectCache cache(directory, 1 << 20);
+  // Two kernels that only differ by their name share the placeholder object.
+  for (std::string name : {"123456789012", "210987654321"}) {
+    auto engine = cache.link(
+        key, [&]() { return compile("answer_cudaqJITname"); }, {},
+        "answer_" + name, "cudaqJITname", name);
+    auto answer = engine->lookup("answer_" + name);
+    ASSERT_TRUE(static_cast<bool>(answer));
+    EXPECT_EQ(42, reinterpret_cast<int (*)()>(*answer)());
+  }
+  EXPECT_EQ(1, nCompiles);
+}
+
+TEST_F(JITObjectCacheTester, checkInProcessCap) {
+  auto size = compile().size();
+  nCompiles = 0;
+  // In process only, with room for a single object.
+  cudaq::JITObjectCache cache("", size + size / 2);
+  auto otherKey = cudaq::JITObjectCache::computeKey({"other"});
+  EXPECT_EQ(42, link(cache));
+  cache.insert(otherKey, compile());
+  EXPECT_TRUE(cache.lookup(otherKey).has_value());
+  EXPECT_FALSE(cache.lookup(key).has_value());
+  EXPECT_EQ(42, link(cache));
+  EXPECT_EQ(3, nCompiles);
+}
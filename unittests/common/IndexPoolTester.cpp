@@ -0,0 +1,50 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "CUDAQTestUtils.h"
+#include "common/IndexPool.h"
+
+using namespace cudaq;
+
+CUDAQ_TEST(IndexPoolTester, checkLowestFirst) {
+  IndexPool pool(4);
+  for (std::size_t i = 0; i < 4; i++)
+    EXPECT_EQ(pool.getNextIndex(), i);
+  EXPECT_EQ(pool.numAvailable(), 0);
+
+  // Returned indices are handed out again, lowest first.
+  pool.returnIndex(2);
+  pool.returnIndex(0);
+  EXPECT_EQ(pool.numAllocated(), 2);
+  EXPECT_EQ(pool.getNextIndex(), 0);
+  EXPECT_EQ(pool.getNextIndex(), 2);
+  EXPECT_EQ(pool.getNextIndex(), 4);
+
+  // Releasing everything, in any order, starts over from 0.
+  for (std::size_t i : {1, 4, 0, 3, 2})
+    pool.returnIndex(i);
+  EXPECT_EQ(pool.numAllocated(), 0);
+  EXPECT_EQ(pool.getNextIndex(), 0);
+}
+
+CUDAQ_TEST(IndexPoolTester, checkGrowth) {
+  IndexPool pool(2);
+  EXPECT_EQ(pool.totalNum(), 2);
+  for (std::size_t i = 0; i < 100; i++)
+    EXPECT_EQ(pool.getNextIndex(), i);
+  EXPECT_GE(pool.totalNum(), 100);
+  EXPECT_EQ(pool.numAllocated(), 100);
+
+  // The capacity never drops below the indices in use.
+  pool.setCapacity(10);
+  EXPECT_EQ(pool.numAvailable(), 0);
+  for (std::size_t i = 100; i-- > 0;)
+    pool.returnIndex(i);
+  EXPECT_EQ(pool.numAllocated(), 0);
+  EXPECT_EQ(pool.numAvailable(), pool.totalNum());
+}
@@ -64,3 +64,60 @@ CUDAQ_TEST(MeasureCountsTester, checkMeasureCountsSerialize) {
 
   EXPECT_TRUE(mm == mc);
 }
+
+CUDAQ_TEST(MeasureCountsTester, checkWideRegister) {
+  // Bit strings wider than a machine word, one 1 at position 70 or 130.
+  std::string a(150, '0'), b(150, '0');
+  a[70] = '1';
+  b[70] = '1';
+  b[130] = '1';
+
+  ExecutionResult r;
+  r.appendResult(a, 300);
+  r.appendResult(b, 100);
+  r.appendResult(a, 100);
+  EXPECT_EQ(2, r.counts.size());
+  EXPECT_EQ(3, r.getSequentialData().size());
+  EXPECT_EQ(b, r.getSequentialData()[1]);
+
+  cudaq::sample_result mc(r);
+  EXPECT_EQ(400, mc.count(a));
+  EXPECT_EQ(100, mc.count(b));
+  EXPECT_EQ(0, mc.count(std::string(150, '0')));
+  EXPECT_EQ(a, mc.most_probable());
+  EXPECT_NEAR(-0.6, mc.exp_val_z(), 1e-9);
+  EXPECT_EQ(400, mc.to_map()[a]);
+
+  auto marginal = mc.get_marginal({70, 130});
+  EXPECT_EQ(400, marginal.count("10"));
+  EXPECT_EQ(100, marginal.count("11"));
+
+  auto data = mc.serialize();
+  cudaq::sample_result mm;
+  mm.deserialize(data);
+  EXPECT_TRUE(mm == mc);
+}
+
+CUDAQ_TEST(MeasureCountsTester, checkSequentialDataSwitch) {
+  cudaq::set_record_sequential_data(false);
+  ExecutionResult r;
+  cudaq::set_record_sequential_data(true);
+  r.appendResult("01", 3);
+  r.appendResult("10", 1);
+  EXPECT_EQ(2, r.counts.size());
+  EXPECT_TRUE(r.getSequentialData().empty());
+
+  // Merging into a result that does not record keeps its log empty.
+  ExecutionResult other;
+  other.appendResult("01", 1);
+  cudaq::sample_result mc(r), mo(other);
+  mc += mo;
+  EXPECT_EQ(4, mc.count("01"));
+  EXPECT_TRUE(mc.sequential_data().empty());
+
+  // The iteration reads the bit strings and counts in insertion order.
+  std::vector<std::pair<std::string, std::size_t>> entries;
+  for (auto &[bits, count] : mc)
+    entries.emplace_back(bits, count);
+  EXPECT_EQ(entries, (decltype(entries){{"01", 4}, {"10", 1}}));
+}
@@ -0,0 +1,76 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "CUDAQTestUtils.h"
+#include "common/ObserveGrouping.h"
+
+using namespace cudaq;
+
+CUDAQ_TEST(ObserveGroupingTester, checkQubitWiseCommutingGroups) {
+  using namespace cudaq::spin;
+  spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+              .21829 * z(0) - 6.125 * z(1) + 0.5 * z(0) * z(1) + 0.3 * x(0);
+
+  auto groups = groupQubitWiseCommuting(h);
+  // {XX, X0}, {YY}, {ZZ, Z0, Z1}
+  EXPECT_EQ(3, groups.size());
+
+  std::size_t nGrouped = 0;
+  for (auto &group : groups) {
+    for (auto t : group.termIndices) {
+      auto term = h[t];
+      EXPECT_FALSE(term.is_identity());
+      // Each term acts with the basis Pauli, or the identity, on every qubit.
+      auto termData = term.get_bsf()[0];
+      auto basisData = group.basis.get_bsf()[0];
+      for (std::size_t i = 0; i < termData.size(); i++)
+        EXPECT_TRUE(!termData[i] || basisData[i]);
+      for (std::size_t i = 0; i < h.n_qubits(); i++)
+        if (termData[i] || termData[i + h.n_qubits()])
+          EXPECT_EQ(termData[i] && termData[i + h.n_qubits()],
+                    basisData[i] && basisData[i + h.n_qubits()]);
+      nGrouped++;
+    }
+  }
+  EXPECT_EQ(h.n_terms() - 1, nGrouped);
+}
+
+CUDAQ_TEST(ObserveGroupingTester, checkMarginalizeGroupCounts) {
+  using namespace cudaq::spin;
+  spin_op h = z(0) * z(2) + z(1) + 2.0 * z(0) * z(1) * z(2);
+  auto groups = groupQubitWiseCommuting(h);
+  ASSERT_EQ(1, groups.size());
+  auto &group = groups.front();
+
+  CountsDictionary counts{{"000", 10}, {"101", 20}, {"011", 30}, {"111", 40}};
+  auto z0z2 = marginalizeGroupCounts(counts, group.basis, z(0) * z(2));
+  EXPECT_EQ(z0z2.registerName, (z(0) * z(2)).to_string(false));
+  EXPECT_EQ(3, z0z2.counts.size());
+  EXPECT_EQ(60, z0z2.counts["11"]);
+  EXPECT_NEAR(0.4, z0z2.expectationValue.value(), 1e-12);
+
+  auto z1 = marginalizeGroupCounts(counts, group.basis, z(1));
+  EXPECT_EQ(30, z1.counts["0"]);
+  EXPECT_EQ(70, z1.counts["1"]);
+  EXPECT_NEAR(-0.4, z1.expectationValue.value(), 1e-12);
+
+  // A single group returned under the global register is expanded per term.
+  ExecutionResult global(counts);
+  sample_result data(global);
+  auto expanded = expandMeasurementGroups(data, h);
+  for (std::size_t t = 0; t < h.n_terms(); t++) {
+    auto name = h[t].to_string(false);
+    std::size_t total = 0;
+    for (auto &[bits, count] : expanded.to_map(name))
+      total += count;
+    EXPECT_EQ(100, total);
+    auto result = marginalizeGroupCounts(counts, group.basis, h[t]);
+    EXPECT_NEAR(result.expectationValue.value(), expanded.exp_val_z(name),
+                1e-12);
+  }
+}
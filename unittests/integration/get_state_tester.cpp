@@ -68,3 +68,38 @@ CUDAQ_TEST(GetStateTester, checkSimple) {
 
   EXPECT_NEAR(opt_val, 0.0, 1e-3);
 }
+
+CUDAQ_TEST(GetStateTester, checkDataOwnership) {
+  // The state takes the data vector over rather than copying it, its copies
+  // share the data.
+  std::vector<std::complex<double>> bellData{M_SQRT1_2, 0., 0., M_SQRT1_2};
+  auto *bellPtr = bellData.data();
+  cudaq::state bell(cudaq::State({4}, std::move(bellData)));
+  EXPECT_EQ(bell.get_data(), bellPtr);
+  EXPECT_EQ(bell.get_shape(), std::vector<std::size_t>{4});
+  auto bellCopy = bell;
+  EXPECT_EQ(bellCopy.get_data(), bellPtr);
+
+  // Or borrows it.
+  std::vector<std::complex<double>> zeroData{1., 0., 0., 0.};
+  cudaq::state zero(cudaq::State({4}, zeroData.data(), nullptr));
+  EXPECT_EQ(zero.get_data(), zeroData.data());
+  EXPECT_NEAR(bell.overlap(zero), M_SQRT1_2, 1e-12);
+
+  // The simulator hands its buffer over, the states outlive the simulation.
+  auto kernel = []() __qpu__ {
+    cudaq::qubit q, r;
+    h(q);
+    cx(q, r);
+  };
+  auto first = cudaq::get_state(kernel);
+  auto second = cudaq::get_state(kernel);
+  EXPECT_NE(first.get_data(), second.get_data());
+  EXPECT_NEAR(first.overlap(second), 1.0, 1e-3);
+#ifdef CUDAQ_BACKEND_DM
+  EXPECT_EQ(first.get_shape(), (std::vector<std::size_t>{4, 4}));
+#else
+  EXPECT_EQ(first.get_shape(), std::vector<std::size_t>{4});
+  EXPECT_NEAR(first.overlap(bell), 1.0, 1e-3);
+#endif
+}
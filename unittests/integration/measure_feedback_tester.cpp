@@ -0,0 +1,50 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "CUDAQTestUtils.h"
+#include <cudaq/utils/registry.h>
+
+CUDAQ_TEST(MeasureFeedbackTester, checkParallelShots) {
+  auto kernel = []() __qpu__ {
+    cudaq::qreg q(3);
+    h(q[0]);
+    if (mz(q[0]))
+      x(q[1]);
+    ry(0.7, q[2]);
+    mz(q[1]);
+    mz(q[2]);
+  };
+
+  // Library mode kernels have no Quake code, flag this one as having
+  // conditional feedback so that the shots run one by one.
+  auto kernelName = cudaq::getKernelName(kernel);
+  cudaq::registry::deviceCodeHolderAdd(kernelName.c_str(),
+                                       "qubitMeasurementFeedback = true");
+  ASSERT_TRUE(cudaq::kernelHasConditionalFeedback(kernelName));
+
+  setenv("CUDAQ_SHOT_THREADS", "4", 1);
+  cudaq::set_random_seed(13);
+  auto counts = cudaq::sample(2000, kernel);
+  unsetenv("CUDAQ_SHOT_THREADS");
+  // The shots run on the calling thread unless CUDAQ_SHOT_THREADS is set,
+  // with the same counts.
+  cudaq::set_random_seed(13);
+  auto again = cudaq::sample(2000, kernel);
+
+  // The measured qubit and its conditionally flipped copy always agree.
+  std::size_t total = 0;
+  for (auto &[bits, count] : counts) {
+    EXPECT_EQ(bits[0], bits[1]);
+#ifndef CUDAQ_BACKEND_CUSTATEVEC
+    // The qpp based simulators are seeded by cudaq::set_random_seed.
+    EXPECT_EQ(again.count(bits), count);
+#endif
+    total += count;
+  }
+  EXPECT_EQ(total, 2000);
+}
@@ -10,7 +10,7 @@
 #include <cudaq/algorithm.h>
 #include <stdio.h>
 
-#ifdef CUDAQ_BACKEND_DM
+#if defined(CUDAQ_BACKEND_DM) || defined(CUDAQ_BACKEND_TRAJECTORY)
 struct xOp {
   void operator()() __qpu__ {
     cudaq::qubit q;
@@ -198,4 +198,16 @@ CUDAQ_TEST(NoiseTest, checkBitFlipType) {
   EXPECT_NEAR(counts.probability("0"), .1, .1);
   EXPECT_NEAR(counts.probability("1"), .9, .1);
 }
+
+CUDAQ_TEST(NoiseTest, checkObserveDepolarization) {
+  cudaq::depolarization_channel depol(.3);
+  cudaq::noise_model noise;
+  noise.add_channel<cudaq::types::x>({0}, depol);
+  cudaq::set_noise(noise);
+
+  // X and Y errors flip the qubit back, so <Z> = -1 + 4p/3.
+  double result = cudaq::observe(xOp{}, cudaq::spin::z(0));
+  EXPECT_NEAR(result, -.6, .1);
+  cudaq::unset_noise();
+}
 #endif
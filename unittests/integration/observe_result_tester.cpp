@@ -62,3 +62,34 @@ CUDAQ_TEST(ObserveResult, checkSimple) {
   EXPECT_TRUE(x0x1Counts.size() == 4);
   platform.clear_shots();
 }
+
+CUDAQ_TEST(ObserveResult, checkBatch) {
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  auto ansatz = [](double theta) __qpu__ {
+    cudaq::qubit q, r;
+    x(q);
+    ry(theta, r);
+    x<cudaq::ctrl>(r, q);
+  };
+
+  std::vector<double> thetas{-0.3, 0.0, 0.59, 1.2};
+  auto energies = cudaq::observe_batch(ansatz, h, thetas);
+  ASSERT_EQ(energies.size(), thetas.size());
+  for (std::size_t i = 0; i < thetas.size(); i++)
+    EXPECT_NEAR(energies[i], cudaq::observe(ansatz, h, thetas[i]).exp_val_z(),
+                1e-6);
+
+  auto kernel = [](double theta) __qpu__ {
+    cudaq::qubit q;
+    ry(theta, q);
+    mz(q);
+  };
+  auto counts = cudaq::sample_batch(
+      kernel, std::vector<std::tuple<double>>{{0.0}, {M_PI}});
+  ASSERT_EQ(counts.size(), 2);
+  EXPECT_EQ(counts[0].count("0"), 1000);
+  EXPECT_EQ(counts[1].count("1"), 1000);
+}
@@ -7,6 +7,7 @@
  *******************************************************************************/
 #include <cudaq.h>
 #include <cudaq/algorithm.h>
+#include <cudaq/gradients.h>
 #include <gtest/gtest.h>
 
 TEST(MQPUTester, checkSimple) {
@@ -26,6 +27,75 @@ TEST(MQPUTester, checkSimple) {
   printf("Get energy directly as double %lf\n", result);
 }
 
+TEST(MQPUTester, checkSampleAsync) {
+  auto kernel = []() __qpu__ {
+    cudaq::qreg q(2);
+    h(q[0]);
+    x<cudaq::ctrl>(q[0], q[1]);
+    mz(q);
+  };
+
+  // Launch one sampling task per QPU, they run concurrently.
+  auto &platform = cudaq::get_platform();
+  std::vector<cudaq::async_sample_result> results;
+  for (std::size_t i = 0; i < platform.num_qpus(); i++)
+    results.emplace_back(cudaq::sample_async(i, kernel));
+
+  for (auto &result : results) {
+    auto counts = result.get();
+    EXPECT_EQ(counts.size(), 2);
+    EXPECT_EQ(counts.count("00") + counts.count("11"), 1000);
+  }
+}
+
+TEST(MQPUTester, checkBatchedGradient) {
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  auto ansatz = [](double theta) __qpu__ {
+    cudaq::qubit q, r;
+    x(q);
+    ry(theta, r);
+    x<cudaq::ctrl>(r, q);
+  };
+  auto argMapper = [](std::vector<double> x) { return std::make_tuple(x[0]); };
+
+  // The shifted evaluations are spread across all the QPUs.
+  cudaq::gradients::parameter_shift gradient(ansatz, argMapper);
+  for (double theta : {0.2, 0.59, 1.5}) {
+    std::vector<double> dx(1);
+    gradient.compute({theta}, dx, h, 0.0);
+    double expected = (cudaq::observe(ansatz, h, theta + 1e-4) -
+                       cudaq::observe(ansatz, h, theta - 1e-4)) /
+                      2e-4;
+    EXPECT_NEAR(dx[0], expected, 1e-3);
+  }
+}
+
+TEST(MQPUTester, checkObserveBatch) {
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  auto ansatz = [](double theta) __qpu__ {
+    cudaq::qubit q, r;
+    x(q);
+    ry(theta, r);
+    x<cudaq::ctrl>(r, q);
+  };
+
+  // The batch is split over all the QPUs, the results keep the input order.
+  std::vector<double> thetas;
+  for (int i = 0; i < 17; i++)
+    thetas.push_back(-1.0 + 0.125 * i);
+  auto energies = cudaq::observe_batch(ansatz, h, thetas);
+  ASSERT_EQ(energies.size(), thetas.size());
+  for (std::size_t i = 0; i < thetas.size(); i++)
+    EXPECT_NEAR(energies[i], cudaq::observe(ansatz, h, thetas[i]).exp_val_z(),
+                1e-6);
+}
+
 TEST(MQPUTester, checkLarge) {
 
   // This will warm up the GPUs, we don't time this
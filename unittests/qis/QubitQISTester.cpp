@@ -8,8 +8,11 @@
 
 #include "CUDAQTestUtils.h"
 #include <numeric>
+#include <optional>
+#include <thread>
 
 #include <cudaq/algorithms/observe.h>
+#include <cudaq/algorithms/state.h>
 #include <cudaq/spin_op.h>
 
 #ifndef CUDAQ_BACKEND_DM
@@ -336,3 +339,34 @@ CUDAQ_TEST(QubitQISTester, checkAdjointRegions) {
 }
 
 #endif
+
+CUDAQ_TEST(QubitQISTester, checkExecutionManagers) {
+  auto kernel = []() __qpu__ {
+    cudaq::qreg q(4);
+    h(q);
+    rx(0.3, q[0]);
+    ry<cudaq::ctrl>(0.7, q[0], q[1]);
+    rz<cudaq::adj>(1.1, q[2]);
+    r1<cudaq::ctrl>(0.4, q[1], q[2], q[3]);
+    t<cudaq::adj>(q[3]);
+    s(q[1]);
+    cphase(0.9, q[0], q[2]);
+    swap(q[1], q[3]);
+    x<cudaq::ctrl>(q[0], q[1], q[2]);
+    y<cudaq::ctrl>(q[3], q[0]);
+  };
+
+  // The execution manager is created per thread, with the QIR runtime or the
+  // direct simulator dispatch, both must give the same state.
+  auto stateWith = [&](std::string_view manager) {
+    std::optional<cudaq::state> state;
+    std::thread([&]() {
+      cudaq::setExecutionManager(manager);
+      state = cudaq::get_state(kernel);
+    }).join();
+    return *state;
+  };
+  auto qirState = stateWith("qir");
+  auto simulatorState = stateWith("simulator");
+  EXPECT_NEAR(qirState.overlap(simulatorState), 1.0, 1e-6);
+}
@@ -177,4 +177,109 @@ TEST(SpinOpTester, checkGetMatrix) {
     }
     EXPECT_NEAR(sum, -1.74, 1e-2);
   }
-}
\ No newline at end of file
+}
+
+TEST(SpinOpTester, checkMultiTermProduct) {
+  // (X0 + Z0 Y1) * (Z0 - 2 X1) expands to every pair of terms.
+  auto lhs = x(0) + z(0) * y(1);
+  auto rhs = z(0) - 2.0 * x(1);
+  auto product = lhs * rhs;
+  EXPECT_EQ(4, product.n_terms());
+
+  // to_matrix() computes the action on bras, which reverses the product.
+  auto lhsMatrix = lhs.to_matrix();
+  auto rhsMatrix = rhs.to_matrix();
+  auto want = rhsMatrix * lhsMatrix;
+  auto got = product.to_matrix();
+  for (std::size_t i = 0; i < want.rows(); i++)
+    for (std::size_t j = 0; j < want.cols(); j++)
+      EXPECT_NEAR(std::abs(want(i, j) - got(i, j)), 0.0, 1e-12);
+
+  // Z * X = iY
+  EXPECT_EQ((z(0) * x(0)).get_term_coefficient(0), std::complex<double>(0, 1));
+}
+
+TEST(SpinOpTester, checkLargeSum) {
+  // Terms on more than 64 qubits, with every term added twice.
+  const std::size_t nTerms = 2000;
+  cudaq::spin_op op = z(70);
+  for (std::size_t t = 0; t < 2 * nTerms; t++)
+    op += 0.5 * x((t % nTerms) % 61) * z((t % nTerms) / 61 + 61);
+  op -= z(70);
+
+  std::size_t n = 0;
+  for (std::size_t t = 0; t < op.n_terms(); t++) {
+    auto term = op.get_term_view(t);
+    EXPECT_NEAR(term.get_coefficient().real(), 1.0, 1e-12);
+    EXPECT_EQ(op[t], op.slice(t, 1));
+    n++;
+  }
+  EXPECT_EQ(nTerms, n);
+  EXPECT_EQ((nTerms - 1) / 61 + 62, op.n_qubits());
+
+  auto bsf = op.get_bsf();
+  auto coeffs = op.get_coefficients();
+  EXPECT_EQ(op, cudaq::spin_op::from_binary_symplectic(bsf, coeffs));
+}
+
+TEST(SpinOpTester, checkSparseMatrixAndApply) {
+  auto H = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) + .21829 * z(0) -
+           6.125 * z(1) + 0.5 * y(2) * z(0) + 0.25 * x(2) * y(1);
+  auto dense = H.to_matrix();
+  const std::size_t dim = dense.rows();
+  // to_matrix() data holds <row|H|col> at row * dim + col.
+  auto element = [&](std::size_t row, std::size_t col) {
+    return dense.data()[row * dim + col];
+  };
+
+  auto [values, columns, rowOffsets] = H.to_sparse_matrix();
+  ASSERT_EQ(dim + 1, rowOffsets.size());
+  std::size_t nnz = 0;
+  for (std::size_t row = 0; row < dim; row++) {
+    for (std::size_t k = rowOffsets[row]; k < rowOffsets[row + 1]; k++) {
+      EXPECT_NEAR(std::abs(values[k] - element(row, columns[k])), 0.0, 1e-12);
+      if (k > rowOffsets[row])
+        EXPECT_LT(columns[k - 1], columns[k]);
+    }
+    for (std::size_t col = 0; col < dim; col++)
+      nnz += std::abs(element(row, col)) > 1e-12;
+  }
+  EXPECT_EQ(nnz, values.size());
+
+  std::vector<std::complex<double>> vec(dim);
+  for (std::size_t i = 0; i < dim; i++)
+    vec[i] = std::complex<double>(0.1 * i, 1.0 - 0.2 * i);
+  auto result = H.apply(vec);
+  for (std::size_t row = 0; row < dim; row++) {
+    std::complex<double> want = 0.0;
+    for (std::size_t col = 0; col < dim; col++)
+      want += element(row, col) * vec[col];
+    EXPECT_NEAR(std::abs(want - result[row]), 0.0, 1e-12);
+  }
+}
+
+TEST(SpinOpTester, checkSparseMatrixLayout) {
+  // <0|Y|1> = -i, to_matrix() holds its transpose.
+  {
+    auto [values, columns, rowOffsets] = y(0).to_sparse_matrix();
+    ASSERT_EQ(2, values.size());
+    EXPECT_EQ(1, columns[rowOffsets[0]]);
+    EXPECT_NEAR(std::abs(values[rowOffsets[0]] - std::complex<double>(0, -1)),
+                0.0, 1e-12);
+    EXPECT_NEAR(std::abs(y(0).to_matrix()(0, 1) - std::complex<double>(0, 1)),
+                0.0, 1e-12);
+  }
+
+  auto H = 0.5 * y(0) * z(1) + 0.25 * x(0) * y(1) - 1.5 * y(0) * y(1) +
+           2.0 * z(1);
+  auto dense = H.to_matrix();
+  auto [values, columns, rowOffsets] = H.to_sparse_matrix();
+  const std::size_t dim = dense.rows();
+  for (std::size_t row = 0; row < dim; row++) {
+    std::vector<std::complex<double>> sparseRow(dim, 0.0);
+    for (std::size_t k = rowOffsets[row]; k < rowOffsets[row + 1]; k++)
+      sparseRow[columns[k]] = values[k];
+    for (std::size_t col = 0; col < dim; col++)
+      EXPECT_NEAR(std::abs(sparseRow[col] - dense(col, row)), 0.0, 1e-12);
+  }
+}
@@ -8,7 +8,7 @@
 
 from fastapi import FastAPI, Request, HTTPException, Header
 from typing import Optional, Union
-import uvicorn, uuid, json, base64
+import uvicorn, uuid, json, base64, asyncio, time
 from pydantic import BaseModel 
 from llvmlite import binding as llvm
 
@@ -24,8 +24,16 @@ class Job(BaseModel):
 # Keep track of Job Ids to their Names
 createdJobs = {}
 
-# Could how many times the client has requested the Job
-countJobGetRequests = 0
+# Keep track of Job Ids to the time they complete
+jobDoneTimes = {}
+
+# Simulated latency (seconds) of posting a job and of running it
+postLatency = 0.05
+jobLatency = 0.5
+
+# Keep track of Job Ids whose first poll already failed, every job fails its
+# first poll once with a transient error to test that clients retry
+failedPolls = set()
 
 # Global holding the number of shots
 shots = 100
@@ -42,14 +50,16 @@ async def login(token: Union[str, None] = Header(alias="Authorization",default=N
 # with EntryPoint tag
 @app.post("/job")
 async def postJob(job : Job, token: Union[str, None] = Header(alias="Authorization",default=None)):
-    global createdJobs, shots
+    global createdJobs, jobDoneTimes, shots
     
     if 'token' == None:
         raise HTTPException(status_code(401), detail="Credentials not provided")
     
+    await asyncio.sleep(postLatency)
     name = job.name
     newId = str(uuid.uuid4())
     createdJobs[newId] = name
+    jobDoneTimes[newId] = time.time() + jobLatency
     shots = job.count
     program = job.program
     decoded = base64.b64decode(program)
@@ -65,21 +75,29 @@ async def postJob(job : Job, token: Union[str, None] = Header(alias="Authorizati
         assert("qis__mz__body" in mstr)
     elif name == "I0Z1":
         assert("qis__mz__body" in mstr)
+    elif name == "Z0Z1":
+        assert("qis__mz__body" in mstr)
 
     # Job "created", return the id
     return {"job":newId}
 
-# Retrieve the job, simulate having to wait by counting to 3 
-# until we return the job results
+# Retrieve the job, simulate having to wait until the job latency has
+# elapsed before we return the job results
 @app.get("/job/{jobId}")  
-async def getJob(jobId : str):
-    global countJobGetRequests, createdJobs, shots
+async def getJob(jobId : str, request : Request):
+    global createdJobs, jobDoneTimes, shots, failedPolls
+
+    # A poll must not carry a body, e.g. that of the job posted before it
+    if await request.body():
+        raise HTTPException(status_code=400, detail="Unexpected body")
+
+    if jobId not in failedPolls:
+        failedPolls.add(jobId)
+        raise HTTPException(status_code=503, detail="Service unavailable")
 
-    if countJobGetRequests < 3:
-        countJobGetRequests += 1
+    if time.time() < jobDoneTimes[jobId]:
         return {"status":"running"}
 
-    countJobGetRequests = 0
     name = createdJobs[jobId]
     retData = []
     if name == "X0X1":
@@ -90,6 +108,8 @@ async def getJob(jobId : str):
         retData = ['1']*9088 + ['0']*912
     elif name == "I0Z1":
         retData = ['1']*880 + ['0']*9120
+    elif name == "Z0Z1":
+        retData = ['10']*9088 + ['01']*880 + ['00']*32
     else:
         retData = ['00']*int(shots/2) + ['11']*int(shots/2)
     res = {"status":"completed", "results":{"mz0":retData}}